@@ -0,0 +1,7 @@
+#!/bin/sh
+# Usage: Linux-GenProjectFiles.sh [--arch=ISA]
+# The default ISA is x86-64-v3 (AVX2); pass --arch=native to tune the build for this machine.
+cd "$(dirname "$0")/../premake" || exit 1
+
+echo "Generating makefiles..."
+premake5 --file="ProjectFIles.lua" --os=linux "$@" gmake2
@@ -1,19 +1,37 @@
+newoption
+{
+	trigger = "arch",
+	value = "ISA",
+	description = "The instruction set that the Linux builds target, as passed to -march. Spearmint requires at least AVX2.",
+	default = "x86-64-v3"
+}
+
+newoption
+{
+	trigger = "profiling",
+	description = "Compile in the profiler: scoped timers, counters and Chrome trace capture."
+}
+
 workspace "Spearmint"
 	location "../../"
 
 	configurations
 	{
-		"Debug", "Relase"
+		"Debug", "Release"
 	}
 
 	platforms
 	{
-		"Win64"
+		"Win64", "Linux64"
 	}
 
 	filter "platforms:Win64"
 		system "Windows"
 		architecture "x86_64"
+	filter "platforms:Linux64"
+		system "Linux"
+		architecture "x86_64"
+		toolset "gcc"
 	filter ""
 
 	startproject "Spearmint"
@@ -39,9 +57,16 @@ workspace "Spearmint"
 			files
 			{
 				"%{prj.location}/Source/**.h",
+				"%{prj.location}/Source/**.inl",
 				"%{prj.location}/Source/**.cpp"
 			}
 
+			-- The benchmark has its own entry point, in its own project.
+			removefiles
+			{
+				"%{prj.location}/Source/Benchmark/**"
+			}
+
 			includedirs
 			{
 				"%{prj.location}/Source"
@@ -49,11 +74,43 @@ workspace "Spearmint"
 
 			filter "platforms:Win64"
 				systemversion "lastest"
+				vectorextensions "AVX2"
 				defines
 				{
 					"SM_PLATFORM_WINDOWS=1"
 				}
 
+			filter "platforms:Linux64"
+				buildoptions
+				{
+					"-march=%{_OPTIONS['arch']}",
+
+					-- Like MSVC's /fp:precise: no contraction into FMAs, so the SIMD paths compute the same results as the scalar ones.
+					"-ffp-contract=off"
+				}
+				links
+				{
+					"pthread"
+				}
+				defines
+				{
+					"SM_PLATFORM_LINUX=1"
+				}
+
+			-- The render kernels are compiled once for every instruction set, and picked at startup (see RenderKernels.h).
+			filter { "platforms:Win64", "files:**/RenderKernelsSSE.cpp" }
+				vectorextensions "SSE2"
+			filter { "platforms:Linux64", "files:**/RenderKernelsSSE.cpp" }
+				buildoptions { "-mno-avx" }
+			filter { "platforms:Linux64", "files:**/RenderKernelsAVX2.cpp" }
+				buildoptions { "-mavx2", "-mfma", "-mno-avx512f" }
+
+			filter "options:profiling"
+				defines
+				{
+					"SM_ENABLE_PROFILING=1"
+				}
+
 			filter "configurations:Debug"
 				optimize "Off"
 				symbols "On"
@@ -71,6 +128,112 @@ workspace "Spearmint"
 					"SM_CONFIGURATION_RELEASE=1"
 				}
 
+			filter { "platforms:Linux64", "configurations:Release" }
+				optimize "Full"
+				flags
+				{
+					"LinkTimeOptimization"
+				}
+
+			filter ""
+
+		project "SpearmintBenchmark"
+			location "%{wks.location}"
+
+			kind "ConsoleApp"
+			language "C++"
+			cppdialect "C++17"
+
+			staticruntime "On"
+			rtti "Off"
+			exceptionhandling "Off"
+			characterset "Unicode"
+
+			targetname "SpearmintBenchmark"
+			targetdir "%{wks.location}/Binaries/%{cfg.platform}/%{cfg.buildcfg}"
+			objdir "%{wks.location}/Intermediate/%{cfg.buildcfg}/%{prj.name}"
+
+			files
+			{
+				"%{prj.location}/Source/**.h",
+				"%{prj.location}/Source/**.inl",
+				"%{prj.location}/Source/**.cpp"
+			}
+
+			-- The benchmark replaces the renderer's entry point with its own.
+			removefiles
+			{
+				"%{prj.location}/Source/Core/Launch.cpp"
+			}
+
+			includedirs
+			{
+				"%{prj.location}/Source"
+			}
+
+			filter "platforms:Win64"
+				systemversion "lastest"
+				vectorextensions "AVX2"
+				defines
+				{
+					"SM_PLATFORM_WINDOWS=1"
+				}
+
+			filter "platforms:Linux64"
+				buildoptions
+				{
+					"-march=%{_OPTIONS['arch']}",
+
+					-- Like MSVC's /fp:precise: no contraction into FMAs, so the SIMD paths compute the same results as the scalar ones.
+					"-ffp-contract=off"
+				}
+				links
+				{
+					"pthread"
+				}
+				defines
+				{
+					"SM_PLATFORM_LINUX=1"
+				}
+
+			-- The render kernels are compiled once for every instruction set, and picked at startup (see RenderKernels.h).
+			filter { "platforms:Win64", "files:**/RenderKernelsSSE.cpp" }
+				vectorextensions "SSE2"
+			filter { "platforms:Linux64", "files:**/RenderKernelsSSE.cpp" }
+				buildoptions { "-mno-avx" }
+			filter { "platforms:Linux64", "files:**/RenderKernelsAVX2.cpp" }
+				buildoptions { "-mavx2", "-mfma", "-mno-avx512f" }
+
+			filter "options:profiling"
+				defines
+				{
+					"SM_ENABLE_PROFILING=1"
+				}
+
+			filter "configurations:Debug"
+				optimize "Off"
+				symbols "On"
+				runtime "Debug"
+				defines
+				{
+					"SM_CONFIGURATION_DEBUG=1"
+				}
+
+			filter "configurations:Release"
+				optimize "On"
+				symbols "On"
+				defines
+				{
+					"SM_CONFIGURATION_RELEASE=1"
+				}
+
+			filter { "platforms:Linux64", "configurations:Release" }
+				optimize "Full"
+				flags
+				{
+					"LinkTimeOptimization"
+				}
+
 			filter ""
 
 
@@ -0,0 +1,362 @@
+/**
+ *--------------------------------------------
+ * BenchmarkMain.cpp <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 24 2022.
+ */
+
+#include "Benchmark/BenchmarkScenes.h"
+#include "Core/Jobs/JobSystem.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Platform/Platform.h"
+#include "Renderer/Renderer.h"
+#include "Renderer/RenderKernels.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/** The version of the JSON report. Increased whenever a field changes meaning or is removed. */
+#define BENCHMARK_REPORT_VERSION 2
+
+struct FBenchmarkOptions
+{
+	/** Only the scenes whose name contains this are run. If nullptr, all the scenes are run. */
+	const char* Filter = nullptr;
+
+	/** The file the report is written to. If nullptr, the report is written to the standard output. */
+	const char* OutputFileName = nullptr;
+
+	uint32      Width = 640;
+	uint32      Height = 360;
+
+	/** The number of timed frames (one sample per pixel each), after one untimed warm-up frame. */
+	uint32      FrameCount = 8;
+
+	/** The number of job system threads. If 0, the hardware concurrency is used. */
+	uint32      ThreadCount = 0;
+
+	/** The instruction set whose kernels are used. EKernelISA::Count selects the best supported one. */
+	EKernelISA  KernelISA = EKernelISA::Count;
+
+	FRenderSettings Settings;
+};
+
+/** The measurements of a scene. */
+struct FBenchmarkResult
+{
+	const FBenchmarkSceneDesc* Desc;
+	uint32         TriangleCount;
+
+	float64        GenerateSeconds;
+
+	/** The time spent building all the acceleration structures of the scene. */
+	float64        BuildSeconds;
+	FBVHBuildStats SphereBVHStats;
+
+	float64        MeanFrameSeconds;
+	float64        MinFrameSeconds;
+	FRenderer::FRenderStats RenderStats;
+
+	/**
+	 * The memory reserved by the arenas of the scene, its acceleration structures, the image buffers and the
+	 *   scratch arenas, plus the image. Leaves out everything else the process holds; @see 'ProcessPeakBytes'.
+	 */
+	uint64         ArenaReservedBytes;
+
+	/**
+	 * The peak physical memory of the process, measured after the scene. The scenes run one after the other
+	 *   in the same process, so this is the peak of this scene and the ones before it; run a single scene
+	 *   (with '--filter') to measure its own.
+	 */
+	uint64         ProcessPeakBytes;
+};
+
+internal void PrintUsage()
+{
+	fprintf(stderr,
+		"Usage: SpearmintBenchmark [options]\n"
+		"  --filter <text>        Only run the scenes whose name contains the text.\n"
+		"  --list                 List the scenes and exit.\n"
+		"  --frames <count>       The number of timed frames per scene (default 8).\n"
+		"  --resolution <W>x<H>   The image resolution (default 640x360).\n"
+		"  --threads <count>      The number of threads (default: all hardware threads).\n"
+		"  --kernels <name>       The kernels to use: sse, avx2 or auto (default: the best supported).\n"
+		"  --output <file>        Write the JSON report to a file, instead of the standard output.\n"
+		"  --no-wavefront         Trace the paths block by block.\n"
+		"  --no-packets           Trace the primary rays one at a time.\n"
+		"  --sort-rays            Sort the bounced rays before tracing them.\n");
+}
+
+/** @return True if the command line was valid. Sets 'bListOnly' if the scenes must only be listed. */
+internal bool ParseCommandLine(char** Args, uint32 ArgCount, out FBenchmarkOptions& Options, out bool& bListOnly)
+{
+	bListOnly = false;
+	for (uint32 ArgIndex = 1; ArgIndex < ArgCount; ++ArgIndex)
+	{
+		const char* Arg = Args[ArgIndex];
+		const char* Value = (ArgIndex + 1 < ArgCount) ? Args[ArgIndex + 1] : nullptr;
+
+		if (strcmp(Arg, "--list") == 0)
+		{
+			bListOnly = true;
+		}
+		else if (strcmp(Arg, "--no-wavefront") == 0)
+		{
+			Options.Settings.bUseWavefront = false;
+		}
+		else if (strcmp(Arg, "--no-packets") == 0)
+		{
+			Options.Settings.bUseRayPackets = false;
+		}
+		else if (strcmp(Arg, "--sort-rays") == 0)
+		{
+			Options.Settings.bSortRays = true;
+		}
+		else if (Value && strcmp(Arg, "--filter") == 0)
+		{
+			Options.Filter = Value;
+			++ArgIndex;
+		}
+		else if (Value && strcmp(Arg, "--output") == 0)
+		{
+			Options.OutputFileName = Value;
+			++ArgIndex;
+		}
+		else if (Value && strcmp(Arg, "--frames") == 0)
+		{
+			Options.FrameCount = (uint32)strtoul(Value, nullptr, 10);
+			++ArgIndex;
+		}
+		else if (Value && strcmp(Arg, "--threads") == 0)
+		{
+			Options.ThreadCount = (uint32)strtoul(Value, nullptr, 10);
+			++ArgIndex;
+		}
+		else if (Value && strcmp(Arg, "--kernels") == 0)
+		{
+			if (!FKernelDispatch::Parse(Value, Options.KernelISA))
+			{
+				return false;
+			}
+			++ArgIndex;
+		}
+		else if (Value && strcmp(Arg, "--resolution") == 0)
+		{
+			char* End;
+			Options.Width = (uint32)strtoul(Value, &End, 10);
+			Options.Height = (*End == 'x') ? (uint32)strtoul(End + 1, nullptr, 10) : 0;
+			++ArgIndex;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	return (Options.FrameCount > 0) && (Options.Width > 0) && (Options.Height > 0);
+}
+
+internal FBenchmarkResult RunScene(const FBenchmarkSceneDesc& Desc, const FBenchmarkOptions& Options, FImage& Image)
+{
+	FBenchmarkResult Result = {};
+	Result.Desc = &Desc;
+
+	FMemoryArena SceneArena;
+	SceneArena.Initialize("Scene");
+
+	float64 StartTime = FPlatform::GetTimeSeconds();
+	FWorld World;
+	FBenchmarkScenes::Generate(Desc, (float)Image.Width / (float)Image.Height, SceneArena, World);
+	Result.GenerateSeconds = FPlatform::GetTimeSeconds() - StartTime;
+
+	for (uint32 MeshIndex = 0; MeshIndex < World.MeshCount; ++MeshIndex)
+	{
+		Result.TriangleCount += World.Meshes[MeshIndex].TriangleCount;
+	}
+
+	// The renderer is scoped to the scene, so its acceleration structures and image buffers are freed with it.
+	{
+		FRenderer Renderer;
+		Renderer.SetSettings(Options.Settings);
+
+		StartTime = FPlatform::GetTimeSeconds();
+		Renderer.SetWorld(&World);
+		Result.BuildSeconds = FPlatform::GetTimeSeconds() - StartTime;
+		Result.SphereBVHStats = Renderer.GetSphereBVHStats();
+
+		Renderer.SetImageTarget(&Image);
+
+		// The warm-up frame brings the scene into the caches and grows the scratch arenas to their peak.
+		Renderer.Render();
+		Renderer.ResetAccumulation();
+
+		Result.MinFrameSeconds = BIG_NUMBER;
+		for (uint32 FrameIndex = 0; FrameIndex < Options.FrameCount; ++FrameIndex)
+		{
+			float64 FrameStartTime = FPlatform::GetTimeSeconds();
+			Renderer.RenderPass();
+			Result.MinFrameSeconds = FMath::Min(Result.MinFrameSeconds, FPlatform::GetTimeSeconds() - FrameStartTime);
+		}
+
+		Result.RenderStats = Renderer.GetStats();
+		Result.MeanFrameSeconds = Result.RenderStats.RenderTimeSeconds / (float64)Options.FrameCount;
+
+		Result.ArenaReservedBytes = SceneArena.GetStats().ReservedSize + Renderer.GetAcceleration().GetArena().GetStats().ReservedSize +
+			Renderer.GetImageArena().GetStats().ReservedSize + FMemory::GetScratchStats().ReservedSize + (uint64)Image.Width * Image.Height * sizeof(uint32);
+		Result.ProcessPeakBytes = FPlatform::GetPeakMemoryUsage();
+	}
+
+	SceneArena.Release();
+	return Result;
+}
+
+internal void WriteReport(FILE* File, const FBenchmarkOptions& Options, const FBenchmarkResult* Results, uint32 ResultCount)
+{
+	fprintf(File, "{\n");
+	fprintf(File, "  \"version\": %u,\n", BENCHMARK_REPORT_VERSION);
+	fprintf(File, "  \"settings\": {\n");
+	fprintf(File, "    \"width\": %u,\n", Options.Width);
+	fprintf(File, "    \"height\": %u,\n", Options.Height);
+	fprintf(File, "    \"frames\": %u,\n", Options.FrameCount);
+	fprintf(File, "    \"threads\": %u,\n", FJobSystem::GetThreadCount());
+	fprintf(File, "    \"kernels\": \"%s\",\n", FKernelDispatch::GetKernels().Name);
+	fprintf(File, "    \"wavefront\": %s,\n", Options.Settings.bUseWavefront ? "true" : "false");
+	fprintf(File, "    \"ray_packets\": %s,\n", Options.Settings.bUseRayPackets ? "true" : "false");
+	fprintf(File, "    \"sort_rays\": %s\n", Options.Settings.bSortRays ? "true" : "false");
+	fprintf(File, "  },\n");
+	fprintf(File, "  \"scenes\": [");
+
+	for (uint32 ResultIndex = 0; ResultIndex < ResultCount; ++ResultIndex)
+	{
+		const FBenchmarkResult& Result = Results[ResultIndex];
+		const FRenderer::FRenderStats& Stats = Result.RenderStats;
+		uint64 RayCount = Stats.PrimaryRayCount + Stats.SecondaryRayCount + Stats.ShadowRayCount;
+		uint64 ExtendedRayCount = Stats.PrimaryRayCount + Stats.SecondaryRayCount;
+
+		fprintf(File, "%s\n    {\n", (ResultIndex > 0) ? "," : "");
+		fprintf(File, "      \"name\": \"%s\",\n", Result.Desc->Name);
+		fprintf(File, "      \"spheres\": %u,\n", Result.Desc->SphereCount);
+		fprintf(File, "      \"planes\": %u,\n", 1 + Result.Desc->PlaneCount);
+		fprintf(File, "      \"triangles\": %u,\n", Result.TriangleCount);
+		fprintf(File, "      \"generate_ms\": %.3f,\n", Result.GenerateSeconds * 1000.0);
+		fprintf(File, "      \"build_ms\": %.3f,\n", Result.BuildSeconds * 1000.0);
+		fprintf(File, "      \"sphere_bvh_nodes\": %u,\n", Result.SphereBVHStats.NodeCount);
+		fprintf(File, "      \"sphere_bvh_sah_cost\": %.3f,\n", Result.SphereBVHStats.SAHCost);
+		fprintf(File, "      \"ms_per_frame\": %.3f,\n", Result.MeanFrameSeconds * 1000.0);
+		fprintf(File, "      \"ms_per_frame_min\": %.3f,\n", Result.MinFrameSeconds * 1000.0);
+		fprintf(File, "      \"primary_rays\": %llu,\n", (unsigned long long)Stats.PrimaryRayCount);
+		fprintf(File, "      \"secondary_rays\": %llu,\n", (unsigned long long)Stats.SecondaryRayCount);
+		fprintf(File, "      \"shadow_rays\": %llu,\n", (unsigned long long)Stats.ShadowRayCount);
+		fprintf(File, "      \"hit_rate\": %.4f,\n", ExtendedRayCount ? (float64)Stats.HitCount / (float64)ExtendedRayCount : 0.0);
+		fprintf(File, "      \"mrays_per_s\": %.3f,\n", (Stats.RenderTimeSeconds > 0.0) ? (float64)RayCount / Stats.RenderTimeSeconds / 1e6 : 0.0);
+		fprintf(File, "      \"arena_reserved_bytes\": %llu,\n", (unsigned long long)Result.ArenaReservedBytes);
+		fprintf(File, "      \"process_peak_bytes\": %llu\n", (unsigned long long)Result.ProcessPeakBytes);
+		fprintf(File, "    }");
+	}
+
+	fprintf(File, "\n  ]\n}\n");
+}
+
+internal int32 GuardedMain(char** Args, uint32 ArgCount)
+{
+	FBenchmarkOptions Options;
+
+	// Every frame samples every pixel, so all the frames of a scene cost the same.
+	Options.Settings.bAdaptiveSampling = false;
+	Options.Settings.MaxSampleCount = UINT32_MAX;
+
+	bool bListOnly;
+	if (!ParseCommandLine(Args, ArgCount, Options, bListOnly))
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	uint32 SceneCount;
+	const FBenchmarkSceneDesc* Scenes = FBenchmarkScenes::GetScenes(SceneCount);
+	if (bListOnly)
+	{
+		for (uint32 SceneIndex = 0; SceneIndex < SceneCount; ++SceneIndex)
+		{
+			printf("%s\n", Scenes[SceneIndex].Name);
+		}
+		return 0;
+	}
+
+	// Falling back to other kernels would report their timings under the wrong name.
+	if (!FKernelDispatch::Initialize(Options.KernelISA))
+	{
+		fprintf(stderr, "The processor doesn't support the '%s' kernels.\n", FKernelDispatch::GetKernels(Options.KernelISA).Name);
+		return 1;
+	}
+	fprintf(stderr, "Kernels: %s (best supported: %s)\n", FKernelDispatch::GetKernels().Name,
+		FKernelDispatch::GetKernels(FKernelDispatch::GetBestSupported()).Name);
+
+	FJobSystem::Initialize(Options.ThreadCount);
+	FMemory::Initialize();
+	FSampler::Initialize();
+
+	FMemoryArena& PersistentArena = FMemory::GetPersistentArena();
+
+	FImage Image = {};
+	Image.Width = Options.Width;
+	Image.Height = Options.Height;
+	Image.Pixels = PersistentArena.PushArray<uint32>((uint64)Image.Width * Image.Height, CACHE_LINE_SIZE);
+
+	FBenchmarkResult* Results = PersistentArena.PushArray<FBenchmarkResult>(SceneCount);
+	uint32 ResultCount = 0;
+
+	// The progress goes to the standard error, so the standard output only holds the report.
+	for (uint32 SceneIndex = 0; SceneIndex < SceneCount; ++SceneIndex)
+	{
+		const FBenchmarkSceneDesc& Desc = Scenes[SceneIndex];
+		if (Options.Filter && !strstr(Desc.Name, Options.Filter))
+		{
+			continue;
+		}
+
+		fprintf(stderr, "%-16s ", Desc.Name);
+		fflush(stderr);
+
+		const FBenchmarkResult& Result = Results[ResultCount++] = RunScene(Desc, Options, Image);
+		uint64 RayCount = Result.RenderStats.PrimaryRayCount + Result.RenderStats.SecondaryRayCount + Result.RenderStats.ShadowRayCount;
+		fprintf(stderr, "build %9.2f ms, %9.2f ms/frame, %7.2f Mrays/s, %8.1f MB peak\n", Result.BuildSeconds * 1000.0, Result.MeanFrameSeconds * 1000.0,
+			(float64)RayCount / Result.RenderStats.RenderTimeSeconds / 1e6, Result.ProcessPeakBytes / (1024.0 * 1024.0));
+	}
+
+	int32 ExitCode = 0;
+	if (ResultCount == 0)
+	{
+		fprintf(stderr, "No scene matches the filter '%s'.\n", Options.Filter);
+		ExitCode = 1;
+	}
+	else if (Options.OutputFileName)
+	{
+		FILE* OutputFile = FPlatform::OpenFile(Options.OutputFileName, "w");
+		if (OutputFile)
+		{
+			WriteReport(OutputFile, Options, Results, ResultCount);
+			fclose(OutputFile);
+		}
+		else
+		{
+			fprintf(stderr, "Failed to write the report to '%s'.\n", Options.OutputFileName);
+			ExitCode = 1;
+		}
+	}
+	else
+	{
+		WriteReport(stdout, Options, Results, ResultCount);
+	}
+
+	FMemory::Shutdown();
+	FJobSystem::Shutdown();
+	return ExitCode;
+}
+
+int main(int ArgCount, char** Args)
+{
+	return (int)(GuardedMain(Args, (uint32)ArgCount));
+}
@@ -0,0 +1,208 @@
+/**
+ *--------------------------------------------
+ * BenchmarkScenes.cpp <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 24 2022.
+ */
+
+#include "BenchmarkScenes.h"
+
+#include "Core/Math/Random.h"
+
+#include <cmath>
+
+/** The spheres are spread in a box of this size (X, Y, Z) above the ground, centered on the origin. */
+#define BENCHMARK_SPHERE_AREA_SIZE   40.0F
+#define BENCHMARK_SPHERE_AREA_HEIGHT 10.0F
+
+/** The radius range of the spheres of a scene with 1000 of them. */
+#define BENCHMARK_SPHERE_MIN_RADIUS  0.1F
+#define BENCHMARK_SPHERE_MAX_RADIUS  0.7F
+
+/** The distance range of the random planes from the origin. The camera is always inside the room they form. */
+#define BENCHMARK_PLANE_MIN_DISTANCE 60.0F
+#define BENCHMARK_PLANE_MAX_DISTANCE 100.0F
+
+/** The size of the height field mesh and the height of its waves. */
+#define BENCHMARK_GRID_SIZE          30.0F
+#define BENCHMARK_GRID_WAVE_HEIGHT   2.0F
+
+internal const FBenchmarkSceneDesc GBenchmarkScenes[] =
+{
+	{ "spheres-1k",     1000,     0,  0    },
+	{ "spheres-10k",    10000,    0,  0    },
+	{ "spheres-100k",   100000,   0,  0    },
+	{ "spheres-1m",     1000000,  0,  0    },
+	{ "spheres-10m",    10000000, 0,  0    },
+	{ "planes-64",      1000,     64, 0    },
+	{ "mesh-grid-256",  0,        0,  256  },
+	{ "mesh-grid-1024", 0,        0,  1024 },
+};
+
+/** The materials of the benchmark scenes: mostly diffuse, with a few of every other built-in type. */
+enum class EBenchmarkMaterial : uint32
+{
+	Ground = 0,
+	Red,
+	Blue,
+	Metal,
+	Glass,
+	Light,
+
+	Count,
+};
+
+internal FMaterial* CreateMaterials(FMemoryArena& Arena)
+{
+	FMaterial* Materials = Arena.PushArrayZero<FMaterial>((uint32)EBenchmarkMaterial::Count);
+
+	Materials[(uint32)EBenchmarkMaterial::Ground].MaterialTypeID = (uint32)EMaterialType::Diffuse;
+	Materials[(uint32)EBenchmarkMaterial::Ground].GetData<FMaterialDiffuse>() = { FVector3(0.8F, 0.8F, 0.8F) };
+	Materials[(uint32)EBenchmarkMaterial::Red].MaterialTypeID = (uint32)EMaterialType::Diffuse;
+	Materials[(uint32)EBenchmarkMaterial::Red].GetData<FMaterialDiffuse>() = { FVector3(0.9F, 0.2F, 0.1F) };
+	Materials[(uint32)EBenchmarkMaterial::Blue].MaterialTypeID = (uint32)EMaterialType::Diffuse;
+	Materials[(uint32)EBenchmarkMaterial::Blue].GetData<FMaterialDiffuse>() = { FVector3(0.1F, 0.4F, 0.9F) };
+	Materials[(uint32)EBenchmarkMaterial::Metal].MaterialTypeID = (uint32)EMaterialType::Metal;
+	Materials[(uint32)EBenchmarkMaterial::Metal].GetData<FMaterialMetal>() = { FVector3(0.9F, 0.8F, 0.5F), 0.1F };
+	Materials[(uint32)EBenchmarkMaterial::Glass].MaterialTypeID = (uint32)EMaterialType::Dielectric;
+	Materials[(uint32)EBenchmarkMaterial::Glass].GetData<FMaterialDielectric>() = { FVector3(1.0F, 1.0F, 1.0F), 1.5F };
+	Materials[(uint32)EBenchmarkMaterial::Light].MaterialTypeID = (uint32)EMaterialType::Emissive;
+	Materials[(uint32)EBenchmarkMaterial::Light].GetData<FMaterialEmissive>() = { FVector3(4.0F, 3.0F, 2.0F) };
+
+	return Materials;
+}
+
+/** @return A material for a random object: 80% diffuse, the rest split between metal, glass and light. */
+internal uint32 GetRandomMaterial(FPCG32& Random)
+{
+	EBenchmarkMaterial Material;
+	uint32 Roll = Random.NextBounded(20);
+	if (Roll < 16)
+	{
+		Material = (Roll < 8) ? EBenchmarkMaterial::Red : EBenchmarkMaterial::Blue;
+	}
+	else if (Roll < 18)
+	{
+		Material = EBenchmarkMaterial::Metal;
+	}
+	else
+	{
+		Material = (Roll < 19) ? EBenchmarkMaterial::Glass : EBenchmarkMaterial::Light;
+	}
+	return (uint32)Material;
+}
+
+const FBenchmarkSceneDesc* FBenchmarkScenes::GetScenes(out uint32& SceneCount)
+{
+	SceneCount = ArrayCount(GBenchmarkScenes);
+	return GBenchmarkScenes;
+}
+
+void FBenchmarkScenes::Generate(const FBenchmarkSceneDesc& Desc, float AspectRatio, FMemoryArena& Arena, out FWorld& World)
+{
+	World = {};
+	World.Camera.Position = { 0, -30, 8 };
+	World.Camera.Target = { 0, 0, 0 };
+	World.Camera.AspectRatio = AspectRatio;
+	World.Camera.VerticalFOV = PI * 0.75F;
+
+	World.Environment.SkyRadiance = { 0.3F, 0.4F, 0.5F };
+	World.Environment.SunDirection = FVector3(1, -1, 1).GetNormal();
+	World.Environment.SunIrradiance = { 3.0F, 3.0F, 3.0F };
+
+	World.Materials = CreateMaterials(Arena);
+	World.MaterialCount = (uint32)EBenchmarkMaterial::Count;
+
+	// Every kind of object has its own stream, so adding objects of one kind doesn't change the others.
+	FPCG32 PlaneRandom(Desc.PlaneCount, 0);
+	FPCG32 SphereRandom(Desc.SphereCount, 1);
+
+	World.PlaneCount = 1 + Desc.PlaneCount;
+	World.Planes = Arena.PushArrayZero<FPlane>(World.PlaneCount);
+	World.Planes[0].Normal = { 0, 0, 1 };
+	World.Planes[0].Distance = 0;
+	World.Planes[0].MaterialIndex = (uint32)EBenchmarkMaterial::Ground;
+
+	for (uint32 PlaneIndex = 1; PlaneIndex < World.PlaneCount; ++PlaneIndex)
+	{
+		// The normals face the origin, so the planes form a convex room around it.
+		FVector3 Normal;
+		do
+		{
+			Normal = FVector3(PlaneRandom.NextFloat() * 2.0F - 1.0F, PlaneRandom.NextFloat() * 2.0F - 1.0F, PlaneRandom.NextFloat() * 2.0F - 1.0F);
+		}
+		while (((Normal | Normal) > 1.0F) || ((Normal | Normal) < KINDA_SMALL_NUMBER));
+
+		FPlane& Plane = World.Planes[PlaneIndex];
+		Plane.Normal = Normal.GetNormal();
+		Plane.Distance = BENCHMARK_PLANE_MIN_DISTANCE + PlaneRandom.NextFloat() * (BENCHMARK_PLANE_MAX_DISTANCE - BENCHMARK_PLANE_MIN_DISTANCE);
+		Plane.MaterialIndex = GetRandomMaterial(PlaneRandom);
+	}
+
+	World.SphereCount = Desc.SphereCount;
+	World.Spheres = Arena.PushArray<FSphere>(World.SphereCount);
+
+	// The volume of the spheres is the same at every size.
+	float RadiusScale = cbrtf(1000.0F / (float)FMath::Max(Desc.SphereCount, 1U));
+	for (uint32 SphereIndex = 0; SphereIndex < World.SphereCount; ++SphereIndex)
+	{
+		FSphere& Sphere = World.Spheres[SphereIndex];
+		Sphere.Position.X = (SphereRandom.NextFloat() - 0.5F) * BENCHMARK_SPHERE_AREA_SIZE;
+		Sphere.Position.Y = (SphereRandom.NextFloat() - 0.5F) * BENCHMARK_SPHERE_AREA_SIZE;
+		Sphere.Position.Z = SphereRandom.NextFloat() * BENCHMARK_SPHERE_AREA_HEIGHT;
+		Sphere.Radius = (BENCHMARK_SPHERE_MIN_RADIUS + SphereRandom.NextFloat() * (BENCHMARK_SPHERE_MAX_RADIUS - BENCHMARK_SPHERE_MIN_RADIUS)) * RadiusScale;
+		Sphere.MaterialIndex = GetRandomMaterial(SphereRandom);
+	}
+
+	if (Desc.GridResolution == 0)
+	{
+		return;
+	}
+
+	// A height field of sine waves, with a checkerboard of materials on blocks of 8x8 quads.
+	const uint32 Resolution = Desc.GridResolution;
+	const uint32 RowVertexCount = Resolution + 1;
+
+	FTriangleMesh& Mesh = *Arena.PushStruct<FTriangleMesh>();
+	Mesh = {};
+	Mesh.VertexCount = RowVertexCount * RowVertexCount;
+	Mesh.Vertices = Arena.PushArray<FVector3>(Mesh.VertexCount);
+	Mesh.TriangleCount = 2 * Resolution * Resolution;
+	Mesh.Indices = Arena.PushArray<uint32>(3 * (uint64)Mesh.TriangleCount);
+	Mesh.TriangleMaterialIndices = Arena.PushArray<uint16>(Mesh.TriangleCount);
+
+	for (uint32 Y = 0; Y < RowVertexCount; ++Y)
+	{
+		for (uint32 X = 0; X < RowVertexCount; ++X)
+		{
+			float U = (float)X / (float)Resolution;
+			float V = (float)Y / (float)Resolution;
+			float Height = BENCHMARK_GRID_WAVE_HEIGHT * (1.0F + sinf(U * 12.0F) * cosf(V * 9.0F));
+			Mesh.Vertices[Y * RowVertexCount + X] = FVector3((U - 0.5F) * BENCHMARK_GRID_SIZE, (V - 0.5F) * BENCHMARK_GRID_SIZE, Height);
+		}
+	}
+
+	for (uint32 Y = 0; Y < Resolution; ++Y)
+	{
+		for (uint32 X = 0; X < Resolution; ++X)
+		{
+			uint32 QuadIndex = Y * Resolution + X;
+			uint32 V00 = Y * RowVertexCount + X;
+			uint32 V10 = V00 + 1;
+			uint32 V01 = V00 + RowVertexCount;
+			uint32 V11 = V01 + 1;
+
+			uint32* Indices = Mesh.Indices + 6 * (uint64)QuadIndex;
+			Indices[0] = V00; Indices[1] = V10; Indices[2] = V11;
+			Indices[3] = V00; Indices[4] = V11; Indices[5] = V01;
+
+			uint16 MaterialIndex = (uint16)((((X / 8) + (Y / 8)) & 1) ? EBenchmarkMaterial::Ground : EBenchmarkMaterial::Blue);
+			Mesh.TriangleMaterialIndices[2 * QuadIndex + 0] = MaterialIndex;
+			Mesh.TriangleMaterialIndices[2 * QuadIndex + 1] = MaterialIndex;
+		}
+	}
+
+	World.Meshes = &Mesh;
+	World.MeshCount = 1;
+}
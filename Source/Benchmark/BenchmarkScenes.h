@@ -0,0 +1,57 @@
+/**
+ *--------------------------------------------
+ * BenchmarkScenes.h <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 24 2022.
+ */
+
+#pragma once
+
+#include "Core/Memory/MemoryArena.h"
+#include "World/World.h"
+
+/**
+ * The description of a procedurally generated benchmark scene. Every scene has a ground plane, a
+ *   camera looking at the origin and the default environment; the rest is added on top of it.
+ */
+struct FBenchmarkSceneDesc
+{
+	/** The name of the scene, as reported and as matched by the command line filter. */
+	const char* Name;
+
+	/**
+	 * The number of spheres, randomly spread in a fixed volume above the ground. Their radius shrinks
+	 *   as their number grows, so the volume is about equally crowded at every size.
+	 */
+	uint32      SphereCount;
+
+	/** The number of randomly oriented planes, forming a closed room around the camera. */
+	uint32      PlaneCount;
+
+	/** The number of quads along each side of a wavy height field mesh. If 0, the scene has no mesh. */
+	uint32      GridResolution;
+};
+
+/**
+ *---------------------------------------------------------------------------------
+ * The scenes of the benchmark suite. Every scene is generated from a fixed seed,
+ *   so it's the same on every run and on every machine.
+ *---------------------------------------------------------------------------------
+ */
+class FBenchmarkScenes
+{
+public:
+	/** @return The scenes of the suite, from the cheapest to the most expensive of each kind. */
+	static const FBenchmarkSceneDesc* GetScenes(out uint32& SceneCount);
+
+	/**
+	 * Generates a scene.
+	 *
+	 * @param Desc The description of the scene.
+	 * @param AspectRatio The aspect ratio of the camera.
+	 * @param Arena The arena to allocate the scene's objects from. They live as long as the arena.
+	 * @param World The generated world.
+	 */
+	static void Generate(const FBenchmarkSceneDesc& Desc, float AspectRatio, FMemoryArena& Arena, out FWorld& World);
+};
@@ -19,7 +19,7 @@
 #endif // SM_PLATFORM_MACOS
 
 #if !SM_PLATFORM_WINDOWS && !SM_PLATFORM_LINUX && !SM_PLATFORM_MACOS
-	#error Unknown or unsupported platform! Spearmint currently only supports Windows.
+	#error Unknown or unsupported platform! Spearmint currently only supports Windows and Linux.
 #endif // !SM_PLATFORM_WINDOWS && !SM_PLATFORM_LINUX && !SM_PLATFORM_MACOS
 
 #ifdef _MSC_BUILD
@@ -31,10 +31,11 @@
 	#define SM_COMPILER_CLANG_GCC       1
 #endif // __clang__
 
-#ifdef __gcc__
+// Clang also defines '__GNUC__', for compatibility.
+#if defined(__GNUC__) && !defined(__clang__)
 	#define SM_COMPILER_GCC             1
 	#define SM_COMPILER_CLANG_GCC       1
-#endif // __gcc__
+#endif // defined(__GNUC__) && !defined(__clang__)
 
 #ifndef SM_COMPILER_MSVC
 	#define SM_COMPILER_MSVC            0
@@ -69,8 +70,8 @@
 	#define SM_INLINE     __forceinline
 	#define SM_FUNCTION   __FUNCSIG__
 #elif SM_COMPILER_CLANG_GCC
-	#define SM_DEBUGBREAK __builtin_trap
-	#define SM_INLINE     inline
+	#define SM_DEBUGBREAK __builtin_trap()
+	#define SM_INLINE     inline __attribute__((always_inline))
 	#define SM_FUNCTION   __PRETTY_FUNCTION__
 #endif
 
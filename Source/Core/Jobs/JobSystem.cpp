@@ -0,0 +1,308 @@
+/**
+ *--------------------------------------------
+ * JobSystem.cpp <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 6 2022.
+ */
+
+#include "JobSystem.h"
+#include "WorkStealingQueue.h"
+
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+/** The maximum number of jobs that can be queued by a single thread. */
+#define JOB_QUEUE_CAPACITY 4096
+
+/**
+ * The number of job slots each thread allocates from, in a ring. Slots that are still queued are
+ *   skipped, and as the pool is bigger than the queue there is always a free slot to take.
+ */
+#define JOB_POOL_CAPACITY (2 * JOB_QUEUE_CAPACITY)
+
+/** How many times an idle worker looks for work before going to sleep. */
+#define WORKER_SPIN_COUNT 64
+
+struct FJob
+{
+	FJobFunction      Function;
+	FJobCounter*      Counter;
+	std::atomic<bool> bInUse = false;
+	alignas(16) uint8 Data[FJobSystem::MaxJobDataSize];
+};
+
+struct alignas(64) FJobThreadState
+{
+	SM::TWorkStealingQueue<FJob*, JOB_QUEUE_CAPACITY> Queue;
+	FJob   JobPool[JOB_POOL_CAPACITY];
+	uint32 JobPoolIndex = 0;
+	uint32 RandomState = 0;
+};
+
+internal FJobThreadState*         GThreadStates = nullptr;
+internal std::thread*             GWorkerThreads = nullptr;
+internal uint32                   GThreadCount = 0;
+
+internal std::atomic<bool>        GShutdownRequested = false;
+internal std::atomic<int32>       GQueuedJobCount = 0;
+internal std::atomic<int32>       GSleepingWorkerCount = 0;
+internal std::mutex               GSleepMutex;
+internal std::condition_variable  GSleepCondition;
+
+internal thread_local uint32      GThreadIndex = UINT32_MAX;
+
+internal SM_INLINE uint32 NextRandom(uint32& State)
+{
+	// Xorshift32.
+	State ^= State << 13;
+	State ^= State >> 17;
+	State ^= State << 5;
+	return State;
+}
+
+internal FJob* GetJob()
+{
+	FJobThreadState& ThisThread = GThreadStates[GThreadIndex];
+
+	FJob* Job = nullptr;
+	if (ThisThread.Queue.Pop(Job))
+	{
+		GQueuedJobCount.fetch_sub(1, std::memory_order_relaxed);
+		return Job;
+	}
+
+	// Our own queue is empty, so try to steal from the others, starting with a random victim.
+	uint32 FirstVictim = NextRandom(ThisThread.RandomState) % GThreadCount;
+	for (uint32 Offset = 0; Offset < GThreadCount; ++Offset)
+	{
+		uint32 VictimIndex = (FirstVictim + Offset) % GThreadCount;
+		if (VictimIndex == GThreadIndex)
+		{
+			continue;
+		}
+
+		if (GThreadStates[VictimIndex].Queue.Steal(Job))
+		{
+			GQueuedJobCount.fetch_sub(1, std::memory_order_relaxed);
+			return Job;
+		}
+	}
+
+	return nullptr;
+}
+
+internal FJob* AllocateJob(FJobThreadState& ThisThread)
+{
+	for (;;)
+	{
+		FJob* Job = &ThisThread.JobPool[ThisThread.JobPoolIndex++ & (JOB_POOL_CAPACITY - 1)];
+		if (!Job->bInUse.load(std::memory_order_acquire))
+		{
+			Job->bInUse.store(true, std::memory_order_relaxed);
+			return Job;
+		}
+	}
+}
+
+internal SM_INLINE void ExecuteJob(FJob* Job)
+{
+	// Copy everything out of the slot and release it before executing, as the function
+	//   can run for a long time (for example, if it waits on a counter).
+	FJobFunction Function = Job->Function;
+	FJobCounter* Counter = Job->Counter;
+	alignas(16) uint8 Data[FJobSystem::MaxJobDataSize];
+	memcpy(Data, Job->Data, sizeof(Data));
+	Job->bInUse.store(false, std::memory_order_release);
+
+	Function(Data);
+	if (Counter)
+	{
+		Counter->Value.fetch_sub(1, std::memory_order_release);
+	}
+}
+
+internal void WaitForWork()
+{
+	for (uint32 Spin = 0; Spin < WORKER_SPIN_COUNT; ++Spin)
+	{
+		if (GQueuedJobCount.load() > 0 || GShutdownRequested.load())
+		{
+			return;
+		}
+		std::this_thread::yield();
+	}
+
+	std::unique_lock<std::mutex> Lock(GSleepMutex);
+	GSleepingWorkerCount.fetch_add(1);
+	GSleepCondition.wait(Lock, []() { return GQueuedJobCount.load() > 0 || GShutdownRequested.load(); });
+	GSleepingWorkerCount.fetch_sub(1);
+}
+
+internal void WorkerMain(uint32 ThreadIndex)
+{
+	GThreadIndex = ThreadIndex;
+
+	while (!GShutdownRequested.load(std::memory_order_acquire))
+	{
+		FJob* Job = GetJob();
+		if (Job)
+		{
+			ExecuteJob(Job);
+		}
+		else
+		{
+			WaitForWork();
+		}
+	}
+}
+
+void FJobSystem::Initialize(uint32 ThreadCount)
+{
+	if (ThreadCount == 0)
+	{
+		ThreadCount = std::thread::hardware_concurrency();
+		ThreadCount = ThreadCount > 0 ? ThreadCount : 1;
+	}
+
+	GThreadCount = ThreadCount;
+	GShutdownRequested = false;
+
+	GThreadStates = new FJobThreadState[GThreadCount];
+	for (uint32 ThreadIndex = 0; ThreadIndex < GThreadCount; ++ThreadIndex)
+	{
+		GThreadStates[ThreadIndex].RandomState = 0x9E3779B9U * (ThreadIndex + 1);
+	}
+
+	GThreadIndex = 0;
+	GWorkerThreads = new std::thread[GThreadCount];
+	for (uint32 ThreadIndex = 1; ThreadIndex < GThreadCount; ++ThreadIndex)
+	{
+		GWorkerThreads[ThreadIndex] = std::thread(WorkerMain, ThreadIndex);
+	}
+}
+
+void FJobSystem::Shutdown()
+{
+	{
+		std::lock_guard<std::mutex> Lock(GSleepMutex);
+		GShutdownRequested = true;
+	}
+	GSleepCondition.notify_all();
+
+	for (uint32 ThreadIndex = 1; ThreadIndex < GThreadCount; ++ThreadIndex)
+	{
+		GWorkerThreads[ThreadIndex].join();
+	}
+
+	delete[] GWorkerThreads;
+	delete[] GThreadStates;
+	GWorkerThreads = nullptr;
+	GThreadStates = nullptr;
+	GThreadCount = 0;
+	GThreadIndex = UINT32_MAX;
+}
+
+uint32 FJobSystem::GetThreadCount()
+{
+	return GThreadCount;
+}
+
+uint32 FJobSystem::GetCurrentThreadIndex()
+{
+	return GThreadIndex;
+}
+
+void FJobSystem::Run(FJobFunction Function, const void* Data, uint32 DataSize, FJobCounter* Counter)
+{
+	if (GThreadIndex >= GThreadCount)
+	{
+		// Not a worker thread (or the job system is not initialized), so there is no queue to push to.
+		alignas(16) uint8 LocalData[MaxJobDataSize];
+		if (DataSize > 0)
+		{
+			memcpy(LocalData, Data, DataSize);
+		}
+		Function(LocalData);
+		return;
+	}
+
+	FJobThreadState& ThisThread = GThreadStates[GThreadIndex];
+	FJob* Job = AllocateJob(ThisThread);
+	Job->Function = Function;
+	Job->Counter = Counter;
+	if (DataSize > 0)
+	{
+		memcpy(Job->Data, Data, DataSize);
+	}
+
+	if (Counter)
+	{
+		Counter->Value.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	GQueuedJobCount.fetch_add(1);
+	if (!ThisThread.Queue.Push(Job))
+	{
+		// The queue is full, so execute the job right away.
+		GQueuedJobCount.fetch_sub(1);
+		ExecuteJob(Job);
+		return;
+	}
+
+	if (GSleepingWorkerCount.load() > 0)
+	{
+		// Taking the lock guarantees that a worker which is about to sleep either sees the
+		//   new job or is already waiting on the condition variable.
+		{
+			std::lock_guard<std::mutex> Lock(GSleepMutex);
+		}
+		GSleepCondition.notify_one();
+	}
+}
+
+void FJobSystem::Wait(FJobCounter* Counter)
+{
+	if (GThreadIndex >= GThreadCount)
+	{
+		while (!Counter->IsDone())
+		{
+			std::this_thread::yield();
+		}
+		return;
+	}
+
+	while (!Counter->IsDone())
+	{
+		FJob* Job = GetJob();
+		if (Job)
+		{
+			ExecuteJob(Job);
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+void FJobSystem::ParallelForJob(void* Data)
+{
+	FParallelForData Range = *(FParallelForData*)Data;
+
+	// Keep the first half and hand out the second one, until the range is small enough.
+	while (Range.End - Range.Begin > Range.Granularity)
+	{
+		uint32 Middle = Range.Begin + (Range.End - Range.Begin) / 2;
+
+		FParallelForData SecondHalf = Range;
+		SecondHalf.Begin = Middle;
+		Run(ParallelForJob, &SecondHalf, sizeof(FParallelForData), Range.Counter);
+
+		Range.End = Middle;
+	}
+
+	Range.Invoke(Range.Function, Range.Begin, Range.End);
+}
@@ -0,0 +1,161 @@
+/**
+ *--------------------------------------------
+ * JobSystem.h <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 6 2022.
+ */
+
+#pragma once
+
+#include "Core/CoreTypes.h"
+
+#include <atomic>
+#include <type_traits>
+
+/**
+ * The function executed by a job.
+ *
+ * @param Data Pointer to the payload that was copied into the job when it was submitted.
+ */
+typedef void(*FJobFunction)(void* Data);
+
+/**
+ * Counts how many jobs are still in flight. Every job submitted with a counter increments it,
+ *   and decrements it once it finishes executing. Waiting on a counter is how dependencies
+ *   between jobs are expressed.
+ */
+struct FJobCounter
+{
+	std::atomic<uint32> Value = 0;
+
+	/** @return True if all the jobs associated with this counter have finished. */
+	SM_INLINE bool IsDone() const { return Value.load(std::memory_order_acquire) == 0; }
+};
+
+/**
+ *-------------------------------------------------------------------------------------
+ * Work-stealing job system.
+ * Every thread owns a Chase-Lev deque; jobs submitted by a thread are pushed into its
+ *   own deque, and idle threads steal from the others. The thread that initializes
+ *   the system is a worker as well (with index 0), and it executes jobs while it waits
+ *   on a counter.
+ *-------------------------------------------------------------------------------------
+ */
+class FJobSystem
+{
+public:
+	/** The maximum size of the payload that is copied into a job. */
+	static constexpr uint32 MaxJobDataSize = 48;
+
+public:
+	/**
+	 * Starts the worker threads.
+	 *
+	 * @param ThreadCount The total number of threads executing jobs, including the calling one.
+	 *   If 0, the hardware concurrency is used.
+	 */
+	static void Initialize(uint32 ThreadCount = 0);
+
+	/** Stops and joins all worker threads. */
+	static void Shutdown();
+
+	/** @return The number of threads executing jobs, including the main thread. */
+	static uint32 GetThreadCount();
+
+	/**
+	 * @return The index of the calling thread, in the range [0, GetThreadCount()). Threads
+	 *   unknown to the job system get UINT32_MAX.
+	 */
+	static uint32 GetCurrentThreadIndex();
+
+public:
+	/**
+	 * Submits a job.
+	 * If the job system is not initialized or the calling thread is not one of its workers,
+	 *   the job is executed immediately.
+	 *
+	 * @param Function The function to execute.
+	 * @param Data The payload, copied into the job. Can be nullptr.
+	 * @param DataSize The size of the payload. Must be at most 'MaxJobDataSize'.
+	 * @param Counter The counter to associate the job with. Can be nullptr.
+	 */
+	static void Run(FJobFunction Function, const void* Data, uint32 DataSize, FJobCounter* Counter);
+
+	/**
+	 * Submits a callable object as a job. The callable is copied into the job, so it must be
+	 *   trivially copyable and fit in 'MaxJobDataSize' bytes (a lambda capturing a few
+	 *   pointers or references).
+	 *
+	 * @param Function The callable object. Invoked without parameters.
+	 * @param Counter The counter to associate the job with. Can be nullptr.
+	 */
+	template<typename FunctionType>
+	static void Run(const FunctionType& Function, FJobCounter* Counter);
+
+	/**
+	 * Blocks until all jobs associated with the counter have finished. The calling thread
+	 *   executes other jobs in the meantime.
+	 *
+	 * @param Counter The counter to wait on.
+	 */
+	static void Wait(FJobCounter* Counter);
+
+	/**
+	 * Executes a function over the range [0, Count), splitting it across all threads.
+	 * The range is recursively split in halves, so a thread that steals work takes a big chunk
+	 *   of the remaining range. Returns after the whole range has been processed.
+	 *
+	 * @param Count The number of elements in the range.
+	 * @param Granularity The maximum number of elements processed by a single invocation.
+	 * @param Function The callable object, invoked as 'Function(uint32 Begin, uint32 End)'.
+	 */
+	template<typename FunctionType>
+	static void ParallelFor(uint32 Count, uint32 Granularity, const FunctionType& Function);
+
+private:
+	struct FParallelForData
+	{
+		const void*  Function;
+		void       (*Invoke)(const void* Function, uint32 Begin, uint32 End);
+		uint32       Begin;
+		uint32       End;
+		uint32       Granularity;
+		FJobCounter* Counter;
+	};
+
+	static void ParallelForJob(void* Data);
+};
+
+template<typename FunctionType>
+void FJobSystem::Run(const FunctionType& Function, FJobCounter* Counter)
+{
+	static_assert(std::is_trivially_copyable<FunctionType>::value, "The job function must be trivially copyable!");
+	static_assert(sizeof(FunctionType) <= MaxJobDataSize, "The job function is too big!");
+	static_assert(alignof(FunctionType) <= 16, "The job function is over-aligned!");
+
+	FJobFunction Invoke = [](void* Data) { (*(FunctionType*)Data)(); };
+	Run(Invoke, &Function, sizeof(FunctionType), Counter);
+}
+
+template<typename FunctionType>
+void FJobSystem::ParallelFor(uint32 Count, uint32 Granularity, const FunctionType& Function)
+{
+	if (Count == 0)
+	{
+		return;
+	}
+
+	FJobCounter Counter;
+
+	FParallelForData Data;
+	Data.Function = &Function;
+	Data.Invoke = [](const void* InFunction, uint32 Begin, uint32 End) { (*(const FunctionType*)InFunction)(Begin, End); };
+	Data.Begin = 0;
+	Data.End = Count;
+	Data.Granularity = Granularity > 0 ? Granularity : 1;
+	Data.Counter = &Counter;
+
+	ParallelForJob(&Data);
+	Wait(&Counter);
+}
@@ -0,0 +1,125 @@
+/**
+ *--------------------------------------------
+ * WorkStealingQueue.h <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 6 2022.
+ */
+
+#pragma once
+
+#include "Core/CoreTypes.h"
+
+#include <atomic>
+
+namespace SM
+{
+
+/**
+ *-------------------------------------------------------------------------------
+ * Fixed-capacity Chase-Lev work-stealing deque.
+ * The owning thread pushes and pops items at the bottom (LIFO), while any other
+ *   thread can steal items from the top (FIFO). Only the owner may call 'Push'
+ *   and 'Pop'; 'Steal' is safe to call from any thread.
+ *-------------------------------------------------------------------------------
+ */
+template<typename T, uint32 Capacity>
+class TWorkStealingQueue
+{
+	static_assert((Capacity & (Capacity - 1)) == 0, "The capacity must be a power of two!");
+
+public:
+	TWorkStealingQueue()
+		: Top(0)
+		, Bottom(0)
+	{}
+
+	/**
+	 * Pushes an item at the bottom of the queue. Owner thread only.
+	 *
+	 * @param Item The item to push.
+	 *
+	 * @return True if the item was pushed; False if the queue is full.
+	 */
+	bool Push(T Item)
+	{
+		int64 B = Bottom.load(std::memory_order_relaxed);
+		int64 Tp = Top.load(std::memory_order_acquire);
+		if (B - Tp >= (int64)Capacity)
+		{
+			return false;
+		}
+
+		Buffer[B & Mask].store(Item, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		Bottom.store(B + 1, std::memory_order_relaxed);
+		return true;
+	}
+
+	/**
+	 * Pops the most recently pushed item. Owner thread only.
+	 *
+	 * @param Item Where the popped item is written.
+	 *
+	 * @return True if an item was popped; False if the queue is empty or the last
+	 *   item was stolen in the meantime.
+	 */
+	bool Pop(out T& Item)
+	{
+		int64 B = Bottom.load(std::memory_order_relaxed) - 1;
+		Bottom.store(B, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64 Tp = Top.load(std::memory_order_relaxed);
+
+		if (Tp > B)
+		{
+			// The queue was empty.
+			Bottom.store(B + 1, std::memory_order_relaxed);
+			return false;
+		}
+
+		Item = Buffer[B & Mask].load(std::memory_order_relaxed);
+		if (Tp != B)
+		{
+			return true;
+		}
+
+		// This is the last item, so race against the thieves for it.
+		bool bWon = Top.compare_exchange_strong(Tp, Tp + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+		Bottom.store(B + 1, std::memory_order_relaxed);
+		return bWon;
+	}
+
+	/**
+	 * Steals the oldest item from the queue. Can be called from any thread.
+	 *
+	 * @param Item Where the stolen item is written.
+	 *
+	 * @return True if an item was stolen; False if the queue is empty or another
+	 *   thread took the item first.
+	 */
+	bool Steal(out T& Item)
+	{
+		int64 Tp = Top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64 B = Bottom.load(std::memory_order_acquire);
+
+		if (Tp >= B)
+		{
+			return false;
+		}
+
+		Item = Buffer[Tp & Mask].load(std::memory_order_relaxed);
+		return Top.compare_exchange_strong(Tp, Tp + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+	}
+
+private:
+	static constexpr int64 Mask = (int64)Capacity - 1;
+
+	// Top and Bottom are written by different threads, so keep them on separate cache lines.
+	alignas(64) std::atomic<int64> Top;
+	alignas(64) std::atomic<int64> Bottom;
+	alignas(64) std::atomic<T>     Buffer[Capacity];
+};
+
+} // namespace SM
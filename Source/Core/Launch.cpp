@@ -6,26 +6,40 @@
  * File created on November 2 2022.
  */
 
+#include "Core/Jobs/JobSystem.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Platform/Platform.h"
+#include "Core/Profiling/Profiler.h"
+#include "World/MeshLoader.h"
+#include "World/SceneFile.h"
 #include "World/World.h"
 #include "Renderer/Renderer.h"
+#include "Renderer/RenderKernels.h"
 #include <cstdlib>
 #include <cstdio>
+#include <cstring>
 
 
+/** The time spent refining the image, in seconds. */
+#define RENDER_TIME_BUDGET_SECONDS 2.0
+
+/** Where the profiler capture of the render is written, when the profiler is compiled in. */
+#define PROFILER_TRACE_FILE_NAME   "Spearmint.trace.json"
+
 internal uint32 GetPixelSize(FImage Image)
 {
 	uint32 Result = Image.Width * Image.Height * (uint32)sizeof(uint32);
 	return Result;
 }
 
-internal FImage AllocateImage(uint32 Width, uint32 Height)
+internal FImage AllocateImage(FMemoryArena& Arena, uint32 Width, uint32 Height)
 {
 	FImage Result = {};
 	Result.Width = Width;
 	Result.Height = Height;
 
-	// TODO(Traian): Implement a memory arena.
-	Result.Pixels = (uint32*)malloc(GetPixelSize(Result));
+	// Every row starts on a cache line (if the width allows it), so SIMD stores never split one.
+	Result.Pixels = Arena.PushArray<uint32>((uint64)Width * Height, CACHE_LINE_SIZE);
 	return Result;
 }
 
@@ -53,6 +67,8 @@ struct FBitmapImageHeader
 
 internal void WriteImage(FImage Image, const char* FileName)
 {
+	SM_PROFILE_SCOPE("WriteImage");
+
 	uint32 PixelSize = GetPixelSize(Image);
 
 	FBitmapImageHeader Header = {};
@@ -68,8 +84,7 @@ internal void WriteImage(FImage Image, const char* FileName)
 	Header.Compression = 0;
 	Header.SizeOfBitmap = PixelSize;
 
-	FILE* OutputFile;
-	fopen_s(&OutputFile, FileName, "wb");
+	FILE* OutputFile = FPlatform::OpenFile(FileName, "wb");
 	if (OutputFile)
 	{
 		fwrite(&Header, sizeof(FBitmapImageHeader), 1, OutputFile);
@@ -78,9 +93,60 @@ internal void WriteImage(FImage Image, const char* FileName)
 	}
 }
 
-internal int32 GuardedMain(char** Args, uint32 ArgCount)
+/** @return True if the file name ends with the extension (given with its dot). */
+internal bool HasExtension(const char* FileName, const char* Extension)
+{
+	uint64 FileNameLength = strlen(FileName);
+	uint64 ExtensionLength = strlen(Extension);
+	return (FileNameLength >= ExtensionLength) && (strcmp(FileName + FileNameLength - ExtensionLength, Extension) == 0);
+}
+
+internal void PrintArenaStats(const char* Name, const FMemoryArenaStats& Stats)
 {
-	FImage Image = AllocateImage(1200, 900);
+	printf("%-12s %10.2f MB used, %10.2f MB peak, %10.2f MB reserved in %u blocks, %llu pushes.\n", Name,
+		Stats.UsedSize / (1024.0 * 1024.0), Stats.PeakUsedSize / (1024.0 * 1024.0), Stats.ReservedSize / (1024.0 * 1024.0),
+		Stats.BlockCount, (unsigned long long)Stats.PushCount);
+}
+
+internal int32 GuardedMain(char** CommandLineArgs, uint32 CommandLineArgCount)
+{
+	// Usage: Spearmint [--kernels sse|avx2|auto] [MeshFile | SceneFile.smscene] [OutputSceneFile.smscene]
+	// The options are taken out of the arguments, so the rest are found at the same positions with or without them.
+	EKernelISA KernelISA = EKernelISA::Count;
+	char* Args[8] = { CommandLineArgs[0] };
+	uint32 ArgCount = 1;
+	for (uint32 ArgIndex = 1; ArgIndex < CommandLineArgCount; ++ArgIndex)
+	{
+		if (strcmp(CommandLineArgs[ArgIndex], "--kernels") == 0)
+		{
+			if ((ArgIndex + 1 >= CommandLineArgCount) || !FKernelDispatch::Parse(CommandLineArgs[ArgIndex + 1], KernelISA))
+			{
+				printf("Expected one of 'sse', 'avx2' or 'auto' after '--kernels'.\n");
+				return 1;
+			}
+			++ArgIndex;
+		}
+		else if (ArgCount < ArrayCount(Args))
+		{
+			Args[ArgCount++] = CommandLineArgs[ArgIndex];
+		}
+	}
+
+	// The kernels are selected before anything that uses them is created.
+	bool bKernelsSupported = FKernelDispatch::Initialize(KernelISA);
+	if (!bKernelsSupported)
+	{
+		printf("The processor doesn't support the '%s' kernels.\n", FKernelDispatch::GetKernels(KernelISA).Name);
+	}
+	printf("Kernels: %s (best supported: %s).\n", FKernelDispatch::GetKernels().Name,
+		FKernelDispatch::GetKernels(FKernelDispatch::GetBestSupported()).Name);
+
+	FJobSystem::Initialize();
+	FMemory::Initialize();
+	FSampler::Initialize();
+
+	FMemoryArena& PersistentArena = FMemory::GetPersistentArena();
+	FImage Image = AllocateImage(PersistentArena, 1200, 900);
 
 	FRenderer Renderer;
 
@@ -90,9 +156,15 @@ internal int32 GuardedMain(char** Args, uint32 ArgCount)
 	World.Camera.AspectRatio = (float)Image.Width / (float)Image.Height;
 	World.Camera.VerticalFOV = PI * 0.75F;
 
+	World.Environment.SkyRadiance = { 0.3F, 0.4F, 0.5F };
+	World.Environment.SunDirection = FVector3(1, -1, 1).GetNormal();
+	World.Environment.SunIrradiance = { 3.0F, 3.0F, 3.0F };
+
 	FMaterial Materials[2] = {};
-	*((FMaterialDefault*)Materials[0].AbstractMaterialData) = { FVector3(1, 1, 1) };
-	*((FMaterialDefault*)Materials[1].AbstractMaterialData) = { FVector3(1, 0, 0) };
+	Materials[0].MaterialTypeID = (uint32)EMaterialType::Diffuse;
+	Materials[0].GetData<FMaterialDiffuse>() = { FVector3(1, 1, 1) };
+	Materials[1].MaterialTypeID = (uint32)EMaterialType::Diffuse;
+	Materials[1].GetData<FMaterialDiffuse>() = { FVector3(1, 0, 0) };
 
 	World.MaterialCount = ArrayCount(Materials);
 	World.Materials = Materials;
@@ -116,11 +188,131 @@ internal int32 GuardedMain(char** Args, uint32 ArgCount)
 	World.SphereCount = ArrayCount(Spheres);
 	World.Spheres = Spheres;
 
-	Renderer.SetWorld(&World);
+	World.MeshCount = 0;
+	World.Meshes = nullptr;
+
+	// A mesh or scene given on the command line replaces the default scene. Scenes come with their acceleration
+	//   structures already built. The rendered scene (with its acceleration structures) can be saved.
+	FTriangleMesh Mesh = {};
+	FLoadedScene LoadedScene;
+	const FWorldAcceleration* PrebuiltAcceleration = nullptr;
+	if ((ArgCount > 1) && HasExtension(Args[1], ".smscene"))
+	{
+		float64 LoadStartTime = FPlatform::GetTimeSeconds();
+		ESceneLoadResult LoadResult = FSceneFile::Load(Args[1], LoadedScene, PersistentArena);
+		if (LoadResult != ESceneLoadResult::Success)
+		{
+			printf("Failed to load '%s': %s.\n", Args[1], FSceneFile::GetResultString(LoadResult));
+			FMemory::Shutdown();
+			FJobSystem::Shutdown();
+			return 1;
+		}
+
+		printf("Loaded scene '%s': %u spheres, %u planes, %u meshes in %.3f ms.\n", Args[1], LoadedScene.World.SphereCount,
+			LoadedScene.World.PlaneCount, LoadedScene.World.MeshCount, (FPlatform::GetTimeSeconds() - LoadStartTime) * 1000.0);
+
+		World = LoadedScene.World;
+		World.Camera.AspectRatio = (float)Image.Width / (float)Image.Height;
+		PrebuiltAcceleration = &LoadedScene.Acceleration;
+	}
+	else if (ArgCount > 1)
+	{
+		float64 LoadStartTime = FPlatform::GetTimeSeconds();
+		EMeshLoadResult LoadResult = FMeshLoader::Load(Args[1], Mesh, PersistentArena);
+		if (LoadResult != EMeshLoadResult::Success)
+		{
+			printf("Failed to load '%s': %s.\n", Args[1], FMeshLoader::GetResultString(LoadResult));
+			FMemory::Shutdown();
+			FJobSystem::Shutdown();
+			return 1;
+		}
+
+		printf("Loaded '%s': %u vertices, %u triangles in %.3f ms.\n", Args[1], Mesh.VertexCount, Mesh.TriangleCount,
+			(FPlatform::GetTimeSeconds() - LoadStartTime) * 1000.0);
+
+		World.MeshCount = 1;
+		World.Meshes = &Mesh;
+		World.PlaneCount = 0;
+		World.SphereCount = 0;
+
+		// Look at the mesh from the front, far enough to fit it in the image.
+		FBox Bounds = FBox::Empty();
+		for (uint32 VertexIndex = 0; VertexIndex < Mesh.VertexCount; ++VertexIndex)
+		{
+			Bounds.Grow(Mesh.Vertices[VertexIndex]);
+		}
+		FVector3 Extent = Bounds.GetExtent();
+		float Radius = FMath::Max(FMath::Max(Extent.X, Extent.Y), Extent.Z);
+		World.Camera.Target = Bounds.GetCenter();
+		World.Camera.Position = World.Camera.Target + FVector3(0, -2.5F * Radius, 0.5F * Radius);
+	}
+
+	Renderer.SetWorld(&World, PrebuiltAcceleration);
 	Renderer.SetImageTarget(&Image);
 
-	Renderer.Render();
+	const FBVHBuildStats& BVHStats = Renderer.GetSphereBVHStats();
+	printf("Sphere BVH: %u nodes, %u leaves, depth %u, SAH cost %.2f, built in %.3f ms.\n",
+		BVHStats.NodeCount, BVHStats.LeafCount, BVHStats.MaxDepth, BVHStats.SAHCost, BVHStats.BuildTimeSeconds * 1000.0);
+
+	if (ArgCount > 2)
+	{
+		if (FSceneFile::Save(Args[2], World, Renderer.GetAcceleration()))
+		{
+			printf("Saved scene '%s'.\n", Args[2]);
+		}
+		else
+		{
+			printf("Failed to save scene '%s'.\n", Args[2]);
+		}
+	}
+
+#if SM_ENABLE_PROFILING
+	// The capture covers the render and the writing of the image.
+	FProfiler::Initialize();
+	FProfiler::BeginCapture();
+#endif // SM_ENABLE_PROFILING
+
+	// Refine the image for a fixed amount of time, instead of guessing a sample count that fits in it.
+	FMemory::BeginFrame();
+	float64 RenderStartTime = FPlatform::GetTimeSeconds();
+	Renderer.RenderProgressive(RENDER_TIME_BUDGET_SECONDS);
+
+	FRenderer::FRenderStats RenderStats = Renderer.GetStats();
+	printf("Rendered %u passes (%.2f samples per pixel, %u/%u blocks done) in %.3f ms.\n", RenderStats.PassCount,
+		(float64)RenderStats.SampleCount / ((float64)Image.Width * Image.Height), RenderStats.ConvergedBlockCount, RenderStats.BlockCount,
+		(FPlatform::GetTimeSeconds() - RenderStartTime) * 1000.0);
+
+	uint64 RayCount = RenderStats.PrimaryRayCount + RenderStats.SecondaryRayCount + RenderStats.ShadowRayCount;
+	uint64 ExtendedRayCount = RenderStats.PrimaryRayCount + RenderStats.SecondaryRayCount;
+	printf("Traced %.2f M rays (%.2f M primary, %.2f M secondary, %.2f M shadow), %.1f%% hit a surface, %.2f M rays/s.\n",
+		RayCount / 1e6, RenderStats.PrimaryRayCount / 1e6, RenderStats.SecondaryRayCount / 1e6, RenderStats.ShadowRayCount / 1e6,
+		ExtendedRayCount ? 100.0 * RenderStats.HitCount / ExtendedRayCount : 0.0,
+		RenderStats.RenderTimeSeconds > 0.0 ? RayCount / RenderStats.RenderTimeSeconds / 1e6 : 0.0);
 	WriteImage(Image, "Scene.bmp");
+
+#if SM_ENABLE_PROFILING
+	FProfiler::EndCapture();
+	FProfiler::PrintSummary();
+	if (FProfiler::WriteChromeTrace(PROFILER_TRACE_FILE_NAME))
+	{
+		printf("Saved the profiler capture to '%s'.\n", PROFILER_TRACE_FILE_NAME);
+	}
+	else
+	{
+		printf("Failed to save the profiler capture to '%s'.\n", PROFILER_TRACE_FILE_NAME);
+	}
+	FProfiler::Shutdown();
+#endif // SM_ENABLE_PROFILING
+
+	PrintArenaStats("Persistent", PersistentArena.GetStats());
+	PrintArenaStats("Frame", FMemory::GetFrameArena().GetStats());
+	PrintArenaStats("Scratch", FMemory::GetScratchStats());
+	PrintArenaStats("Acceleration", Renderer.GetAcceleration().GetArena().GetStats());
+
+	FSceneFile::Release(LoadedScene);
+
+	FMemory::Shutdown();
+	FJobSystem::Shutdown();
 	return 0;
 }
 
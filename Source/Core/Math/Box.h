@@ -0,0 +1,140 @@
+/**
+ *--------------------------------------------
+ * Box.h <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 7 2022.
+ */
+
+#pragma once
+
+#include "MathUtilities.h"
+#include "Vector3.h"
+
+namespace SM
+{
+
+/**
+ *--------------------------------------------------------------
+ * An axis-aligned bounding box, described by its minimum and
+ *   maximum corners.
+ *--------------------------------------------------------------
+ */
+template<typename T>
+struct TBox
+{
+public:
+	/** The box's minimum corner. */
+	TVector3<T> Min;
+
+	/** The box's maximum corner. */
+	TVector3<T> Max;
+
+public:
+	/** @return An empty box. Growing it with anything results in the thing itself. */
+	static TBox<T> Empty() { return TBox<T>(TVector3<T>(T(BIG_NUMBER)), TVector3<T>(T(-BIG_NUMBER))); }
+
+public:
+	/**
+	 * Default constructor.
+	 * Initializes both corners with 0.
+	 */
+	SM_INLINE TBox();
+
+	/**
+	 * Constructor using the two corners.
+	 *
+	 * @param InMin The minimum corner.
+	 * @param InMax The maximum corner.
+	 */
+	SM_INLINE TBox(const TVector3<T>& InMin, const TVector3<T>& InMax);
+
+public:
+	/**
+	 * Enlarges the box so that it contains a point.
+	 *
+	 * @param Point The point to include.
+	 */
+	SM_INLINE void Grow(const TVector3<T>& Point);
+
+	/**
+	 * Enlarges the box so that it contains another box.
+	 *
+	 * @param Other The box to include.
+	 */
+	SM_INLINE void Grow(const TBox<T>& Other);
+
+	/** @return The box's center. */
+	SM_INLINE TVector3<T> GetCenter() const;
+
+	/** @return The box's size along each axis. */
+	SM_INLINE TVector3<T> GetExtent() const;
+
+	/** @return The box's surface area, or 0 if the box is empty. */
+	SM_INLINE T GetSurfaceArea() const;
+};
+
+} // namespace SM
+
+/**
+*------------------------------------------------------------
+* An axis-aligned box with single-floating point precision.
+*------------------------------------------------------------
+* @see 'TBox<T>'.
+*/
+using FBox = SM::TBox<float>;
+
+namespace SM
+{
+
+template<typename T>
+SM_INLINE TBox<T>::TBox()
+	: Min(T(0.0))
+	, Max(T(0.0))
+{}
+
+template<typename T>
+SM_INLINE TBox<T>::TBox(const TVector3<T>& InMin, const TVector3<T>& InMax)
+	: Min(InMin)
+	, Max(InMax)
+{}
+
+template<typename T>
+SM_INLINE void TBox<T>::Grow(const TVector3<T>& Point)
+{
+	Min = TVector3<T>(FMath::Min(Min.X, Point.X), FMath::Min(Min.Y, Point.Y), FMath::Min(Min.Z, Point.Z));
+	Max = TVector3<T>(FMath::Max(Max.X, Point.X), FMath::Max(Max.Y, Point.Y), FMath::Max(Max.Z, Point.Z));
+}
+
+template<typename T>
+SM_INLINE void TBox<T>::Grow(const TBox<T>& Other)
+{
+	Min = TVector3<T>(FMath::Min(Min.X, Other.Min.X), FMath::Min(Min.Y, Other.Min.Y), FMath::Min(Min.Z, Other.Min.Z));
+	Max = TVector3<T>(FMath::Max(Max.X, Other.Max.X), FMath::Max(Max.Y, Other.Max.Y), FMath::Max(Max.Z, Other.Max.Z));
+}
+
+template<typename T>
+SM_INLINE TVector3<T> TBox<T>::GetCenter() const
+{
+	return (Min + Max) * T(0.5);
+}
+
+template<typename T>
+SM_INLINE TVector3<T> TBox<T>::GetExtent() const
+{
+	return Max - Min;
+}
+
+template<typename T>
+SM_INLINE T TBox<T>::GetSurfaceArea() const
+{
+	TVector3<T> Extent = GetExtent();
+	if (Extent.X < T(0) || Extent.Y < T(0) || Extent.Z < T(0))
+	{
+		return T(0);
+	}
+
+	return T(2) * (Extent.X * Extent.Y + Extent.Y * Extent.Z + Extent.Z * Extent.X);
+}
+
+} // namespace SM
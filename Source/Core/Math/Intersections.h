@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "Core/Math/Box.h"
 #include "Core/Math/Ray.h"
 
 template<typename T>
@@ -40,6 +41,12 @@ SM_INLINE uint8 IntersectSphere(const SM::TRay<T>& Ray, const SM::TVector3<T>& S
 	T DiscriminantRoot = FMath::Sqrt(Discriminant);
 	T OneOverTwoA = 1 / (2 * A);
 	Distance = (-B - DiscriminantRoot) * OneOverTwoA;
+
+	// Rays that start inside the sphere hit its far side.
+	if (!(Distance > T(0)))
+	{
+		Distance = (-B + DiscriminantRoot) * OneOverTwoA;
+	}
 	return 1;
 }
 
@@ -75,4 +82,156 @@ SM_INLINE uint8 IntersectSphere(const SM::TRay<T>& Ray, const SM::TVector3<T>& S
 		*Distance1 = (-B + DiscriminantRoot) * OneOverA;
 	}
 	return 2;
-}
\ No newline at end of file
+}
+
+/**
+ * Slab test between a ray and an axis-aligned box.
+ *
+ * @param Ray The ray.
+ * @param InvDirection The component-wise inverse of the ray's direction.
+ * @param BoxMin The box's minimum corner.
+ * @param BoxMax The box's maximum corner.
+ * @param MaxDistance Intersections further than this are ignored.
+ * @param Distance The distance to the point where the ray enters the box. Negative if the ray
+ *   origin is inside the box.
+ *
+ * @return 1 if the ray hits the box in the range (-inf, MaxDistance); 0 otherwise.
+ */
+template<typename T>
+SM_INLINE uint8 IntersectBox(const SM::TRay<T>& Ray, const SM::TVector3<T>& InvDirection, const SM::TVector3<T>& BoxMin, const SM::TVector3<T>& BoxMax, T MaxDistance, out T& Distance)
+{
+	T TX0 = (BoxMin.X - Ray.Origin.X) * InvDirection.X;
+	T TX1 = (BoxMax.X - Ray.Origin.X) * InvDirection.X;
+	T TY0 = (BoxMin.Y - Ray.Origin.Y) * InvDirection.Y;
+	T TY1 = (BoxMax.Y - Ray.Origin.Y) * InvDirection.Y;
+	T TZ0 = (BoxMin.Z - Ray.Origin.Z) * InvDirection.Z;
+	T TZ1 = (BoxMax.Z - Ray.Origin.Z) * InvDirection.Z;
+
+	T Enter = FMath::Max(FMath::Max(FMath::Min(TX0, TX1), FMath::Min(TY0, TY1)), FMath::Min(TZ0, TZ1));
+	T Exit = FMath::Min(FMath::Min(FMath::Max(TX0, TX1), FMath::Max(TY0, TY1)), FMath::Max(TZ0, TZ1));
+
+	Distance = Enter;
+	return (Enter <= Exit) && (Exit >= T(0)) && (Enter < MaxDistance);
+}
+/**
+ * The per-ray data needed by the watertight ray-triangle test. It depends only on the ray's direction,
+ *   so it is computed once and reused for every triangle the ray is tested against.
+ */
+template<typename T>
+struct TWatertightRay
+{
+	/** The axes of the ray's coordinate space; KZ is the dominant axis of the direction. */
+	uint32 KX;
+	uint32 KY;
+	uint32 KZ;
+
+	/** The shear that aligns the ray direction with the Z axis. */
+	T      SX;
+	T      SY;
+	T      SZ;
+};
+
+using FWatertightRay = TWatertightRay<float>;
+
+/** @return The component of a vector along an axis (0, 1 or 2). */
+template<typename T>
+SM_INLINE T GetAxisComponent(const SM::TVector3<T>& Vector, uint32 Axis)
+{
+	return (&Vector.X)[Axis];
+}
+
+template<typename T>
+SM_INLINE TWatertightRay<T> PrepareWatertightRay(const SM::TRay<T>& Ray)
+{
+	TWatertightRay<T> Result;
+
+	T AbsX = FMath::Abs(Ray.Direction.X);
+	T AbsY = FMath::Abs(Ray.Direction.Y);
+	T AbsZ = FMath::Abs(Ray.Direction.Z);
+	Result.KZ = (AbsX > AbsY) ? ((AbsX > AbsZ) ? 0 : 2) : ((AbsY > AbsZ) ? 1 : 2);
+	Result.KX = (Result.KZ + 1) % 3;
+	Result.KY = (Result.KX + 1) % 3;
+
+	// Swap the other two axes to preserve the winding of the triangles.
+	if (GetAxisComponent(Ray.Direction, Result.KZ) < T(0))
+	{
+		uint32 Temp = Result.KX;
+		Result.KX = Result.KY;
+		Result.KY = Temp;
+	}
+
+	T DirectionZ = GetAxisComponent(Ray.Direction, Result.KZ);
+	Result.SX = GetAxisComponent(Ray.Direction, Result.KX) / DirectionZ;
+	Result.SY = GetAxisComponent(Ray.Direction, Result.KY) / DirectionZ;
+	Result.SZ = T(1) / DirectionZ;
+	return Result;
+}
+
+/**
+ * Watertight ray-triangle test (Woop, Benthin and Wald). Rays that hit an edge or vertex shared
+ *   by multiple triangles always hit at least one of them, so there are no cracks in meshes.
+ * Both sides of the triangle are hit.
+ *
+ * @param Ray The ray.
+ * @param WatertightRay The ray's data, from 'PrepareWatertightRay'.
+ * @param V0, V1, V2 The triangle's vertices.
+ * @param Distance The distance to the intersection.
+ * @param U, V The barycentric coordinates of the intersection, relative to V1 and V2.
+ *
+ * @return 1 if the ray hits the triangle in the range (0, inf); 0 otherwise.
+ */
+template<typename T>
+SM_INLINE uint8 IntersectTriangle(const SM::TRay<T>& Ray, const TWatertightRay<T>& WatertightRay, const SM::TVector3<T>& V0, const SM::TVector3<T>& V1, const SM::TVector3<T>& V2,
+	out T& Distance, out T& U, out T& V)
+{
+	const uint32 KX = WatertightRay.KX;
+	const uint32 KY = WatertightRay.KY;
+	const uint32 KZ = WatertightRay.KZ;
+
+	SM::TVector3<T> A = V0 - Ray.Origin;
+	SM::TVector3<T> B = V1 - Ray.Origin;
+	SM::TVector3<T> C = V2 - Ray.Origin;
+
+	// Shear and scale the vertices, so the ray becomes the Z axis.
+	T AX = GetAxisComponent(A, KX) - WatertightRay.SX * GetAxisComponent(A, KZ);
+	T AY = GetAxisComponent(A, KY) - WatertightRay.SY * GetAxisComponent(A, KZ);
+	T BX = GetAxisComponent(B, KX) - WatertightRay.SX * GetAxisComponent(B, KZ);
+	T BY = GetAxisComponent(B, KY) - WatertightRay.SY * GetAxisComponent(B, KZ);
+	T CX = GetAxisComponent(C, KX) - WatertightRay.SX * GetAxisComponent(C, KZ);
+	T CY = GetAxisComponent(C, KY) - WatertightRay.SY * GetAxisComponent(C, KZ);
+
+	// Scaled barycentric coordinates.
+	T EdgeU = CX * BY - CY * BX;
+	T EdgeV = AX * CY - AY * CX;
+	T EdgeW = BX * AY - BY * AX;
+
+	// On an edge, the single precision result is not reliable, so it is recomputed in double precision.
+	if (EdgeU == T(0) || EdgeV == T(0) || EdgeW == T(0))
+	{
+		EdgeU = (T)((double)CX * (double)BY - (double)CY * (double)BX);
+		EdgeV = (T)((double)AX * (double)CY - (double)AY * (double)CX);
+		EdgeW = (T)((double)BX * (double)AY - (double)BY * (double)AX);
+	}
+
+	if ((EdgeU < T(0) || EdgeV < T(0) || EdgeW < T(0)) && (EdgeU > T(0) || EdgeV > T(0) || EdgeW > T(0)))
+	{
+		return 0;
+	}
+
+	T Determinant = EdgeU + EdgeV + EdgeW;
+	if (Determinant == T(0))
+	{
+		return 0;
+	}
+
+	T AZ = WatertightRay.SZ * GetAxisComponent(A, KZ);
+	T BZ = WatertightRay.SZ * GetAxisComponent(B, KZ);
+	T CZ = WatertightRay.SZ * GetAxisComponent(C, KZ);
+	T ScaledDistance = EdgeU * AZ + EdgeV * BZ + EdgeW * CZ;
+
+	T InvDeterminant = T(1) / Determinant;
+	Distance = ScaledDistance * InvDeterminant;
+	U = EdgeV * InvDeterminant;
+	V = EdgeW * InvDeterminant;
+	return Distance > T(0);
+}
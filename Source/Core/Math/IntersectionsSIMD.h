@@ -0,0 +1,455 @@
+/**
+ *--------------------------------------------
+ * IntersectionsSIMD.h <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 9 2022.
+ */
+
+#pragma once
+
+#include "Core/Math/Ray.h"
+#include "Core/Math/RayPacket.h"
+#include "Core/Math/SIMD.h"
+
+/**
+ * The functions are declared in the same inline namespace as the lane-wide types, since their code
+ *   depends on the instruction set the translation unit is compiled for.
+ */
+namespace SM
+{
+inline namespace SM_SIMD_NAMESPACE
+{
+
+/**
+ * Intersects a ray with a range of spheres stored as structure-of-arrays, testing 8 spheres per
+ *   iteration. The arithmetic is the same as 'IntersectSphere', evaluated in the same order, so
+ *   the distances match the scalar version exactly. Rays that start inside a sphere hit its far side.
+ * The arrays are read in blocks of 8, so they must be readable (padded) up to the first multiple
+ *   of 8 after 'End'. The lanes past 'End' are ignored.
+ *
+ * @param Ray The ray.
+ * @param X, Y, Z The sphere centers.
+ * @param RadiusSquared The squared sphere radii.
+ * @param Begin The index of the first sphere to test.
+ * @param End One past the index of the last sphere to test.
+ * @param ClosestDistance Only hits in the range (0, ClosestDistance) are considered. If a sphere is hit,
+ *   it is updated with the distance to the closest one.
+ *
+ * @return The index of the closest sphere hit, or UINT32_MAX if no sphere was hit.
+ */
+SM_INLINE uint32 IntersectSpheres8(const FRay& Ray, const float* X, const float* Y, const float* Z, const float* RadiusSquared, uint32 Begin, uint32 End, out float& ClosestDistance)
+{
+	// Everything that depends only on the ray is computed once, not per sphere.
+	float A = Ray.Direction.Dot(Ray.Direction);
+	float OriginOrigin = Ray.Origin.Dot(Ray.Origin);
+	float OriginDirection = Ray.Origin.Dot(Ray.Direction);
+	float FourA = 4 * A;
+	float OneOverTwoA = 1 / (2 * A);
+
+	alignas(32) float LaneDistances[8];
+	alignas(32) int32 LaneIndices[8];
+
+#if SM_SIMD_AVX2
+	__m256 DirectionX = _mm256_set1_ps(Ray.Direction.X);
+	__m256 DirectionY = _mm256_set1_ps(Ray.Direction.Y);
+	__m256 DirectionZ = _mm256_set1_ps(Ray.Direction.Z);
+	__m256 OriginX = _mm256_set1_ps(Ray.Origin.X);
+	__m256 OriginY = _mm256_set1_ps(Ray.Origin.Y);
+	__m256 OriginZ = _mm256_set1_ps(Ray.Origin.Z);
+	__m256 OD = _mm256_set1_ps(OriginDirection);
+	__m256 OO = _mm256_set1_ps(OriginOrigin);
+	__m256 FourA8 = _mm256_set1_ps(FourA);
+	__m256 OneOverTwoA8 = _mm256_set1_ps(OneOverTwoA);
+	__m256 Two = _mm256_set1_ps(2.0F);
+	__m256 Zero = _mm256_setzero_ps();
+	__m256 SignMask = _mm256_set1_ps(-0.0F);
+	__m256i LaneOffsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	__m256i EndIndex = _mm256_set1_epi32((int32)End);
+
+	__m256 Closest = _mm256_set1_ps(ClosestDistance);
+	__m256i ClosestIndex = _mm256_set1_epi32(-1);
+
+	for (uint32 Index = Begin; Index < End; Index += 8)
+	{
+		__m256 CenterX = _mm256_loadu_ps(X + Index);
+		__m256 CenterY = _mm256_loadu_ps(Y + Index);
+		__m256 CenterZ = _mm256_loadu_ps(Z + Index);
+		__m256 R2 = _mm256_loadu_ps(RadiusSquared + Index);
+
+		__m256 DC = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(DirectionX, CenterX), _mm256_mul_ps(DirectionY, CenterY)), _mm256_mul_ps(DirectionZ, CenterZ));
+		__m256 CC = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(CenterX, CenterX), _mm256_mul_ps(CenterY, CenterY)), _mm256_mul_ps(CenterZ, CenterZ));
+		__m256 CO = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(CenterX, OriginX), _mm256_mul_ps(CenterY, OriginY)), _mm256_mul_ps(CenterZ, OriginZ));
+
+		__m256 B = _mm256_mul_ps(Two, _mm256_sub_ps(OD, DC));
+		__m256 C = _mm256_sub_ps(_mm256_sub_ps(_mm256_add_ps(OO, CC), R2), _mm256_mul_ps(Two, CO));
+		__m256 Discriminant = _mm256_sub_ps(_mm256_mul_ps(B, B), _mm256_mul_ps(FourA8, C));
+
+		__m256 Root = _mm256_sqrt_ps(_mm256_max_ps(Discriminant, Zero));
+		__m256 NegativeB = _mm256_xor_ps(B, SignMask);
+		__m256 Near = _mm256_mul_ps(_mm256_sub_ps(NegativeB, Root), OneOverTwoA8);
+		__m256 Far = _mm256_mul_ps(_mm256_add_ps(NegativeB, Root), OneOverTwoA8);
+		__m256 Distance = _mm256_blendv_ps(Far, Near, _mm256_cmp_ps(Near, Zero, _CMP_GT_OQ));
+
+		__m256i Lanes = _mm256_add_epi32(_mm256_set1_epi32((int32)Index), LaneOffsets);
+		__m256 Mask = _mm256_cmp_ps(Discriminant, Zero, _CMP_GE_OQ);
+		Mask = _mm256_and_ps(Mask, _mm256_cmp_ps(Distance, Zero, _CMP_GT_OQ));
+		Mask = _mm256_and_ps(Mask, _mm256_cmp_ps(Distance, Closest, _CMP_LT_OQ));
+		Mask = _mm256_and_ps(Mask, _mm256_castsi256_ps(_mm256_cmpgt_epi32(EndIndex, Lanes)));
+
+		Closest = _mm256_blendv_ps(Closest, Distance, Mask);
+		ClosestIndex = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(ClosestIndex), _mm256_castsi256_ps(Lanes), Mask));
+	}
+
+	// Horizontal minimum across the 8 lanes.
+	__m256 Minimum = _mm256_min_ps(Closest, _mm256_permute2f128_ps(Closest, Closest, 1));
+	Minimum = _mm256_min_ps(Minimum, _mm256_shuffle_ps(Minimum, Minimum, _MM_SHUFFLE(1, 0, 3, 2)));
+	Minimum = _mm256_min_ps(Minimum, _mm256_shuffle_ps(Minimum, Minimum, _MM_SHUFFLE(2, 3, 0, 1)));
+	if (!(_mm256_cvtss_f32(Minimum) < ClosestDistance))
+	{
+		return UINT32_MAX;
+	}
+
+	_mm256_store_ps(LaneDistances, Closest);
+	_mm256_store_si256((__m256i*)LaneIndices, ClosestIndex);
+#else
+	__m128 DirectionX = _mm_set1_ps(Ray.Direction.X);
+	__m128 DirectionY = _mm_set1_ps(Ray.Direction.Y);
+	__m128 DirectionZ = _mm_set1_ps(Ray.Direction.Z);
+	__m128 OriginX = _mm_set1_ps(Ray.Origin.X);
+	__m128 OriginY = _mm_set1_ps(Ray.Origin.Y);
+	__m128 OriginZ = _mm_set1_ps(Ray.Origin.Z);
+	__m128 OD = _mm_set1_ps(OriginDirection);
+	__m128 OO = _mm_set1_ps(OriginOrigin);
+	__m128 FourA4 = _mm_set1_ps(FourA);
+	__m128 OneOverTwoA4 = _mm_set1_ps(OneOverTwoA);
+	__m128 Two = _mm_set1_ps(2.0F);
+	__m128 Zero = _mm_setzero_ps();
+	__m128 SignMask = _mm_set1_ps(-0.0F);
+	__m128i LaneOffsets = _mm_setr_epi32(0, 1, 2, 3);
+	__m128i EndIndex = _mm_set1_epi32((int32)End);
+
+	// Two independent 4-wide halves, so an iteration still covers 8 spheres.
+	__m128 Closest[2] = { _mm_set1_ps(ClosestDistance), _mm_set1_ps(ClosestDistance) };
+	__m128i ClosestIndex[2] = { _mm_set1_epi32(-1), _mm_set1_epi32(-1) };
+
+	for (uint32 Index = Begin; Index < End; Index += 8)
+	{
+		for (uint32 Half = 0; Half < 2; ++Half)
+		{
+			uint32 HalfIndex = Index + 4 * Half;
+			__m128 CenterX = _mm_loadu_ps(X + HalfIndex);
+			__m128 CenterY = _mm_loadu_ps(Y + HalfIndex);
+			__m128 CenterZ = _mm_loadu_ps(Z + HalfIndex);
+			__m128 R2 = _mm_loadu_ps(RadiusSquared + HalfIndex);
+
+			__m128 DC = _mm_add_ps(_mm_add_ps(_mm_mul_ps(DirectionX, CenterX), _mm_mul_ps(DirectionY, CenterY)), _mm_mul_ps(DirectionZ, CenterZ));
+			__m128 CC = _mm_add_ps(_mm_add_ps(_mm_mul_ps(CenterX, CenterX), _mm_mul_ps(CenterY, CenterY)), _mm_mul_ps(CenterZ, CenterZ));
+			__m128 CO = _mm_add_ps(_mm_add_ps(_mm_mul_ps(CenterX, OriginX), _mm_mul_ps(CenterY, OriginY)), _mm_mul_ps(CenterZ, OriginZ));
+
+			__m128 B = _mm_mul_ps(Two, _mm_sub_ps(OD, DC));
+			__m128 C = _mm_sub_ps(_mm_sub_ps(_mm_add_ps(OO, CC), R2), _mm_mul_ps(Two, CO));
+			__m128 Discriminant = _mm_sub_ps(_mm_mul_ps(B, B), _mm_mul_ps(FourA4, C));
+
+			__m128 Root = _mm_sqrt_ps(_mm_max_ps(Discriminant, Zero));
+			__m128 NegativeB = _mm_xor_ps(B, SignMask);
+			__m128 Near = _mm_mul_ps(_mm_sub_ps(NegativeB, Root), OneOverTwoA4);
+			__m128 Far = _mm_mul_ps(_mm_add_ps(NegativeB, Root), OneOverTwoA4);
+			__m128 NearMask = _mm_cmpgt_ps(Near, Zero);
+			__m128 Distance = _mm_or_ps(_mm_and_ps(NearMask, Near), _mm_andnot_ps(NearMask, Far));
+
+			__m128i Lanes = _mm_add_epi32(_mm_set1_epi32((int32)HalfIndex), LaneOffsets);
+			__m128 Mask = _mm_cmpge_ps(Discriminant, Zero);
+			Mask = _mm_and_ps(Mask, _mm_cmpgt_ps(Distance, Zero));
+			Mask = _mm_and_ps(Mask, _mm_cmplt_ps(Distance, Closest[Half]));
+			Mask = _mm_and_ps(Mask, _mm_castsi128_ps(_mm_cmpgt_epi32(EndIndex, Lanes)));
+
+			Closest[Half] = _mm_or_ps(_mm_and_ps(Mask, Distance), _mm_andnot_ps(Mask, Closest[Half]));
+			ClosestIndex[Half] = _mm_or_si128(_mm_and_si128(_mm_castps_si128(Mask), Lanes), _mm_andnot_si128(_mm_castps_si128(Mask), ClosestIndex[Half]));
+		}
+	}
+
+	// Horizontal minimum across the 8 lanes.
+	__m128 Minimum = _mm_min_ps(Closest[0], Closest[1]);
+	Minimum = _mm_min_ps(Minimum, _mm_shuffle_ps(Minimum, Minimum, _MM_SHUFFLE(1, 0, 3, 2)));
+	Minimum = _mm_min_ps(Minimum, _mm_shuffle_ps(Minimum, Minimum, _MM_SHUFFLE(2, 3, 0, 1)));
+	if (!(_mm_cvtss_f32(Minimum) < ClosestDistance))
+	{
+		return UINT32_MAX;
+	}
+
+	_mm_store_ps(LaneDistances, Closest[0]);
+	_mm_store_ps(LaneDistances + 4, Closest[1]);
+	_mm_store_si128((__m128i*)LaneIndices, ClosestIndex[0]);
+	_mm_store_si128((__m128i*)(LaneIndices + 4), ClosestIndex[1]);
+#endif // SM_SIMD_AVX2
+
+	// Of the lanes with the minimum distance, pick the lowest sphere index (the one the scalar loop would pick).
+	uint32 Result = UINT32_MAX;
+	for (uint32 Lane = 0; Lane < 8; ++Lane)
+	{
+		if (LaneIndices[Lane] >= 0 && (LaneDistances[Lane] < ClosestDistance || (LaneDistances[Lane] == ClosestDistance && (uint32)LaneIndices[Lane] < Result)))
+		{
+			ClosestDistance = LaneDistances[Lane];
+			Result = (uint32)LaneIndices[Lane];
+		}
+	}
+
+	return Result;
+}
+
+/**
+ * Any-hit version of 'IntersectSpheres8'. Returns as soon as a block of 8 spheres contains a hit,
+ *   without looking for the closest one.
+ *
+ * @param Ray The ray.
+ * @param X, Y, Z The sphere centers.
+ * @param RadiusSquared The squared sphere radii.
+ * @param Begin The index of the first sphere to test.
+ * @param End One past the index of the last sphere to test.
+ * @param MaxDistance Only hits in the range (0, MaxDistance) are considered.
+ *
+ * @return True if any of the spheres is hit.
+ */
+SM_INLINE bool IntersectSpheresAny8(const FRay& Ray, const float* X, const float* Y, const float* Z, const float* RadiusSquared, uint32 Begin, uint32 End, float MaxDistance)
+{
+	float A = Ray.Direction.Dot(Ray.Direction);
+	float OriginOrigin = Ray.Origin.Dot(Ray.Origin);
+	float OriginDirection = Ray.Origin.Dot(Ray.Direction);
+	float FourA = 4 * A;
+	float OneOverTwoA = 1 / (2 * A);
+
+#if SM_SIMD_AVX2
+	__m256 DirectionX = _mm256_set1_ps(Ray.Direction.X);
+	__m256 DirectionY = _mm256_set1_ps(Ray.Direction.Y);
+	__m256 DirectionZ = _mm256_set1_ps(Ray.Direction.Z);
+	__m256 OriginX = _mm256_set1_ps(Ray.Origin.X);
+	__m256 OriginY = _mm256_set1_ps(Ray.Origin.Y);
+	__m256 OriginZ = _mm256_set1_ps(Ray.Origin.Z);
+	__m256 OD = _mm256_set1_ps(OriginDirection);
+	__m256 OO = _mm256_set1_ps(OriginOrigin);
+	__m256 FourA8 = _mm256_set1_ps(FourA);
+	__m256 OneOverTwoA8 = _mm256_set1_ps(OneOverTwoA);
+	__m256 Two = _mm256_set1_ps(2.0F);
+	__m256 Zero = _mm256_setzero_ps();
+	__m256 SignMask = _mm256_set1_ps(-0.0F);
+	__m256 Max = _mm256_set1_ps(MaxDistance);
+	__m256i LaneOffsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	__m256i EndIndex = _mm256_set1_epi32((int32)End);
+
+	for (uint32 Index = Begin; Index < End; Index += 8)
+	{
+		__m256 CenterX = _mm256_loadu_ps(X + Index);
+		__m256 CenterY = _mm256_loadu_ps(Y + Index);
+		__m256 CenterZ = _mm256_loadu_ps(Z + Index);
+		__m256 R2 = _mm256_loadu_ps(RadiusSquared + Index);
+
+		__m256 DC = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(DirectionX, CenterX), _mm256_mul_ps(DirectionY, CenterY)), _mm256_mul_ps(DirectionZ, CenterZ));
+		__m256 CC = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(CenterX, CenterX), _mm256_mul_ps(CenterY, CenterY)), _mm256_mul_ps(CenterZ, CenterZ));
+		__m256 CO = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(CenterX, OriginX), _mm256_mul_ps(CenterY, OriginY)), _mm256_mul_ps(CenterZ, OriginZ));
+
+		__m256 B = _mm256_mul_ps(Two, _mm256_sub_ps(OD, DC));
+		__m256 C = _mm256_sub_ps(_mm256_sub_ps(_mm256_add_ps(OO, CC), R2), _mm256_mul_ps(Two, CO));
+		__m256 Discriminant = _mm256_sub_ps(_mm256_mul_ps(B, B), _mm256_mul_ps(FourA8, C));
+
+		__m256 Root = _mm256_sqrt_ps(_mm256_max_ps(Discriminant, Zero));
+		__m256 NegativeB = _mm256_xor_ps(B, SignMask);
+		__m256 Near = _mm256_mul_ps(_mm256_sub_ps(NegativeB, Root), OneOverTwoA8);
+		__m256 Far = _mm256_mul_ps(_mm256_add_ps(NegativeB, Root), OneOverTwoA8);
+		__m256 Distance = _mm256_blendv_ps(Far, Near, _mm256_cmp_ps(Near, Zero, _CMP_GT_OQ));
+
+		__m256i Lanes = _mm256_add_epi32(_mm256_set1_epi32((int32)Index), LaneOffsets);
+		__m256 Mask = _mm256_cmp_ps(Discriminant, Zero, _CMP_GE_OQ);
+		Mask = _mm256_and_ps(Mask, _mm256_cmp_ps(Distance, Zero, _CMP_GT_OQ));
+		Mask = _mm256_and_ps(Mask, _mm256_cmp_ps(Distance, Max, _CMP_LT_OQ));
+		Mask = _mm256_and_ps(Mask, _mm256_castsi256_ps(_mm256_cmpgt_epi32(EndIndex, Lanes)));
+
+		if (_mm256_movemask_ps(Mask))
+		{
+			return true;
+		}
+	}
+#else
+	__m128 DirectionX = _mm_set1_ps(Ray.Direction.X);
+	__m128 DirectionY = _mm_set1_ps(Ray.Direction.Y);
+	__m128 DirectionZ = _mm_set1_ps(Ray.Direction.Z);
+	__m128 OriginX = _mm_set1_ps(Ray.Origin.X);
+	__m128 OriginY = _mm_set1_ps(Ray.Origin.Y);
+	__m128 OriginZ = _mm_set1_ps(Ray.Origin.Z);
+	__m128 OD = _mm_set1_ps(OriginDirection);
+	__m128 OO = _mm_set1_ps(OriginOrigin);
+	__m128 FourA4 = _mm_set1_ps(FourA);
+	__m128 OneOverTwoA4 = _mm_set1_ps(OneOverTwoA);
+	__m128 Two = _mm_set1_ps(2.0F);
+	__m128 Zero = _mm_setzero_ps();
+	__m128 SignMask = _mm_set1_ps(-0.0F);
+	__m128 Max = _mm_set1_ps(MaxDistance);
+	__m128i LaneOffsets = _mm_setr_epi32(0, 1, 2, 3);
+	__m128i EndIndex = _mm_set1_epi32((int32)End);
+
+	for (uint32 Index = Begin; Index < End; Index += 4)
+	{
+		__m128 CenterX = _mm_loadu_ps(X + Index);
+		__m128 CenterY = _mm_loadu_ps(Y + Index);
+		__m128 CenterZ = _mm_loadu_ps(Z + Index);
+		__m128 R2 = _mm_loadu_ps(RadiusSquared + Index);
+
+		__m128 DC = _mm_add_ps(_mm_add_ps(_mm_mul_ps(DirectionX, CenterX), _mm_mul_ps(DirectionY, CenterY)), _mm_mul_ps(DirectionZ, CenterZ));
+		__m128 CC = _mm_add_ps(_mm_add_ps(_mm_mul_ps(CenterX, CenterX), _mm_mul_ps(CenterY, CenterY)), _mm_mul_ps(CenterZ, CenterZ));
+		__m128 CO = _mm_add_ps(_mm_add_ps(_mm_mul_ps(CenterX, OriginX), _mm_mul_ps(CenterY, OriginY)), _mm_mul_ps(CenterZ, OriginZ));
+
+		__m128 B = _mm_mul_ps(Two, _mm_sub_ps(OD, DC));
+		__m128 C = _mm_sub_ps(_mm_sub_ps(_mm_add_ps(OO, CC), R2), _mm_mul_ps(Two, CO));
+		__m128 Discriminant = _mm_sub_ps(_mm_mul_ps(B, B), _mm_mul_ps(FourA4, C));
+
+		__m128 Root = _mm_sqrt_ps(_mm_max_ps(Discriminant, Zero));
+		__m128 NegativeB = _mm_xor_ps(B, SignMask);
+		__m128 Near = _mm_mul_ps(_mm_sub_ps(NegativeB, Root), OneOverTwoA4);
+		__m128 Far = _mm_mul_ps(_mm_add_ps(NegativeB, Root), OneOverTwoA4);
+		__m128 NearMask = _mm_cmpgt_ps(Near, Zero);
+		__m128 Distance = _mm_or_ps(_mm_and_ps(NearMask, Near), _mm_andnot_ps(NearMask, Far));
+
+		__m128i Lanes = _mm_add_epi32(_mm_set1_epi32((int32)Index), LaneOffsets);
+		__m128 Mask = _mm_cmpge_ps(Discriminant, Zero);
+		Mask = _mm_and_ps(Mask, _mm_cmpgt_ps(Distance, Zero));
+		Mask = _mm_and_ps(Mask, _mm_cmplt_ps(Distance, Max));
+		Mask = _mm_and_ps(Mask, _mm_castsi128_ps(_mm_cmpgt_epi32(EndIndex, Lanes)));
+
+		if (_mm_movemask_ps(Mask))
+		{
+			return true;
+		}
+	}
+#endif // SM_SIMD_AVX2
+
+	return false;
+}
+
+/**
+ * Packet version of 'IntersectPlane'.
+ *
+ * @param Packet The rays.
+ * @param PlaneNormal The plane's normal.
+ * @param PlaneDistance The plane's distance from the origin.
+ * @param Distance The distance to the intersection, for every lane.
+ *
+ * @return The lanes whose ray intersects the plane (ignoring the active mask).
+ */
+SM_INLINE FMask8 IntersectPlane8(const FRayPacket8& Packet, const FVector3& PlaneNormal, float PlaneDistance, out FFloat8& Distance)
+{
+	FFloat8 NormalX = FFloat8::Set(PlaneNormal.X);
+	FFloat8 NormalY = FFloat8::Set(PlaneNormal.Y);
+	FFloat8 NormalZ = FFloat8::Set(PlaneNormal.Z);
+
+	FFloat8 NormalDirection = NormalX * Packet.DirectionX + NormalY * Packet.DirectionY + NormalZ * Packet.DirectionZ;
+	FFloat8 NormalOrigin = NormalX * Packet.OriginX + NormalY * Packet.OriginY + NormalZ * Packet.OriginZ;
+
+	Distance = (FFloat8::Set(-PlaneDistance) - NormalOrigin) / NormalDirection;
+	return FFloat8::Abs(NormalDirection) > FFloat8::Set(KINDA_SMALL_NUMBER);
+}
+
+/**
+ * Packet version of 'IntersectBox'.
+ *
+ * @param Packet The rays.
+ * @param InvDirectionX, InvDirectionY, InvDirectionZ The component-wise inverse of the rays' directions.
+ * @param BoxMin The box's minimum corner.
+ * @param BoxMax The box's maximum corner.
+ * @param MaxDistance Intersections further than this are ignored, for every lane.
+ * @param Distance The distance to the point where every ray enters the box.
+ *
+ * @return The lanes whose ray hits the box in the range (-inf, MaxDistance) (ignoring the active mask).
+ */
+SM_INLINE FMask8 IntersectBox8(const FRayPacket8& Packet, const FFloat8& InvDirectionX, const FFloat8& InvDirectionY, const FFloat8& InvDirectionZ,
+	const FVector3& BoxMin, const FVector3& BoxMax, const FFloat8& MaxDistance, out FFloat8& Distance)
+{
+	FFloat8 TX0 = (FFloat8::Set(BoxMin.X) - Packet.OriginX) * InvDirectionX;
+	FFloat8 TX1 = (FFloat8::Set(BoxMax.X) - Packet.OriginX) * InvDirectionX;
+	FFloat8 TY0 = (FFloat8::Set(BoxMin.Y) - Packet.OriginY) * InvDirectionY;
+	FFloat8 TY1 = (FFloat8::Set(BoxMax.Y) - Packet.OriginY) * InvDirectionY;
+	FFloat8 TZ0 = (FFloat8::Set(BoxMin.Z) - Packet.OriginZ) * InvDirectionZ;
+	FFloat8 TZ1 = (FFloat8::Set(BoxMax.Z) - Packet.OriginZ) * InvDirectionZ;
+
+	FFloat8 Enter = FFloat8::Max(FFloat8::Max(FFloat8::Min(TX0, TX1), FFloat8::Min(TY0, TY1)), FFloat8::Min(TZ0, TZ1));
+	FFloat8 Exit = FFloat8::Min(FFloat8::Min(FFloat8::Max(TX0, TX1), FFloat8::Max(TY0, TY1)), FFloat8::Max(TZ0, TZ1));
+
+	Distance = Enter;
+	return (Enter <= Exit) & (Exit >= FFloat8::Set(0.0F)) & (Enter < MaxDistance);
+}
+
+/**
+ * Intersects a packet of rays with a range of spheres stored as structure-of-arrays, testing one
+ *   sphere against all 8 rays at a time. Per lane, the result is the same as 'IntersectSphere'.
+ *
+ * @param Packet The rays. Only the active lanes are updated.
+ * @param X, Y, Z The sphere centers.
+ * @param RadiusSquared The squared sphere radii.
+ * @param Begin The index of the first sphere to test.
+ * @param End One past the index of the last sphere to test.
+ * @param ClosestDistance Only hits in the range (0, ClosestDistance) are considered. Updated for every
+ *   lane whose ray hits a sphere.
+ * @param ClosestIndex The index of the closest sphere hit, for every lane. Only written for the lanes
+ *   whose ray hits a sphere.
+ *
+ * @return The lanes whose ray hit a sphere.
+ */
+SM_INLINE FMask8 IntersectSpheresPacket8(const FRayPacket8& Packet, const float* X, const float* Y, const float* Z, const float* RadiusSquared,
+	uint32 Begin, uint32 End, out FFloat8& ClosestDistance, out uint32* ClosestIndex)
+{
+	// Everything that depends only on the rays is computed once, not per sphere.
+	FFloat8 A = Packet.DirectionX * Packet.DirectionX + Packet.DirectionY * Packet.DirectionY + Packet.DirectionZ * Packet.DirectionZ;
+	FFloat8 OriginOrigin = Packet.OriginX * Packet.OriginX + Packet.OriginY * Packet.OriginY + Packet.OriginZ * Packet.OriginZ;
+	FFloat8 OriginDirection = Packet.OriginX * Packet.DirectionX + Packet.OriginY * Packet.DirectionY + Packet.OriginZ * Packet.DirectionZ;
+	FFloat8 Two = FFloat8::Set(2.0F);
+	FFloat8 Zero = FFloat8::Set(0.0F);
+	FFloat8 FourA = FFloat8::Set(4.0F) * A;
+	FFloat8 OneOverTwoA = FFloat8::Set(1.0F) / (Two * A);
+
+	FMask8 HitMask = FMask8::FromBits(0);
+
+	for (uint32 Index = Begin; Index < End; ++Index)
+	{
+		FFloat8 CenterX = FFloat8::Set(X[Index]);
+		FFloat8 CenterY = FFloat8::Set(Y[Index]);
+		FFloat8 CenterZ = FFloat8::Set(Z[Index]);
+		FFloat8 CC = FFloat8::Set(X[Index] * X[Index] + Y[Index] * Y[Index] + Z[Index] * Z[Index]);
+
+		FFloat8 DC = Packet.DirectionX * CenterX + Packet.DirectionY * CenterY + Packet.DirectionZ * CenterZ;
+		FFloat8 CO = CenterX * Packet.OriginX + CenterY * Packet.OriginY + CenterZ * Packet.OriginZ;
+
+		FFloat8 B = Two * (OriginDirection - DC);
+		FFloat8 C = ((OriginOrigin + CC) - FFloat8::Set(RadiusSquared[Index])) - Two * CO;
+		FFloat8 Discriminant = B * B - FourA * C;
+
+		FFloat8 Root = FFloat8::Sqrt(FFloat8::Max(Discriminant, Zero));
+		FFloat8 Near = (-B - Root) * OneOverTwoA;
+		FFloat8 Far = (-B + Root) * OneOverTwoA;
+		FFloat8 Distance = FFloat8::Select(Near > Zero, Near, Far);
+		FMask8 Mask = Packet.ActiveMask & (Discriminant >= Zero) & (Distance > Zero) & (Distance < ClosestDistance);
+
+		uint32 Bits = Mask.GetBits();
+		if (Bits)
+		{
+			ClosestDistance = FFloat8::Select(Mask, Distance, ClosestDistance);
+			HitMask = HitMask | Mask;
+			for (uint32 Lane = 0; Lane < 8; ++Lane)
+			{
+				if (Bits & (1 << Lane))
+				{
+					ClosestIndex[Lane] = Index;
+				}
+			}
+		}
+	}
+
+	return HitMask;
+}
+
+} // inline namespace SM_SIMD_NAMESPACE
+} // namespace SM
+
+using SM::IntersectSpheres8;
+using SM::IntersectSpheresAny8;
+using SM::IntersectPlane8;
+using SM::IntersectBox8;
+using SM::IntersectSpheresPacket8;
@@ -15,4 +15,6 @@
 #include "Vector4.h"
 #include "VectorCommon.h"
 
+#include "Box.h"
+
 #include "Intersections.h"
\ No newline at end of file
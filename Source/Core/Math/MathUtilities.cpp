@@ -1,81 +0,0 @@
-/**
- *--------------------------------------------
- * MathUtilities.cpp <-> Spearmint
- *--------------------------------------------
- * Copyright (c) to Avram Traian. 2022 - 2022.
- * File created on November 2 2022.
- */
-
-#include "MathUtilities.h"
-
-#include <cstdlib>
-
-float FMath::Sqrt(float X)
-{
-	return sqrtf(X);
-}
-
-double FMath::Sqrt(double X)
-{
-	return sqrt(X);
-}
-
-float FMath::Sin(float X)
-{
-	return sinf(X);
-}
-
-double FMath::Sin(double X)
-{
-	return sin(X);
-}
-
-float FMath::Cos(float X)
-{
-	return cosf(X);
-}
-
-double FMath::Cos(double X)
-{
-	return cos(X);
-}
-
-float FMath::Tan(float X)
-{
-	return tanf(X);
-}
-
-double FMath::Tan(double X)
-{
-	return tan(X);
-}
-
-float FMath::Asin(float X)
-{
-	return asinf(X);
-}
-
-double FMath::Asin(double X)
-{
-	return asin(X);
-}
-
-float FMath::Acos(float X)
-{
-	return acosf(X);
-}
-
-double FMath::Acos(double X)
-{
-	return acos(X);
-}
-
-float FMath::Atan(float X)
-{
-	return atanf(X);
-}
-
-double FMath::Atan(double X)
-{
-	return atan(X);
-}
\ No newline at end of file
@@ -11,6 +11,9 @@
 #include "Core/CoreDefines.h"
 #include "Core/CoreTypes.h"
 
+#include <cmath>
+#include <xmmintrin.h>
+
 /**
  * The most common math constants.
  */
@@ -58,6 +61,36 @@
 #define DOUBLE_HALF_SQRT_2        (0.7071067811865475244008443621048)
 #define DOUBLE_HALF_SQRT_3        (0.8660254037844386467637231707529)
 
+/**
+ * The constants of the fast approximations ('FMath::Fast*').
+ */
+#define FASTMATH_ROUND_MAGIC      (12582912.0F)
+#define FASTMATH_PI_HIGH          (3.140625F)
+#define FASTMATH_PI_LOW           (9.67653589793e-4F)
+
+#define FASTMATH_SIN_C0           (9.9999999916e-1F)
+#define FASTMATH_SIN_C1           (-1.6666662484e-1F)
+#define FASTMATH_SIN_C2           (8.3331307782e-3F)
+#define FASTMATH_SIN_C3           (-1.9813423871e-4F)
+#define FASTMATH_SIN_C4           (2.6125380358e-6F)
+
+#define FASTMATH_ATAN_C0          (9.9999611155e-1F)
+#define FASTMATH_ATAN_C1          (-3.3317368055e-1F)
+#define FASTMATH_ATAN_C2          (1.9807815565e-1F)
+#define FASTMATH_ATAN_C3          (-1.3233342096e-1F)
+#define FASTMATH_ATAN_C4          (7.9623672365e-2F)
+#define FASTMATH_ATAN_C5          (-3.3604220565e-2F)
+#define FASTMATH_ATAN_C6          (6.8117932908e-3F)
+
+#define FASTMATH_ACOS_C0          (1.5707963050F)
+#define FASTMATH_ACOS_C1          (-0.2145988016F)
+#define FASTMATH_ACOS_C2          (0.0889789874F)
+#define FASTMATH_ACOS_C3          (-0.0501743046F)
+#define FASTMATH_ACOS_C4          (0.0308918810F)
+#define FASTMATH_ACOS_C5          (-0.0170881256F)
+#define FASTMATH_ACOS_C6          (0.0066700901F)
+#define FASTMATH_ACOS_C7          (-0.0012624911F)
+
  /**
  * Structure for all math utility and helper functions.
  */
@@ -166,10 +199,10 @@ public:
 	 *
 	 * @return The square root.
 	 */
-	static float Sqrt(float X);
+	static SM_INLINE float Sqrt(float X) { return sqrtf(X); }
 
 	/** @see 'FMath::Sqrt(float)'. */
-	static double Sqrt(double X);
+	static SM_INLINE double Sqrt(double X) { return sqrt(X); }
 
 	/**
 	 * Calculates the sine of an angle.
@@ -178,10 +211,10 @@ public:
 	 *
 	 * @return The sine.
 	 */
-	static float Sin(float X);
+	static SM_INLINE float Sin(float X) { return sinf(X); }
 
 	/** @see 'FMath::Sin(float)'. */
-	static double Sin(double X);
+	static SM_INLINE double Sin(double X) { return sin(X); }
 
 	/**
 	 * Calculates the cosine of an angle.
@@ -190,10 +223,10 @@ public:
 	 *
 	 * @return The cosine.
 	 */
-	static float Cos(float X);
+	static SM_INLINE float Cos(float X) { return cosf(X); }
 
 	/** @see 'FMath::Cos(float)'. */
-	static double Cos(double X);
+	static SM_INLINE double Cos(double X) { return cos(X); }
 
 	/**
 	 * Calculates the tangent of an angle.
@@ -202,10 +235,10 @@ public:
 	 *
 	 * @return The tangent.
 	 */
-	static float Tan(float X);
+	static SM_INLINE float Tan(float X) { return tanf(X); }
 
 	/** @see 'FMath::Tan(float)'. */
-	static double Tan(double X);
+	static SM_INLINE double Tan(double X) { return tan(X); }
 
 	/**
 	 * Calculates the asin for a number.
@@ -214,10 +247,10 @@ public:
 	 *
 	 * @return the asin (in radians).
 	 */
-	static float Asin(float X);
+	static SM_INLINE float Asin(float X) { return asinf(X); }
 
 	/** @see 'FMath::Asin(float)'. */
-	static double Asin(double X);
+	static SM_INLINE double Asin(double X) { return asin(X); }
 
 	/**
 	 * Calculates the acos for a number.
@@ -226,10 +259,10 @@ public:
 	 *
 	 * @return The acos (in radians).
 	 */
-	static float Acos(float X);
+	static SM_INLINE float Acos(float X) { return acosf(X); }
 
 	/** @see 'FMath::Acos(float)'. */
-	static double Acos(double X);
+	static SM_INLINE double Acos(double X) { return acos(X); }
 
 	/**
 	 * Calculates the atan for a number.
@@ -238,8 +271,88 @@ public:
 	 *
 	 * @return The atan (in radians).
 	 */
-	static float Atan(float X);
+	static SM_INLINE float Atan(float X) { return atanf(X); }
 
 	/** @see 'FMath::Atan(float)'. */
-	static double Atan(double X);
-};
\ No newline at end of file
+	static SM_INLINE double Atan(double X) { return atan(X); }
+
+public:
+	/**
+	 * The fast approximations below are inlined and evaluated with a few multiplications and additions,
+	 *   instead of calling into the C runtime. The call sites choose between them and the exact functions.
+	 * The maximum absolute errors are measured against the double precision functions. 'FMathWide'
+	 *   (MathWide.h) has the same approximations for the lane-wide types, with the same results per lane.
+	 */
+
+	/**
+	 * Approximates 1 / Sqrt(X), with the 'rsqrt' estimate refined by a Newton-Raphson step.
+	 * Maximum relative error: 2.7e-7.
+	 */
+	static SM_INLINE float FastInvSqrt(float X)
+	{
+		float Estimate = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(X)));
+		return 0.5F * Estimate * (3.0F - X * Estimate * Estimate);
+	}
+
+	/**
+	 * Approximates the sine of an angle with a minimax polynomial, after reducing the angle to [-PI / 2, PI / 2].
+	 * Maximum absolute error: 1.6e-7 for angles up to 1e4 (in absolute value). The error grows past it.
+	 */
+	static SM_INLINE float FastSin(float X)
+	{
+		// The nearest multiple of PI. The rounding of the magic number addition is exact, unlike a float to int conversion.
+		float Quotient = (X * INV_PI + FASTMATH_ROUND_MAGIC) - FASTMATH_ROUND_MAGIC;
+		float Reduced = (X - Quotient * FASTMATH_PI_HIGH) - Quotient * FASTMATH_PI_LOW;
+
+		float Squared = Reduced * Reduced;
+		float Sine = Reduced * (FASTMATH_SIN_C0 + Squared * (FASTMATH_SIN_C1 + Squared * (FASTMATH_SIN_C2 + Squared * (FASTMATH_SIN_C3 + Squared * FASTMATH_SIN_C4))));
+
+		// sin(X + K * PI) = (-1)^K * sin(X).
+		return ((int32)Quotient & 1) ? -Sine : Sine;
+	}
+
+	/**
+	 * Approximates the cosine of an angle, as 'FastSin(X + PI / 2)'.
+	 * Maximum absolute error: 2.2e-7 for angles in [-2 * PI, 2 * PI]. The error grows with the angle, as
+	 *   the addition rounds away more of its bits.
+	 */
+	static SM_INLINE float FastCos(float X)
+	{
+		return FastSin(X + HALF_PI);
+	}
+
+	/**
+	 * Approximates the atan of a number with a minimax polynomial on [-1, 1]; outside of it,
+	 *   atan(X) = +-PI / 2 - atan(1 / X).
+	 * Maximum absolute error: 3.9e-7.
+	 */
+	static SM_INLINE float FastAtan(float X)
+	{
+		bool bOutside = FMath::Abs(X) > 1.0F;
+		float Reduced = bOutside ? (-1.0F / X) : X;
+
+		float Squared = Reduced * Reduced;
+		float Result = Reduced * (FASTMATH_ATAN_C0 + Squared * (FASTMATH_ATAN_C1 + Squared * (FASTMATH_ATAN_C2 + Squared * (FASTMATH_ATAN_C3
+			+ Squared * (FASTMATH_ATAN_C4 + Squared * (FASTMATH_ATAN_C5 + Squared * FASTMATH_ATAN_C6))))));
+
+		if (bOutside)
+		{
+			Result = Result + ((X > 0.0F) ? HALF_PI : -HALF_PI);
+		}
+		return Result;
+	}
+
+	/**
+	 * Approximates the acos of a number in [-1, 1], as Sqrt(1 - X) times a polynomial
+	 *   (Abramowitz and Stegun, 4.4.46); acos(-X) = PI - acos(X).
+	 * Maximum absolute error: 4.1e-7.
+	 */
+	static SM_INLINE float FastAcos(float X)
+	{
+		float Absolute = FMath::Abs(X);
+		float Polynomial = FASTMATH_ACOS_C0 + Absolute * (FASTMATH_ACOS_C1 + Absolute * (FASTMATH_ACOS_C2 + Absolute * (FASTMATH_ACOS_C3
+			+ Absolute * (FASTMATH_ACOS_C4 + Absolute * (FASTMATH_ACOS_C5 + Absolute * (FASTMATH_ACOS_C6 + Absolute * FASTMATH_ACOS_C7))))));
+		float Result = FMath::Sqrt(1.0F - Absolute) * Polynomial;
+		return (X < 0.0F) ? (PI - Result) : Result;
+	}
+};
@@ -0,0 +1,101 @@
+/**
+ *--------------------------------------------
+ * MathWide.h <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 28 2022.
+ */
+
+#pragma once
+
+#include "Core/Math/MathUtilities.h"
+#include "Core/Math/SIMD.h"
+
+namespace SM
+{
+inline namespace SM_SIMD_NAMESPACE
+{
+
+/**
+ * The fast approximations of 'FMath', for the lane-wide types. They use the same constants and evaluate
+ *   the same expressions in the same order, so every lane gets the same result as the scalar function
+ *   (and has the same maximum error). 'FastInvSqrt' is the exception; @see 'TFloatWide<N>::RSqrt'.
+ */
+struct FMathWide
+{
+public:
+	/** @see 'FMath::FastInvSqrt'. */
+	template<uint32 N>
+	static SM_INLINE TFloatWide<N> FastInvSqrt(const TFloatWide<N>& X)
+	{
+		return TFloatWide<N>::RSqrt(X);
+	}
+
+	/** @see 'FMath::FastSin'. */
+	template<uint32 N>
+	static SM_INLINE TFloatWide<N> FastSin(const TFloatWide<N>& X)
+	{
+		typedef TFloatWide<N> FFloat;
+
+		FFloat Quotient = RoundSmall(X * FFloat::Set(INV_PI));
+		FFloat Reduced = (X - Quotient * FFloat::Set(FASTMATH_PI_HIGH)) - Quotient * FFloat::Set(FASTMATH_PI_LOW);
+
+		FFloat Squared = Reduced * Reduced;
+		FFloat Sine = Reduced * (FFloat::Set(FASTMATH_SIN_C0) + Squared * (FFloat::Set(FASTMATH_SIN_C1) + Squared * (FFloat::Set(FASTMATH_SIN_C2)
+			+ Squared * (FFloat::Set(FASTMATH_SIN_C3) + Squared * FFloat::Set(FASTMATH_SIN_C4)))));
+
+		// The quotient is odd where it differs from twice its half, rounded (by 1).
+		TMaskWide<N> Odd = FFloat::Abs(Quotient - FFloat::Set(2.0F) * RoundSmall(Quotient * FFloat::Set(0.5F))) > FFloat::Set(0.5F);
+		return FFloat::Select(Odd, -Sine, Sine);
+	}
+
+	/** @see 'FMath::FastCos'. */
+	template<uint32 N>
+	static SM_INLINE TFloatWide<N> FastCos(const TFloatWide<N>& X)
+	{
+		return FastSin(X + TFloatWide<N>::Set(HALF_PI));
+	}
+
+	/** @see 'FMath::FastAtan'. */
+	template<uint32 N>
+	static SM_INLINE TFloatWide<N> FastAtan(const TFloatWide<N>& X)
+	{
+		typedef TFloatWide<N> FFloat;
+
+		TMaskWide<N> Outside = FFloat::Abs(X) > FFloat::Set(1.0F);
+		FFloat Reduced = FFloat::Select(Outside, -FFloat::Set(1.0F) / X, X);
+
+		FFloat Squared = Reduced * Reduced;
+		FFloat Result = Reduced * (FFloat::Set(FASTMATH_ATAN_C0) + Squared * (FFloat::Set(FASTMATH_ATAN_C1) + Squared * (FFloat::Set(FASTMATH_ATAN_C2)
+			+ Squared * (FFloat::Set(FASTMATH_ATAN_C3) + Squared * (FFloat::Set(FASTMATH_ATAN_C4) + Squared * (FFloat::Set(FASTMATH_ATAN_C5)
+			+ Squared * FFloat::Set(FASTMATH_ATAN_C6)))))));
+
+		FFloat Offset = FFloat::Select(X > FFloat::Set(0.0F), FFloat::Set(HALF_PI), FFloat::Set(-HALF_PI));
+		return FFloat::Select(Outside, Result + Offset, Result);
+	}
+
+	/** @see 'FMath::FastAcos'. */
+	template<uint32 N>
+	static SM_INLINE TFloatWide<N> FastAcos(const TFloatWide<N>& X)
+	{
+		typedef TFloatWide<N> FFloat;
+
+		FFloat Absolute = FFloat::Abs(X);
+		FFloat Polynomial = FFloat::Set(FASTMATH_ACOS_C0) + Absolute * (FFloat::Set(FASTMATH_ACOS_C1) + Absolute * (FFloat::Set(FASTMATH_ACOS_C2)
+			+ Absolute * (FFloat::Set(FASTMATH_ACOS_C3) + Absolute * (FFloat::Set(FASTMATH_ACOS_C4) + Absolute * (FFloat::Set(FASTMATH_ACOS_C5)
+			+ Absolute * (FFloat::Set(FASTMATH_ACOS_C6) + Absolute * FFloat::Set(FASTMATH_ACOS_C7)))))));
+		FFloat Result = FFloat::Sqrt(FFloat::Set(1.0F) - Absolute) * Polynomial;
+		return FFloat::Select(X < FFloat::Set(0.0F), FFloat::Set(PI) - Result, Result);
+	}
+
+private:
+	/** Rounds to the nearest integer (ties to even); exact for values smaller than 2^22 (in absolute value). */
+	template<uint32 N>
+	static SM_INLINE TFloatWide<N> RoundSmall(const TFloatWide<N>& X)
+	{
+		return (X + TFloatWide<N>::Set(FASTMATH_ROUND_MAGIC)) - TFloatWide<N>::Set(FASTMATH_ROUND_MAGIC);
+	}
+};
+
+} // inline namespace SM_SIMD_NAMESPACE
+} // namespace SM
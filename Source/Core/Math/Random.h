@@ -0,0 +1,169 @@
+/**
+ *--------------------------------------------
+ * Random.h <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 18 2022.
+ */
+
+#pragma once
+
+#include "Core/CoreDefines.h"
+#include "Core/CoreTypes.h"
+
+/**
+ * Stateless random numbers, computed by hashing a key. The same key always produces the
+ *   same number, so the result doesn't depend on the order in which the numbers are requested,
+ *   nor on the thread that requests them.
+ * The functions are branchless integer arithmetic, so loops over them are vectorized by the compiler.
+ */
+class FRandom
+{
+public:
+	/** @return A well mixed hash of a 32-bit value ('lowbias32', by Chris Wellons). */
+	static SM_INLINE uint32 Hash(uint32 X)
+	{
+		X ^= X >> 16;
+		X *= 0x7FEB352D;
+		X ^= X >> 15;
+		X *= 0x846CA68B;
+		X ^= X >> 16;
+		return X;
+	}
+
+	/** @return A hash of two values. Not symmetric; swapping the values changes the hash. */
+	static SM_INLINE uint32 Hash(uint32 A, uint32 B)
+	{
+		return Hash(A + Hash(B));
+	}
+
+	/** @return A hash of three values. */
+	static SM_INLINE uint32 Hash(uint32 A, uint32 B, uint32 C)
+	{
+		return Hash(A + Hash(B + Hash(C)));
+	}
+
+	/** @return A float in the range [0, 1), from the top 24 bits of the value. */
+	static SM_INLINE float ToUnitFloat(uint32 Bits)
+	{
+		return (float)(Bits >> 8) * (1.0F / 16777216.0F);
+	}
+
+	/**
+	 * Gets one dimension of a sample, as a uniformly distributed random number.
+	 *
+	 * @param Key The key of the stream; usually identifies a pixel.
+	 * @param SampleIndex The index of the sample, in the stream.
+	 * @param Dimension The dimension of the sample.
+	 *
+	 * @return A float in the range [0, 1).
+	 */
+	static SM_INLINE float GetFloat(uint32 Key, uint32 SampleIndex, uint32 Dimension)
+	{
+		return ToUnitFloat(Hash(Key, SampleIndex, Dimension));
+	}
+};
+
+/**
+ * The PCG32 random number generator ('pcg32_random_r', by Melissa O'Neill). A 64-bit linear
+ *   congruential state, with a permuted 32-bit output.
+ * Every stream is a different sequence, so independent work (per thread, or per task) should use
+ *   independent streams, instead of sharing a generator. Prefer 'FRandom' when the numbers must not
+ *   depend on the order they are requested in.
+ */
+struct FPCG32
+{
+public:
+	SM_INLINE FPCG32()
+	{
+		Seed(0x853C49E6748FEA9BULL, 0xDA3E39CB94B95BDBULL);
+	}
+
+	SM_INLINE FPCG32(uint64 InSeed, uint64 InStream = 0)
+	{
+		Seed(InSeed, InStream);
+	}
+
+	/**
+	 * Starts a sequence.
+	 *
+	 * @param InSeed The starting point in the sequence.
+	 * @param InStream The sequence. Only the lowest 63 bits are used.
+	 */
+	SM_INLINE void Seed(uint64 InSeed, uint64 InStream = 0)
+	{
+		State = 0;
+		Increment = (InStream << 1) | 1;
+		NextUInt32();
+		State += InSeed;
+		NextUInt32();
+	}
+
+	SM_INLINE uint32 NextUInt32()
+	{
+		uint64 OldState = State;
+		State = OldState * PCG32_MULTIPLIER + Increment;
+
+		uint32 XorShifted = (uint32)(((OldState >> 18) ^ OldState) >> 27);
+		uint32 Rotation = (uint32)(OldState >> 59);
+		return (XorShifted >> Rotation) | (XorShifted << ((0 - Rotation) & 31));
+	}
+
+	/** @return A float in the range [0, 1). */
+	SM_INLINE float NextFloat()
+	{
+		return FRandom::ToUnitFloat(NextUInt32());
+	}
+
+	/** @return An unbiased integer in the range [0, Bound). Bound must not be 0. */
+	SM_INLINE uint32 NextBounded(uint32 Bound)
+	{
+		// Lemire's multiply-and-reject method.
+		uint64 Product = (uint64)NextUInt32() * Bound;
+		uint32 Low = (uint32)Product;
+		if (Low < Bound)
+		{
+			uint32 Threshold = (0 - Bound) % Bound;
+			while (Low < Threshold)
+			{
+				Product = (uint64)NextUInt32() * Bound;
+				Low = (uint32)Product;
+			}
+		}
+		return (uint32)(Product >> 32);
+	}
+
+	/**
+	 * Skips numbers of the sequence, in logarithmic time. Lets a stream be split into
+	 *   deterministic chunks, for example one for each task.
+	 *
+	 * @param Delta The number of numbers to skip.
+	 */
+	void Advance(uint64 Delta)
+	{
+		uint64 CurrentMultiplier = PCG32_MULTIPLIER;
+		uint64 CurrentIncrement = Increment;
+		uint64 AccumulatedMultiplier = 1;
+		uint64 AccumulatedIncrement = 0;
+
+		while (Delta > 0)
+		{
+			if (Delta & 1)
+			{
+				AccumulatedMultiplier *= CurrentMultiplier;
+				AccumulatedIncrement = AccumulatedIncrement * CurrentMultiplier + CurrentIncrement;
+			}
+			CurrentIncrement = (CurrentMultiplier + 1) * CurrentIncrement;
+			CurrentMultiplier *= CurrentMultiplier;
+			Delta >>= 1;
+		}
+
+		State = AccumulatedMultiplier * State + AccumulatedIncrement;
+	}
+
+private:
+	static constexpr uint64 PCG32_MULTIPLIER = 6364136223846793005ULL;
+
+	uint64 State;
+	uint64 Increment;
+};
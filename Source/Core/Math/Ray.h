@@ -23,11 +23,13 @@ public:
 	TVector3<T> Direction;
 
 public:
-	TRay();
+	SM_INLINE TRay();
 
-	TRay(const TRay<T>& Other);
+	SM_INLINE TRay(const TRay<T>& Other);
 
-	TRay(const TVector3<T>& Origin, const TVector3<T>& Direction);
+	SM_INLINE TRay(const TVector3<T>& Origin, const TVector3<T>& Direction);
+
+	SM_INLINE TRay<T>& operator=(const TRay<T>& Other);
 };
 
 } // namespace SM
@@ -38,21 +40,29 @@ namespace SM
 {
 
 template<typename T>
-TRay<T>::TRay()
+SM_INLINE TRay<T>::TRay()
 	: Origin(T(0))
 	, Direction(T(0))
 {}
 
 template<typename T>
-TRay<T>::TRay(const TRay<T>& Other)
+SM_INLINE TRay<T>::TRay(const TRay<T>& Other)
 	: Origin(Other.Origin)
 	, Direction(Other.Direction)
 {}
 
 template<typename T>
-TRay<T>::TRay(const TVector3<T>& Origin, const TVector3<T>& Direction)
+SM_INLINE TRay<T>::TRay(const TVector3<T>& Origin, const TVector3<T>& Direction)
 	: Origin(Origin)
 	, Direction(Direction)
 {}
 
+template<typename T>
+SM_INLINE TRay<T>& TRay<T>::operator=(const TRay<T>& Other)
+{
+	Origin = Other.Origin;
+	Direction = Other.Direction;
+	return *this;
+}
+
 } // namespace SM
\ No newline at end of file
@@ -0,0 +1,61 @@
+/**
+ *--------------------------------------------
+ * RayPacket.h <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 10 2022.
+ */
+
+#pragma once
+
+#include "Core/Math/Ray.h"
+#include "Core/Math/SIMD.h"
+
+namespace SM
+{
+inline namespace SM_SIMD_NAMESPACE
+{
+
+/**
+ *---------------------------------------------------------------------------------
+ * 8 rays, traced together. The components are stored as structure-of-arrays, so
+ *   one SIMD operation processes the same component of all rays.
+ * Coherent rays (such as the primary rays of neighbouring pixels) visit mostly the
+ *   same BVH nodes, so the traversal cost is shared between them.
+ *---------------------------------------------------------------------------------
+ */
+struct FRayPacket8
+{
+public:
+	FFloat8 OriginX;
+	FFloat8 OriginY;
+	FFloat8 OriginZ;
+
+	FFloat8 DirectionX;
+	FFloat8 DirectionY;
+	FFloat8 DirectionZ;
+
+	/** The lanes that hold valid rays. The other lanes are never reported as hits. */
+	FMask8  ActiveMask;
+
+public:
+	/** @return The ray stored in the given lane. */
+	SM_INLINE FRay GetRay(uint32 Lane) const
+	{
+		alignas(32) float Components[6][8];
+		OriginX.Store(Components[0]);
+		OriginY.Store(Components[1]);
+		OriginZ.Store(Components[2]);
+		DirectionX.Store(Components[3]);
+		DirectionY.Store(Components[4]);
+		DirectionZ.Store(Components[5]);
+
+		return FRay(FVector3(Components[0][Lane], Components[1][Lane], Components[2][Lane]),
+			FVector3(Components[3][Lane], Components[4][Lane], Components[5][Lane]));
+	}
+};
+
+} // inline namespace SM_SIMD_NAMESPACE
+} // namespace SM
+
+using FRayPacket8 = SM::FRayPacket8;
@@ -0,0 +1,485 @@
+/**
+ *--------------------------------------------
+ * SIMD.h <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 9 2022.
+ */
+
+#pragma once
+
+#include "Core/CoreTypes.h"
+
+/**
+ * The instruction sets the code is compiled for. x86_64 always has SSE2, while AVX2 and AVX-512
+ *   are only used if the compiler is allowed to generate them ('/arch:AVX2', '-mavx2', '/arch:AVX512',
+ *   '-mavx512f' or a '-march' that implies them).
+ * Defining SM_SIMD_DISABLE_AVX2=1 forces the SSE code paths, and SM_SIMD_DISABLE_AVX512=1 forces
+ *   the AVX2 ones.
+ */
+#ifndef SM_SIMD_DISABLE_AVX2
+	#define SM_SIMD_DISABLE_AVX2        0
+#endif // SM_SIMD_DISABLE_AVX2
+
+#ifndef SM_SIMD_DISABLE_AVX512
+	#define SM_SIMD_DISABLE_AVX512      0
+#endif // SM_SIMD_DISABLE_AVX512
+
+#if defined(__AVX2__) && !SM_SIMD_DISABLE_AVX2
+	#define SM_SIMD_AVX2                1
+#else
+	#define SM_SIMD_AVX2                0
+#endif // defined(__AVX2__) && !SM_SIMD_DISABLE_AVX2
+
+#if defined(__AVX512F__) && SM_SIMD_AVX2 && !SM_SIMD_DISABLE_AVX512
+	#define SM_SIMD_AVX512              1
+#else
+	#define SM_SIMD_AVX512              0
+#endif // defined(__AVX512F__) && SM_SIMD_AVX2 && !SM_SIMD_DISABLE_AVX512
+
+#define SM_SIMD_SSE                     1
+
+/**
+ * Whether 'FVector3A' and 'FVector4A' are held in SSE registers. Defining SM_SIMD_DISABLE_VECTORS=1
+ *   makes them plain structs of floats, which compute the same results.
+ */
+#ifndef SM_SIMD_DISABLE_VECTORS
+	#define SM_SIMD_DISABLE_VECTORS     0
+#endif // SM_SIMD_DISABLE_VECTORS
+
+#if SM_SIMD_DISABLE_VECTORS
+	#define SM_SIMD_VECTORS             0
+#else
+	#define SM_SIMD_VECTORS             1
+#endif // SM_SIMD_DISABLE_VECTORS
+
+/**
+ * Whether the lane-wide types ('TFloatWide', 'TMaskWide') use SIMD registers. Defining
+ *   SM_SIMD_DISABLE_WIDE=1 makes every lane a plain float, processed one at a time: the scalar
+ *   reference, which computes the same results (except for 'RSqrt').
+ */
+#ifndef SM_SIMD_DISABLE_WIDE
+	#define SM_SIMD_DISABLE_WIDE        0
+#endif // SM_SIMD_DISABLE_WIDE
+
+/**
+ * The lane-wide types are declared in an inline namespace named after the instruction set, so
+ *   translation units compiled for different instruction sets don't define the same symbols
+ *   differently.
+ */
+#if SM_SIMD_DISABLE_WIDE
+	#define SM_SIMD_NAMESPACE           Scalar
+#elif SM_SIMD_AVX512
+	#define SM_SIMD_NAMESPACE           AVX512
+#elif SM_SIMD_AVX2
+	#define SM_SIMD_NAMESPACE           AVX2
+#else
+	#define SM_SIMD_NAMESPACE           SSE
+#endif // SM_SIMD_DISABLE_WIDE
+
+#include <cmath>
+#include <immintrin.h>
+
+namespace SM
+{
+inline namespace SM_SIMD_NAMESPACE
+{
+
+template<uint32 N>
+struct TFloatWide;
+
+/**
+ *---------------------------------------------------------------------------------
+ * A lane mask for 'TFloatWide<N>'; every lane is either true or false.
+ * Widths without a native register are made of two halves.
+ *---------------------------------------------------------------------------------
+ */
+template<uint32 N>
+struct TMaskWide
+{
+	static_assert((N >= 2) && (N <= 16) && ((N & (N - 1)) == 0), "The lane count must be a power of 2, up to 16.");
+
+	TMaskWide<N / 2> Low;
+	TMaskWide<N / 2> High;
+
+	/** @return A mask with the lanes set where the bits are; lane 0 is the lowest bit. */
+	static SM_INLINE TMaskWide FromBits(uint32 Bits) { return { TMaskWide<N / 2>::FromBits(Bits), TMaskWide<N / 2>::FromBits(Bits >> (N / 2)) }; }
+
+	/** @return A bit for every lane, lane 0 being the lowest bit. */
+	SM_INLINE uint32 GetBits() const { return Low.GetBits() | (High.GetBits() << (N / 2)); }
+
+	SM_INLINE bool Any() const { return GetBits() != 0; }
+	SM_INLINE bool None() const { return GetBits() == 0; }
+	SM_INLINE bool All() const { return GetBits() == ((1U << N) - 1); }
+
+	SM_INLINE TMaskWide operator&(const TMaskWide& Other) const { return { Low & Other.Low, High & Other.High }; }
+	SM_INLINE TMaskWide operator|(const TMaskWide& Other) const { return { Low | Other.Low, High | Other.High }; }
+
+	/** @return This mask's lanes that are not set in the other mask. */
+	SM_INLINE TMaskWide AndNot(const TMaskWide& Other) const { return { Low.AndNot(Other.Low), High.AndNot(Other.High) }; }
+};
+
+/**
+ *---------------------------------------------------------------------------------
+ * N floats, processed together; usually, the same component of N different rays.
+ *   4 lanes are held in an SSE register, 8 lanes in an AVX register (when AVX2 is
+ *   available) and 16 lanes in an AVX-512 register (when AVX-512 is available).
+ *   The other widths are made of two halves, down to single floats.
+ * The operations are the IEEE ones, so the results per lane are the same as the
+ *   scalar code evaluating the same expression in the same order, whatever the
+ *   instruction set. 'RSqrt' is the only approximation.
+ * 'Load' and 'Store' need the memory to be aligned to the size of the type.
+ *---------------------------------------------------------------------------------
+ */
+template<uint32 N>
+struct TFloatWide
+{
+	static_assert((N >= 2) && (N <= 16) && ((N & (N - 1)) == 0), "The lane count must be a power of 2, up to 16.");
+
+	typedef TFloatWide<N / 2> FHalf;
+	typedef TMaskWide<N> FMask;
+
+	FHalf Low;
+	FHalf High;
+
+	static SM_INLINE TFloatWide Set(float Value) { return { FHalf::Set(Value), FHalf::Set(Value) }; }
+	static SM_INLINE TFloatWide Load(const float* Memory) { return { FHalf::Load(Memory), FHalf::Load(Memory + N / 2) }; }
+	static SM_INLINE TFloatWide LoadUnaligned(const float* Memory) { return { FHalf::LoadUnaligned(Memory), FHalf::LoadUnaligned(Memory + N / 2) }; }
+	SM_INLINE void Store(float* Memory) const { Low.Store(Memory); High.Store(Memory + N / 2); }
+	SM_INLINE void StoreUnaligned(float* Memory) const { Low.StoreUnaligned(Memory); High.StoreUnaligned(Memory + N / 2); }
+
+	SM_INLINE TFloatWide operator+(const TFloatWide& Other) const { return { Low + Other.Low, High + Other.High }; }
+	SM_INLINE TFloatWide operator-(const TFloatWide& Other) const { return { Low - Other.Low, High - Other.High }; }
+	SM_INLINE TFloatWide operator*(const TFloatWide& Other) const { return { Low * Other.Low, High * Other.High }; }
+	SM_INLINE TFloatWide operator/(const TFloatWide& Other) const { return { Low / Other.Low, High / Other.High }; }
+	SM_INLINE TFloatWide operator-() const { return { -Low, -High }; }
+
+	SM_INLINE FMask operator<(const TFloatWide& Other) const { return { Low < Other.Low, High < Other.High }; }
+	SM_INLINE FMask operator<=(const TFloatWide& Other) const { return { Low <= Other.Low, High <= Other.High }; }
+	SM_INLINE FMask operator>(const TFloatWide& Other) const { return { Low > Other.Low, High > Other.High }; }
+	SM_INLINE FMask operator>=(const TFloatWide& Other) const { return { Low >= Other.Low, High >= Other.High }; }
+
+	/** Same as 'FMath::Min', lane-wise; (A < B) ? A : B. */
+	static SM_INLINE TFloatWide Min(const TFloatWide& A, const TFloatWide& B) { return { FHalf::Min(A.Low, B.Low), FHalf::Min(A.High, B.High) }; }
+
+	/** Same as 'FMath::Max', lane-wise; (A > B) ? A : B. */
+	static SM_INLINE TFloatWide Max(const TFloatWide& A, const TFloatWide& B) { return { FHalf::Max(A.Low, B.Low), FHalf::Max(A.High, B.High) }; }
+
+	static SM_INLINE TFloatWide Sqrt(const TFloatWide& X) { return { FHalf::Sqrt(X.Low), FHalf::Sqrt(X.High) }; }
+	static SM_INLINE TFloatWide Abs(const TFloatWide& X) { return { FHalf::Abs(X.Low), FHalf::Abs(X.High) }; }
+
+	/**
+	 * An approximation of 1 / Sqrt(X), refined with a Newton-Raphson step (about 22 bits of precision).
+	 *   The results depend on the instruction set.
+	 */
+	static SM_INLINE TFloatWide RSqrt(const TFloatWide& X) { return { FHalf::RSqrt(X.Low), FHalf::RSqrt(X.High) }; }
+
+	/** @return For every lane, the value from 'A' if the mask is set, or the value from 'B' otherwise. */
+	static SM_INLINE TFloatWide Select(const FMask& Mask, const TFloatWide& A, const TFloatWide& B) { return { FHalf::Select(Mask.Low, A.Low, B.Low), FHalf::Select(Mask.High, A.High, B.High) }; }
+
+	/**
+	 * The horizontal reductions fold the upper half of the lanes onto the lower half, until one lane
+	 *   is left. Every instruction set sums in this order, so the results are the same.
+	 */
+	SM_INLINE float ReduceAdd() const { return (Low + High).ReduceAdd(); }
+	SM_INLINE float ReduceMin() const { return FHalf::Min(Low, High).ReduceMin(); }
+	SM_INLINE float ReduceMax() const { return FHalf::Max(Low, High).ReduceMax(); }
+};
+
+/** A single lane; the leaf of the scalar reference. */
+template<>
+struct TMaskWide<1>
+{
+	bool V;
+
+	static SM_INLINE TMaskWide FromBits(uint32 Bits) { return { (Bits & 1) != 0 }; }
+	SM_INLINE uint32 GetBits() const { return V ? 1 : 0; }
+
+	SM_INLINE bool Any() const { return V; }
+	SM_INLINE bool None() const { return !V; }
+	SM_INLINE bool All() const { return V; }
+
+	SM_INLINE TMaskWide operator&(const TMaskWide& Other) const { return { V && Other.V }; }
+	SM_INLINE TMaskWide operator|(const TMaskWide& Other) const { return { V || Other.V }; }
+	SM_INLINE TMaskWide AndNot(const TMaskWide& Other) const { return { V && !Other.V }; }
+};
+
+template<>
+struct TFloatWide<1>
+{
+	typedef TMaskWide<1> FMask;
+
+	float V;
+
+	static SM_INLINE TFloatWide Set(float Value) { return { Value }; }
+	static SM_INLINE TFloatWide Load(const float* Memory) { return { *Memory }; }
+	static SM_INLINE TFloatWide LoadUnaligned(const float* Memory) { return { *Memory }; }
+	SM_INLINE void Store(float* Memory) const { *Memory = V; }
+	SM_INLINE void StoreUnaligned(float* Memory) const { *Memory = V; }
+
+	SM_INLINE TFloatWide operator+(const TFloatWide& Other) const { return { V + Other.V }; }
+	SM_INLINE TFloatWide operator-(const TFloatWide& Other) const { return { V - Other.V }; }
+	SM_INLINE TFloatWide operator*(const TFloatWide& Other) const { return { V * Other.V }; }
+	SM_INLINE TFloatWide operator/(const TFloatWide& Other) const { return { V / Other.V }; }
+	SM_INLINE TFloatWide operator-() const { return { -V }; }
+
+	SM_INLINE FMask operator<(const TFloatWide& Other) const { return { V < Other.V }; }
+	SM_INLINE FMask operator<=(const TFloatWide& Other) const { return { V <= Other.V }; }
+	SM_INLINE FMask operator>(const TFloatWide& Other) const { return { V > Other.V }; }
+	SM_INLINE FMask operator>=(const TFloatWide& Other) const { return { V >= Other.V }; }
+
+	static SM_INLINE TFloatWide Min(const TFloatWide& A, const TFloatWide& B) { return { (A.V < B.V) ? A.V : B.V }; }
+	static SM_INLINE TFloatWide Max(const TFloatWide& A, const TFloatWide& B) { return { (A.V > B.V) ? A.V : B.V }; }
+	static SM_INLINE TFloatWide Sqrt(const TFloatWide& X) { return { std::sqrt(X.V) }; }
+	static SM_INLINE TFloatWide Abs(const TFloatWide& X) { return { std::fabs(X.V) }; }
+
+	/** The scalar reference is exact. */
+	static SM_INLINE TFloatWide RSqrt(const TFloatWide& X) { return { 1.0F / Sqrt(X).V }; }
+
+	static SM_INLINE TFloatWide Select(const FMask& Mask, const TFloatWide& A, const TFloatWide& B) { return { Mask.V ? A.V : B.V }; }
+
+	SM_INLINE float ReduceAdd() const { return V; }
+	SM_INLINE float ReduceMin() const { return V; }
+	SM_INLINE float ReduceMax() const { return V; }
+};
+
+#if !SM_SIMD_DISABLE_WIDE
+
+/** Refines an approximation of 1 / Sqrt(X) with a Newton-Raphson step: Y * (1.5 - 0.5 * X * Y * Y). */
+#define SM_SIMD_RSQRT_REFINE(Type, X, Y) \
+	(Type::Set(0.5F) * (Y) * (Type::Set(3.0F) - (X) * (Y) * (Y)))
+
+template<>
+struct TMaskWide<4>
+{
+	__m128 V;
+
+	static SM_INLINE TMaskWide FromBits(uint32 Bits)
+	{
+		__m128i Lanes = _mm_and_si128(_mm_set1_epi32((int32)Bits), _mm_setr_epi32(1, 2, 4, 8));
+		return { _mm_castsi128_ps(_mm_cmpgt_epi32(Lanes, _mm_setzero_si128())) };
+	}
+
+	SM_INLINE uint32 GetBits() const { return (uint32)_mm_movemask_ps(V); }
+
+	SM_INLINE bool Any() const { return GetBits() != 0; }
+	SM_INLINE bool None() const { return GetBits() == 0; }
+	SM_INLINE bool All() const { return GetBits() == 0xF; }
+
+	SM_INLINE TMaskWide operator&(const TMaskWide& Other) const { return { _mm_and_ps(V, Other.V) }; }
+	SM_INLINE TMaskWide operator|(const TMaskWide& Other) const { return { _mm_or_ps(V, Other.V) }; }
+	SM_INLINE TMaskWide AndNot(const TMaskWide& Other) const { return { _mm_andnot_ps(Other.V, V) }; }
+};
+
+template<>
+struct TFloatWide<4>
+{
+	typedef TMaskWide<4> FMask;
+
+	__m128 V;
+
+	static SM_INLINE TFloatWide Set(float Value) { return { _mm_set1_ps(Value) }; }
+	static SM_INLINE TFloatWide Load(const float* Memory) { return { _mm_load_ps(Memory) }; }
+	static SM_INLINE TFloatWide LoadUnaligned(const float* Memory) { return { _mm_loadu_ps(Memory) }; }
+	SM_INLINE void Store(float* Memory) const { _mm_store_ps(Memory, V); }
+	SM_INLINE void StoreUnaligned(float* Memory) const { _mm_storeu_ps(Memory, V); }
+
+	SM_INLINE TFloatWide operator+(const TFloatWide& Other) const { return { _mm_add_ps(V, Other.V) }; }
+	SM_INLINE TFloatWide operator-(const TFloatWide& Other) const { return { _mm_sub_ps(V, Other.V) }; }
+	SM_INLINE TFloatWide operator*(const TFloatWide& Other) const { return { _mm_mul_ps(V, Other.V) }; }
+	SM_INLINE TFloatWide operator/(const TFloatWide& Other) const { return { _mm_div_ps(V, Other.V) }; }
+	SM_INLINE TFloatWide operator-() const { return { _mm_xor_ps(V, _mm_set1_ps(-0.0F)) }; }
+
+	SM_INLINE FMask operator<(const TFloatWide& Other) const { return { _mm_cmplt_ps(V, Other.V) }; }
+	SM_INLINE FMask operator<=(const TFloatWide& Other) const { return { _mm_cmple_ps(V, Other.V) }; }
+	SM_INLINE FMask operator>(const TFloatWide& Other) const { return { _mm_cmpgt_ps(V, Other.V) }; }
+	SM_INLINE FMask operator>=(const TFloatWide& Other) const { return { _mm_cmpge_ps(V, Other.V) }; }
+
+	// 'minps' and 'maxps' return the second operand when the comparison fails, same as 'FMath::Min' and 'FMath::Max'.
+	static SM_INLINE TFloatWide Min(const TFloatWide& A, const TFloatWide& B) { return { _mm_min_ps(A.V, B.V) }; }
+	static SM_INLINE TFloatWide Max(const TFloatWide& A, const TFloatWide& B) { return { _mm_max_ps(A.V, B.V) }; }
+	static SM_INLINE TFloatWide Sqrt(const TFloatWide& X) { return { _mm_sqrt_ps(X.V) }; }
+	static SM_INLINE TFloatWide Abs(const TFloatWide& X) { return { _mm_andnot_ps(_mm_set1_ps(-0.0F), X.V) }; }
+
+	static SM_INLINE TFloatWide RSqrt(const TFloatWide& X)
+	{
+		TFloatWide Estimate = { _mm_rsqrt_ps(X.V) };
+		return SM_SIMD_RSQRT_REFINE(TFloatWide, X, Estimate);
+	}
+
+	static SM_INLINE TFloatWide Select(const FMask& Mask, const TFloatWide& A, const TFloatWide& B)
+	{
+		return { _mm_or_ps(_mm_and_ps(Mask.V, A.V), _mm_andnot_ps(Mask.V, B.V)) };
+	}
+
+	SM_INLINE float ReduceAdd() const
+	{
+		__m128 Folded = _mm_add_ps(V, _mm_movehl_ps(V, V));
+		return _mm_cvtss_f32(_mm_add_ss(Folded, _mm_shuffle_ps(Folded, Folded, _MM_SHUFFLE(1, 1, 1, 1))));
+	}
+
+	SM_INLINE float ReduceMin() const
+	{
+		__m128 Folded = _mm_min_ps(V, _mm_movehl_ps(V, V));
+		return _mm_cvtss_f32(_mm_min_ss(Folded, _mm_shuffle_ps(Folded, Folded, _MM_SHUFFLE(1, 1, 1, 1))));
+	}
+
+	SM_INLINE float ReduceMax() const
+	{
+		__m128 Folded = _mm_max_ps(V, _mm_movehl_ps(V, V));
+		return _mm_cvtss_f32(_mm_max_ss(Folded, _mm_shuffle_ps(Folded, Folded, _MM_SHUFFLE(1, 1, 1, 1))));
+	}
+};
+
+#if SM_SIMD_AVX2
+
+template<>
+struct TMaskWide<8>
+{
+	__m256 V;
+
+	static SM_INLINE TMaskWide FromBits(uint32 Bits)
+	{
+		__m256i Lanes = _mm256_and_si256(_mm256_set1_epi32((int32)Bits), _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128));
+		return { _mm256_castsi256_ps(_mm256_cmpgt_epi32(Lanes, _mm256_setzero_si256())) };
+	}
+
+	SM_INLINE uint32 GetBits() const { return (uint32)_mm256_movemask_ps(V); }
+
+	SM_INLINE bool Any() const { return GetBits() != 0; }
+	SM_INLINE bool None() const { return GetBits() == 0; }
+	SM_INLINE bool All() const { return GetBits() == 0xFF; }
+
+	SM_INLINE TMaskWide operator&(const TMaskWide& Other) const { return { _mm256_and_ps(V, Other.V) }; }
+	SM_INLINE TMaskWide operator|(const TMaskWide& Other) const { return { _mm256_or_ps(V, Other.V) }; }
+	SM_INLINE TMaskWide AndNot(const TMaskWide& Other) const { return { _mm256_andnot_ps(Other.V, V) }; }
+};
+
+template<>
+struct TFloatWide<8>
+{
+	typedef TMaskWide<8> FMask;
+
+	__m256 V;
+
+	static SM_INLINE TFloatWide Set(float Value) { return { _mm256_set1_ps(Value) }; }
+	static SM_INLINE TFloatWide Load(const float* Memory) { return { _mm256_load_ps(Memory) }; }
+	static SM_INLINE TFloatWide LoadUnaligned(const float* Memory) { return { _mm256_loadu_ps(Memory) }; }
+	SM_INLINE void Store(float* Memory) const { _mm256_store_ps(Memory, V); }
+	SM_INLINE void StoreUnaligned(float* Memory) const { _mm256_storeu_ps(Memory, V); }
+
+	SM_INLINE TFloatWide operator+(const TFloatWide& Other) const { return { _mm256_add_ps(V, Other.V) }; }
+	SM_INLINE TFloatWide operator-(const TFloatWide& Other) const { return { _mm256_sub_ps(V, Other.V) }; }
+	SM_INLINE TFloatWide operator*(const TFloatWide& Other) const { return { _mm256_mul_ps(V, Other.V) }; }
+	SM_INLINE TFloatWide operator/(const TFloatWide& Other) const { return { _mm256_div_ps(V, Other.V) }; }
+	SM_INLINE TFloatWide operator-() const { return { _mm256_xor_ps(V, _mm256_set1_ps(-0.0F)) }; }
+
+	SM_INLINE FMask operator<(const TFloatWide& Other) const { return { _mm256_cmp_ps(V, Other.V, _CMP_LT_OQ) }; }
+	SM_INLINE FMask operator<=(const TFloatWide& Other) const { return { _mm256_cmp_ps(V, Other.V, _CMP_LE_OQ) }; }
+	SM_INLINE FMask operator>(const TFloatWide& Other) const { return { _mm256_cmp_ps(V, Other.V, _CMP_GT_OQ) }; }
+	SM_INLINE FMask operator>=(const TFloatWide& Other) const { return { _mm256_cmp_ps(V, Other.V, _CMP_GE_OQ) }; }
+
+	static SM_INLINE TFloatWide Min(const TFloatWide& A, const TFloatWide& B) { return { _mm256_min_ps(A.V, B.V) }; }
+	static SM_INLINE TFloatWide Max(const TFloatWide& A, const TFloatWide& B) { return { _mm256_max_ps(A.V, B.V) }; }
+	static SM_INLINE TFloatWide Sqrt(const TFloatWide& X) { return { _mm256_sqrt_ps(X.V) }; }
+	static SM_INLINE TFloatWide Abs(const TFloatWide& X) { return { _mm256_andnot_ps(_mm256_set1_ps(-0.0F), X.V) }; }
+
+	static SM_INLINE TFloatWide RSqrt(const TFloatWide& X)
+	{
+		TFloatWide Estimate = { _mm256_rsqrt_ps(X.V) };
+		return SM_SIMD_RSQRT_REFINE(TFloatWide, X, Estimate);
+	}
+
+	static SM_INLINE TFloatWide Select(const FMask& Mask, const TFloatWide& A, const TFloatWide& B) { return { _mm256_blendv_ps(B.V, A.V, Mask.V) }; }
+
+	SM_INLINE TFloatWide<4> GetLow() const { return { _mm256_castps256_ps128(V) }; }
+	SM_INLINE TFloatWide<4> GetHigh() const { return { _mm256_extractf128_ps(V, 1) }; }
+
+	SM_INLINE float ReduceAdd() const { return (GetLow() + GetHigh()).ReduceAdd(); }
+	SM_INLINE float ReduceMin() const { return TFloatWide<4>::Min(GetLow(), GetHigh()).ReduceMin(); }
+	SM_INLINE float ReduceMax() const { return TFloatWide<4>::Max(GetLow(), GetHigh()).ReduceMax(); }
+};
+
+#endif // SM_SIMD_AVX2
+
+#if SM_SIMD_AVX512
+
+/** The AVX-512 comparisons write to mask registers, so the mask is a bit for every lane. */
+template<>
+struct TMaskWide<16>
+{
+	__mmask16 V;
+
+	static SM_INLINE TMaskWide FromBits(uint32 Bits) { return { (__mmask16)Bits }; }
+	SM_INLINE uint32 GetBits() const { return (uint32)V; }
+
+	SM_INLINE bool Any() const { return V != 0; }
+	SM_INLINE bool None() const { return V == 0; }
+	SM_INLINE bool All() const { return V == 0xFFFF; }
+
+	SM_INLINE TMaskWide operator&(const TMaskWide& Other) const { return { (__mmask16)(V & Other.V) }; }
+	SM_INLINE TMaskWide operator|(const TMaskWide& Other) const { return { (__mmask16)(V | Other.V) }; }
+	SM_INLINE TMaskWide AndNot(const TMaskWide& Other) const { return { (__mmask16)(V & ~Other.V) }; }
+};
+
+template<>
+struct TFloatWide<16>
+{
+	typedef TMaskWide<16> FMask;
+
+	__m512 V;
+
+	static SM_INLINE TFloatWide Set(float Value) { return { _mm512_set1_ps(Value) }; }
+	static SM_INLINE TFloatWide Load(const float* Memory) { return { _mm512_load_ps(Memory) }; }
+	static SM_INLINE TFloatWide LoadUnaligned(const float* Memory) { return { _mm512_loadu_ps(Memory) }; }
+	SM_INLINE void Store(float* Memory) const { _mm512_store_ps(Memory, V); }
+	SM_INLINE void StoreUnaligned(float* Memory) const { _mm512_storeu_ps(Memory, V); }
+
+	SM_INLINE TFloatWide operator+(const TFloatWide& Other) const { return { _mm512_add_ps(V, Other.V) }; }
+	SM_INLINE TFloatWide operator-(const TFloatWide& Other) const { return { _mm512_sub_ps(V, Other.V) }; }
+	SM_INLINE TFloatWide operator*(const TFloatWide& Other) const { return { _mm512_mul_ps(V, Other.V) }; }
+	SM_INLINE TFloatWide operator/(const TFloatWide& Other) const { return { _mm512_div_ps(V, Other.V) }; }
+
+	// The floating point bitwise operations need AVX-512DQ, while the integer ones only need AVX-512F.
+	SM_INLINE TFloatWide operator-() const { return { _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(V), _mm512_set1_epi32((int32)0x80000000))) }; }
+
+	SM_INLINE FMask operator<(const TFloatWide& Other) const { return { _mm512_cmp_ps_mask(V, Other.V, _CMP_LT_OQ) }; }
+	SM_INLINE FMask operator<=(const TFloatWide& Other) const { return { _mm512_cmp_ps_mask(V, Other.V, _CMP_LE_OQ) }; }
+	SM_INLINE FMask operator>(const TFloatWide& Other) const { return { _mm512_cmp_ps_mask(V, Other.V, _CMP_GT_OQ) }; }
+	SM_INLINE FMask operator>=(const TFloatWide& Other) const { return { _mm512_cmp_ps_mask(V, Other.V, _CMP_GE_OQ) }; }
+
+	static SM_INLINE TFloatWide Min(const TFloatWide& A, const TFloatWide& B) { return { _mm512_min_ps(A.V, B.V) }; }
+	static SM_INLINE TFloatWide Max(const TFloatWide& A, const TFloatWide& B) { return { _mm512_max_ps(A.V, B.V) }; }
+	static SM_INLINE TFloatWide Sqrt(const TFloatWide& X) { return { _mm512_sqrt_ps(X.V) }; }
+	static SM_INLINE TFloatWide Abs(const TFloatWide& X) { return { _mm512_abs_ps(X.V) }; }
+
+	static SM_INLINE TFloatWide RSqrt(const TFloatWide& X)
+	{
+		TFloatWide Estimate = { _mm512_rsqrt14_ps(X.V) };
+		return SM_SIMD_RSQRT_REFINE(TFloatWide, X, Estimate);
+	}
+
+	static SM_INLINE TFloatWide Select(const FMask& Mask, const TFloatWide& A, const TFloatWide& B) { return { _mm512_mask_blend_ps(Mask.V, B.V, A.V) }; }
+
+	SM_INLINE TFloatWide<8> GetLow() const { return { _mm512_castps512_ps256(V) }; }
+	SM_INLINE TFloatWide<8> GetHigh() const { return { _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(V), 1)) }; }
+
+	SM_INLINE float ReduceAdd() const { return (GetLow() + GetHigh()).ReduceAdd(); }
+	SM_INLINE float ReduceMin() const { return TFloatWide<8>::Min(GetLow(), GetHigh()).ReduceMin(); }
+	SM_INLINE float ReduceMax() const { return TFloatWide<8>::Max(GetLow(), GetHigh()).ReduceMax(); }
+};
+
+#endif // SM_SIMD_AVX512
+
+#undef SM_SIMD_RSQRT_REFINE
+
+#endif // !SM_SIMD_DISABLE_WIDE
+
+} // inline namespace SM_SIMD_NAMESPACE
+} // namespace SM
+
+/** 8 floats, processed together. Used by the ray packets. @see 'TFloatWide<N>'. */
+using FFloat8 = SM::TFloatWide<8>;
+
+/** A lane mask for 'FFloat8'. @see 'TMaskWide<N>'. */
+using FMask8 = SM::TMaskWide<8>;
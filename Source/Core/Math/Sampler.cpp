@@ -0,0 +1,175 @@
+/**
+ *--------------------------------------------
+ * Sampler.cpp <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 18 2022.
+ */
+
+#include "Sampler.h"
+
+#include "Core/Memory/Memory.h"
+
+#include <cmath>
+#include <cstring>
+
+/** The standard deviation (in pixels) of the Gaussian filter that measures how clustered the mask's pixels are. */
+#define BLUE_NOISE_FILTER_SIGMA 1.5F
+
+/** The fraction of the pixels set in the initial binary pattern. */
+#define BLUE_NOISE_INITIAL_DENSITY 0.1F
+
+float FSampler::BlueNoiseMask[BLUE_NOISE_MASK_SIZE * BLUE_NOISE_MASK_SIZE];
+
+/**
+ * The state of the void-and-cluster algorithm: a binary pattern over the (toroidal) mask, and the
+ *   energy of every pixel, which is the sum of the Gaussian filter of every set pixel.
+ */
+struct FBlueNoisePattern
+{
+	bool*  bSet;
+	float* Energy;
+
+	/** The filter, indexed by the (wrapped) offset between two pixels. */
+	const float* Filter;
+
+	void Toggle(uint32 PixelIndex, bool bValue)
+	{
+		bSet[PixelIndex] = bValue;
+		float Sign = bValue ? 1.0F : -1.0F;
+
+		uint32 PixelX = PixelIndex % BLUE_NOISE_MASK_SIZE;
+		uint32 PixelY = PixelIndex / BLUE_NOISE_MASK_SIZE;
+		for (uint32 Y = 0; Y < BLUE_NOISE_MASK_SIZE; ++Y)
+		{
+			const float* FilterRow = Filter + ((Y - PixelY) & (BLUE_NOISE_MASK_SIZE - 1)) * BLUE_NOISE_MASK_SIZE;
+			float* EnergyRow = Energy + Y * BLUE_NOISE_MASK_SIZE;
+			for (uint32 X = 0; X < BLUE_NOISE_MASK_SIZE; ++X)
+			{
+				EnergyRow[X] += Sign * FilterRow[(X - PixelX) & (BLUE_NOISE_MASK_SIZE - 1)];
+			}
+		}
+	}
+
+	/** @return The set pixel with the highest energy. */
+	uint32 FindTightestCluster() const
+	{
+		uint32 Result = 0;
+		float MaxEnergy = -1.0F;
+		for (uint32 Index = 0; Index < BLUE_NOISE_MASK_SIZE * BLUE_NOISE_MASK_SIZE; ++Index)
+		{
+			if (bSet[Index] && Energy[Index] > MaxEnergy)
+			{
+				MaxEnergy = Energy[Index];
+				Result = Index;
+			}
+		}
+		return Result;
+	}
+
+	/** @return The cleared pixel with the lowest energy. */
+	uint32 FindLargestVoid() const
+	{
+		uint32 Result = 0;
+		float MinEnergy = BIG_NUMBER;
+		for (uint32 Index = 0; Index < BLUE_NOISE_MASK_SIZE * BLUE_NOISE_MASK_SIZE; ++Index)
+		{
+			if (!bSet[Index] && Energy[Index] < MinEnergy)
+			{
+				MinEnergy = Energy[Index];
+				Result = Index;
+			}
+		}
+		return Result;
+	}
+};
+
+/**
+ * Generates a blue-noise mask with the void-and-cluster algorithm (Ulichney, 1993). Every pixel gets
+ *   a rank, in the order in which it's added to a progressively denser, evenly spread pattern.
+ */
+internal void GenerateBlueNoiseMask(float* Mask)
+{
+	constexpr uint32 PixelCount = BLUE_NOISE_MASK_SIZE * BLUE_NOISE_MASK_SIZE;
+
+	FMemoryArena& Scratch = FMemory::GetScratchArena();
+	FScopedTemporaryMemory TemporaryMemory(Scratch);
+
+	float* Filter = Scratch.PushArray<float>(PixelCount);
+	for (uint32 Y = 0; Y < BLUE_NOISE_MASK_SIZE; ++Y)
+	{
+		for (uint32 X = 0; X < BLUE_NOISE_MASK_SIZE; ++X)
+		{
+			float DistanceX = (float)FMath::Min(X, BLUE_NOISE_MASK_SIZE - X);
+			float DistanceY = (float)FMath::Min(Y, BLUE_NOISE_MASK_SIZE - Y);
+			float DistanceSquared = DistanceX * DistanceX + DistanceY * DistanceY;
+			Filter[Y * BLUE_NOISE_MASK_SIZE + X] = expf(-DistanceSquared / (2.0F * BLUE_NOISE_FILTER_SIGMA * BLUE_NOISE_FILTER_SIGMA));
+		}
+	}
+
+	FBlueNoisePattern Pattern;
+	Pattern.bSet = Scratch.PushArrayZero<bool>(PixelCount);
+	Pattern.Energy = Scratch.PushArrayZero<float>(PixelCount);
+	Pattern.Filter = Filter;
+
+	uint32* Ranks = Scratch.PushArray<uint32>(PixelCount);
+
+	// Start from a random pattern, and move the pixels from the tightest clusters to the largest voids until it's evenly spread.
+	const uint32 InitialCount = (uint32)(PixelCount * BLUE_NOISE_INITIAL_DENSITY);
+	FPCG32 Random(BLUE_NOISE_MASK_SIZE);
+	for (uint32 SetCount = 0; SetCount < InitialCount;)
+	{
+		uint32 Index = Random.NextBounded(PixelCount);
+		if (!Pattern.bSet[Index])
+		{
+			Pattern.Toggle(Index, true);
+			++SetCount;
+		}
+	}
+
+	for (;;)
+	{
+		uint32 Cluster = Pattern.FindTightestCluster();
+		Pattern.Toggle(Cluster, false);
+
+		uint32 Void = Pattern.FindLargestVoid();
+		Pattern.Toggle(Void, true);
+
+		if (Void == Cluster)
+		{
+			break;
+		}
+	}
+
+	// Rank the initial pixels by removing them from the tightest clusters, so the pattern stays evenly spread at every rank.
+	FBlueNoisePattern InitialPattern = Pattern;
+	InitialPattern.bSet = Scratch.PushArray<bool>(PixelCount);
+	InitialPattern.Energy = Scratch.PushArray<float>(PixelCount);
+	memcpy(InitialPattern.bSet, Pattern.bSet, PixelCount * sizeof(bool));
+	memcpy(InitialPattern.Energy, Pattern.Energy, PixelCount * sizeof(float));
+
+	for (uint32 Rank = InitialCount; Rank > 0; --Rank)
+	{
+		uint32 Cluster = InitialPattern.FindTightestCluster();
+		InitialPattern.Toggle(Cluster, false);
+		Ranks[Cluster] = Rank - 1;
+	}
+
+	// Rank the rest of the pixels by filling the largest voids.
+	for (uint32 Rank = InitialCount; Rank < PixelCount; ++Rank)
+	{
+		uint32 Void = Pattern.FindLargestVoid();
+		Pattern.Toggle(Void, true);
+		Ranks[Void] = Rank;
+	}
+
+	for (uint32 Index = 0; Index < PixelCount; ++Index)
+	{
+		Mask[Index] = ((float)Ranks[Index] + 0.5F) / (float)PixelCount;
+	}
+}
+
+void FSampler::Initialize()
+{
+	GenerateBlueNoiseMask(BlueNoiseMask);
+}
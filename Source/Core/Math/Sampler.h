@@ -0,0 +1,206 @@
+/**
+ *--------------------------------------------
+ * Sampler.h <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 18 2022.
+ */
+
+#pragma once
+
+#include "Random.h"
+#include "Vector2.h"
+
+/** The width and height (in pixels) of the blue-noise mask, which is tiled across the image. */
+#define BLUE_NOISE_MASK_SIZE 64
+
+enum class ESamplerType : uint8
+{
+	/** Independent random numbers. The error is white noise, converging as 1/sqrt(N). */
+	Random,
+
+	/**
+	 * A shuffled, Owen-scrambled Sobol sequence, different in every pixel. The samples of a pixel are
+	 *   stratified, so the error converges faster than with random numbers.
+	 */
+	Sobol,
+
+	/**
+	 * The same Sobol sequence in every pixel, rotated by a blue-noise mask. The error is distributed as
+	 *   blue noise across the image (high frequency), which looks smoother at low sample counts.
+	 */
+	BlueNoise,
+};
+
+/**
+ * Generates the sample points of pixels. Every point is computed from (pixel, sample index,
+ *   dimension) without any state, so the images don't depend on the order in which the pixels
+ *   are rendered, nor on the number of threads.
+ * The dimensions of a sample are consumed by the caller, in any order: a 2D point uses the
+ *   dimensions 'Dimension' and 'Dimension + 1'. Every dimension (or pair) is scrambled
+ *   independently, so they aren't correlated.
+ */
+class FSampler
+{
+public:
+	/** Generates the blue-noise mask. Until then, the blue-noise sampler is the unrotated Sobol sequence. */
+	static void Initialize();
+
+	/** @return One dimension of a sample of a pixel, in the range [0, 1). */
+	static SM_INLINE float Get1D(ESamplerType Type, uint32 PixelX, uint32 PixelY, uint32 SampleIndex, uint32 Dimension);
+
+	/** @return Two dimensions of a sample of a pixel, in the range [0, 1) on both axes. */
+	static SM_INLINE FVector2 Get2D(ESamplerType Type, uint32 PixelX, uint32 PixelY, uint32 SampleIndex, uint32 Dimension);
+
+public:
+	/** @return The point of a 2D Sobol sequence, with the index shuffled and the coordinates Owen-scrambled by the seed. */
+	static SM_INLINE FVector2 GetScrambledSobol2D(uint32 SampleIndex, uint32 Seed);
+
+	/** @return The point of a 1D Sobol sequence (van der Corput), with the index shuffled and the coordinate Owen-scrambled by the seed. */
+	static SM_INLINE float GetScrambledSobol1D(uint32 SampleIndex, uint32 Seed);
+
+	/**
+	 * Gets a value of the blue-noise mask. Neighboring pixels have values that are far apart, and every
+	 *   value in [0, 1) is equally likely. Different channels are differently offset views of the mask.
+	 */
+	static SM_INLINE float GetBlueNoise(uint32 PixelX, uint32 PixelY, uint32 Channel);
+
+private:
+	/** @return The bits of the value, in reverse order. */
+	static SM_INLINE uint32 ReverseBits(uint32 X);
+
+	/**
+	 * A hash that only propagates bits upwards, so the higher bits are permuted based on the lower ones
+	 *   (Laine-Karras permutation, with the constants of Nathan Vegdahl).
+	 */
+	static SM_INLINE uint32 LaineKarrasPermutation(uint32 X, uint32 Seed);
+
+	/** @return The value, Owen-scrambled (nested uniform scrambling of all its bits, from the highest). */
+	static SM_INLINE uint32 NestedUniformScramble(uint32 X, uint32 Seed);
+
+	/** @return The second dimension of the Sobol sequence, as a 32-bit fixed point fraction. */
+	static SM_INLINE uint32 Sobol1(uint32 Index);
+
+	static SM_INLINE float ToUnitFloat(uint32 Bits) { return FRandom::ToUnitFloat(Bits); }
+
+	static SM_INLINE uint32 GetPixelSeed(uint32 PixelX, uint32 PixelY) { return FRandom::Hash(PixelX, PixelY); }
+
+private:
+	static float BlueNoiseMask[BLUE_NOISE_MASK_SIZE * BLUE_NOISE_MASK_SIZE];
+};
+
+SM_INLINE float FSampler::Get1D(ESamplerType Type, uint32 PixelX, uint32 PixelY, uint32 SampleIndex, uint32 Dimension)
+{
+	switch (Type)
+	{
+		case ESamplerType::Sobol:
+		{
+			return GetScrambledSobol1D(SampleIndex, FRandom::Hash(GetPixelSeed(PixelX, PixelY), Dimension));
+		}
+
+		case ESamplerType::BlueNoise:
+		{
+			float Value = GetScrambledSobol1D(SampleIndex, FRandom::Hash(Dimension)) + GetBlueNoise(PixelX, PixelY, Dimension);
+			return Value < 1.0F ? Value : Value - 1.0F;
+		}
+
+		default:
+		{
+			return FRandom::GetFloat(GetPixelSeed(PixelX, PixelY), SampleIndex, Dimension);
+		}
+	}
+}
+
+SM_INLINE FVector2 FSampler::Get2D(ESamplerType Type, uint32 PixelX, uint32 PixelY, uint32 SampleIndex, uint32 Dimension)
+{
+	switch (Type)
+	{
+		case ESamplerType::Sobol:
+		{
+			return GetScrambledSobol2D(SampleIndex, FRandom::Hash(GetPixelSeed(PixelX, PixelY), Dimension));
+		}
+
+		case ESamplerType::BlueNoise:
+		{
+			// Cranley-Patterson rotation, by the blue-noise mask.
+			FVector2 Point = GetScrambledSobol2D(SampleIndex, FRandom::Hash(Dimension));
+			Point.X += GetBlueNoise(PixelX, PixelY, Dimension);
+			Point.Y += GetBlueNoise(PixelX, PixelY, Dimension + 1);
+			Point.X = Point.X < 1.0F ? Point.X : Point.X - 1.0F;
+			Point.Y = Point.Y < 1.0F ? Point.Y : Point.Y - 1.0F;
+			return Point;
+		}
+
+		default:
+		{
+			uint32 PixelSeed = GetPixelSeed(PixelX, PixelY);
+			return FVector2(FRandom::GetFloat(PixelSeed, SampleIndex, Dimension), FRandom::GetFloat(PixelSeed, SampleIndex, Dimension + 1));
+		}
+	}
+}
+
+SM_INLINE FVector2 FSampler::GetScrambledSobol2D(uint32 SampleIndex, uint32 Seed)
+{
+	// Shuffling the index makes the prefixes of the sequence independent between seeds (Burley, 2020).
+	uint32 Index = NestedUniformScramble(SampleIndex, Seed);
+	uint32 X = ReverseBits(Index);
+	uint32 Y = Sobol1(Index);
+
+	uint32 DimensionSeed = FRandom::Hash(Seed);
+	X = NestedUniformScramble(X, DimensionSeed);
+	Y = NestedUniformScramble(Y, FRandom::Hash(DimensionSeed));
+	return FVector2(ToUnitFloat(X), ToUnitFloat(Y));
+}
+
+SM_INLINE float FSampler::GetScrambledSobol1D(uint32 SampleIndex, uint32 Seed)
+{
+	uint32 Index = NestedUniformScramble(SampleIndex, Seed);
+	return ToUnitFloat(NestedUniformScramble(ReverseBits(Index), FRandom::Hash(Seed)));
+}
+
+SM_INLINE float FSampler::GetBlueNoise(uint32 PixelX, uint32 PixelY, uint32 Channel)
+{
+	// Every channel views the mask with a different toroidal offset.
+	uint32 Offset = FRandom::Hash(Channel);
+	uint32 X = (PixelX + Offset) & (BLUE_NOISE_MASK_SIZE - 1);
+	uint32 Y = (PixelY + (Offset >> 16)) & (BLUE_NOISE_MASK_SIZE - 1);
+	return BlueNoiseMask[Y * BLUE_NOISE_MASK_SIZE + X];
+}
+
+SM_INLINE uint32 FSampler::ReverseBits(uint32 X)
+{
+	X = ((X >> 1) & 0x55555555) | ((X & 0x55555555) << 1);
+	X = ((X >> 2) & 0x33333333) | ((X & 0x33333333) << 2);
+	X = ((X >> 4) & 0x0F0F0F0F) | ((X & 0x0F0F0F0F) << 4);
+	X = ((X >> 8) & 0x00FF00FF) | ((X & 0x00FF00FF) << 8);
+	return (X >> 16) | (X << 16);
+}
+
+SM_INLINE uint32 FSampler::LaineKarrasPermutation(uint32 X, uint32 Seed)
+{
+	X ^= X * 0x3D20ADEA;
+	X += Seed;
+	X *= (Seed >> 16) | 1;
+	X ^= X * 0x05526C56;
+	X ^= X * 0x53A22864;
+	return X;
+}
+
+SM_INLINE uint32 FSampler::NestedUniformScramble(uint32 X, uint32 Seed)
+{
+	return ReverseBits(LaineKarrasPermutation(ReverseBits(X), Seed));
+}
+
+SM_INLINE uint32 FSampler::Sobol1(uint32 Index)
+{
+	// The generator matrix of the second dimension is the Pascal triangle, modulo 2.
+	uint32 Result = 0;
+	for (uint32 Direction = 1U << 31; Index; Index >>= 1, Direction ^= Direction >> 1)
+	{
+		if (Index & 1)
+		{
+			Result ^= Direction;
+		}
+	}
+	return Result;
+}
@@ -190,6 +190,24 @@ public:
 	 */
 	SM_INLINE TVector3<T>& operator*=(T Scalar);
 
+	/**
+	 * Multiplication operator. Multiplies two vectors, component-wise.
+	 *
+	 * @param Other The vector to multiply.
+	 *
+	 * @return The result of the multiplication.
+	 */
+	SM_INLINE TVector3<T> operator*(const TVector3<T>& Other) const;
+
+	/**
+	 * Multiplication operator. Multiplies this with a vector, component-wise.
+	 *
+	 * @param Other The vector to multiply.
+	 *
+	 * @return A reference to this, after the multiplication.
+	 */
+	SM_INLINE TVector3<T>& operator*=(const TVector3<T>& Other);
+
 	/**
 	 * 
 	 */
@@ -421,6 +439,21 @@ SM_INLINE TVector3<T>& TVector3<T>::operator*=(T Scalar)
 	return *this;
 }
 
+template<typename T>
+SM_INLINE TVector3<T> TVector3<T>::operator*(const TVector3<T>& Other) const
+{
+	return TVector3<T>(X * Other.X, Y * Other.Y, Z * Other.Z);
+}
+
+template<typename T>
+SM_INLINE TVector3<T>& TVector3<T>::operator*=(const TVector3<T>& Other)
+{
+	X *= Other.X;
+	Y *= Other.Y;
+	Z *= Other.Z;
+	return *this;
+}
+
 template<typename T>
 SM_INLINE TVector3<T> TVector3<T>::operator-() const
 {
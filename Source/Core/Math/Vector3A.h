@@ -0,0 +1,266 @@
+/**
+ *--------------------------------------------
+ * Vector3A.h <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 27 2022.
+ */
+
+#pragma once
+
+#include "Core/Math/SIMD.h"
+#include "Core/Math/Vector3.h"
+
+/**
+ *---------------------------------------------------------------------------------
+ * A 3-component vector of floats, aligned to 16 bytes and held in a single SSE
+ *   register, with the same interface as 'FVector3'. The fourth lane (W) is
+ *   padding: it is ignored by the operations that combine the components, and
+ *   its value is unspecified.
+ * It is meant for the arithmetic of the hot paths (normals, directions), while
+ *   'FVector3' stays the storage type. The operations are evaluated in the same
+ *   order as the 'FVector3' ones, so the results are identical.
+ * When SM_SIMD_VECTORS is 0, it is a plain struct of floats.
+ *---------------------------------------------------------------------------------
+ */
+struct alignas(16) FVector3A
+{
+public:
+#if SM_SIMD_VECTORS
+	union
+	{
+		__m128 V;
+		struct
+		{
+			float X;
+			float Y;
+			float Z;
+			float W;
+		};
+	};
+#else
+	float X;
+	float Y;
+	float Z;
+	float W;
+#endif // SM_SIMD_VECTORS
+
+public:
+	/** Initializes all components with 0. */
+	SM_INLINE FVector3A();
+
+	SM_INLINE FVector3A(float InX, float InY, float InZ);
+
+	/** Initializes all components with the same value. */
+	SM_INLINE explicit FVector3A(float Scalar);
+
+	SM_INLINE explicit FVector3A(const FVector3& Vector);
+
+#if SM_SIMD_VECTORS
+	SM_INLINE explicit FVector3A(__m128 InV) : V(InV) {}
+#endif // SM_SIMD_VECTORS
+
+	/** @return The vector, as a storage vector. */
+	SM_INLINE FVector3 ToVector3() const { return FVector3(X, Y, Z); }
+
+public:
+	SM_INLINE FVector3A operator+(const FVector3A& Other) const;
+	SM_INLINE FVector3A& operator+=(const FVector3A& Other);
+	SM_INLINE FVector3A operator-(const FVector3A& Other) const;
+	SM_INLINE FVector3A& operator-=(const FVector3A& Other);
+	SM_INLINE FVector3A operator*(float Scalar) const;
+	SM_INLINE FVector3A& operator*=(float Scalar);
+
+	/** Multiplies two vectors, component-wise. */
+	SM_INLINE FVector3A operator*(const FVector3A& Other) const;
+	SM_INLINE FVector3A& operator*=(const FVector3A& Other);
+	SM_INLINE FVector3A operator-() const;
+
+public:
+	/** @return The square of the vector's length. */
+	SM_INLINE float LengthSquared() const;
+
+	/** @return The vector's length. */
+	SM_INLINE float Length() const;
+
+	SM_INLINE static float DotProduct(const FVector3A& A, const FVector3A& B);
+	SM_INLINE float Dot(const FVector3A& Other) const { return DotProduct(*this, Other); }
+	SM_INLINE float operator|(const FVector3A& Other) const { return DotProduct(*this, Other); }
+
+	SM_INLINE static FVector3A CrossProduct(const FVector3A& A, const FVector3A& B);
+	SM_INLINE FVector3A Cross(const FVector3A& Other) const { return CrossProduct(*this, Other); }
+	SM_INLINE FVector3A operator^(const FVector3A& Other) const { return CrossProduct(*this, Other); }
+	SM_INLINE FVector3A& operator^=(const FVector3A& Other) { (*this) = CrossProduct(*this, Other); return *this; }
+
+	/** @see 'TVector3<T>::IsNormalized'. */
+	SM_INLINE bool IsNormalized(float Tolerance = KINDA_SMALL_NUMBER) const;
+
+	/** @return A vector with the same direction as this, but unit length. */
+	SM_INLINE FVector3A GetNormal() const;
+
+	/** @see 'TVector3<T>::GetNormalIf'. */
+	SM_INLINE FVector3A GetNormalIf(float Tolerance = KINDA_SMALL_NUMBER) const;
+
+	/** @see 'TVector3<T>::GetSafeNormal'. */
+	SM_INLINE FVector3A GetSafeNormal(float Threshold, const FVector3A& ResultIfError) const;
+
+	/** @see 'TVector3<T>::GetSafeNormalIf'. */
+	SM_INLINE FVector3A GetSafeNormalIf(float Threshold, const FVector3A& ResultIfError, float Tolerance) const;
+
+private:
+	/** @return This, scaled by the inverse of the square root of its squared length. */
+	SM_INLINE FVector3A ScaleByInverseSqrt(float SquaredLength) const;
+
+#if SM_SIMD_VECTORS
+	/** @return The dot product of the X, Y and Z lanes, in the lowest lane. Summed as (X + Y) + Z, like the scalar code. */
+	SM_INLINE static __m128 DotProductLanes(__m128 A, __m128 B);
+#endif // SM_SIMD_VECTORS
+};
+
+SM_INLINE FVector3A operator*(float Scalar, const FVector3A& Vector)
+{
+	return Vector * Scalar;
+}
+
+#if SM_SIMD_VECTORS
+
+SM_INLINE FVector3A::FVector3A() : V(_mm_setzero_ps()) {}
+SM_INLINE FVector3A::FVector3A(float InX, float InY, float InZ) : V(_mm_setr_ps(InX, InY, InZ, 0.0F)) {}
+SM_INLINE FVector3A::FVector3A(float Scalar) : V(_mm_set1_ps(Scalar)) {}
+SM_INLINE FVector3A::FVector3A(const FVector3& Vector) : V(_mm_setr_ps(Vector.X, Vector.Y, Vector.Z, 0.0F)) {}
+
+SM_INLINE FVector3A FVector3A::operator+(const FVector3A& Other) const { return FVector3A(_mm_add_ps(V, Other.V)); }
+SM_INLINE FVector3A& FVector3A::operator+=(const FVector3A& Other) { V = _mm_add_ps(V, Other.V); return *this; }
+SM_INLINE FVector3A FVector3A::operator-(const FVector3A& Other) const { return FVector3A(_mm_sub_ps(V, Other.V)); }
+SM_INLINE FVector3A& FVector3A::operator-=(const FVector3A& Other) { V = _mm_sub_ps(V, Other.V); return *this; }
+SM_INLINE FVector3A FVector3A::operator*(float Scalar) const { return FVector3A(_mm_mul_ps(V, _mm_set1_ps(Scalar))); }
+SM_INLINE FVector3A& FVector3A::operator*=(float Scalar) { V = _mm_mul_ps(V, _mm_set1_ps(Scalar)); return *this; }
+SM_INLINE FVector3A FVector3A::operator*(const FVector3A& Other) const { return FVector3A(_mm_mul_ps(V, Other.V)); }
+SM_INLINE FVector3A& FVector3A::operator*=(const FVector3A& Other) { V = _mm_mul_ps(V, Other.V); return *this; }
+SM_INLINE FVector3A FVector3A::operator-() const { return FVector3A(_mm_xor_ps(V, _mm_set1_ps(-0.0F))); }
+
+SM_INLINE __m128 FVector3A::DotProductLanes(__m128 A, __m128 B)
+{
+	__m128 Products = _mm_mul_ps(A, B);
+	__m128 ProductY = _mm_shuffle_ps(Products, Products, _MM_SHUFFLE(1, 1, 1, 1));
+	__m128 ProductZ = _mm_shuffle_ps(Products, Products, _MM_SHUFFLE(2, 2, 2, 2));
+	return _mm_add_ss(_mm_add_ss(Products, ProductY), ProductZ);
+}
+
+SM_INLINE float FVector3A::LengthSquared() const
+{
+	return _mm_cvtss_f32(DotProductLanes(V, V));
+}
+
+SM_INLINE float FVector3A::Length() const
+{
+	return _mm_cvtss_f32(_mm_sqrt_ss(DotProductLanes(V, V)));
+}
+
+SM_INLINE float FVector3A::DotProduct(const FVector3A& A, const FVector3A& B)
+{
+	return _mm_cvtss_f32(DotProductLanes(A.V, B.V));
+}
+
+SM_INLINE FVector3A FVector3A::CrossProduct(const FVector3A& A, const FVector3A& B)
+{
+	__m128 AYZX = _mm_shuffle_ps(A.V, A.V, _MM_SHUFFLE(3, 0, 2, 1));
+	__m128 AZXY = _mm_shuffle_ps(A.V, A.V, _MM_SHUFFLE(3, 1, 0, 2));
+	__m128 BYZX = _mm_shuffle_ps(B.V, B.V, _MM_SHUFFLE(3, 0, 2, 1));
+	__m128 BZXY = _mm_shuffle_ps(B.V, B.V, _MM_SHUFFLE(3, 1, 0, 2));
+	return FVector3A(_mm_sub_ps(_mm_mul_ps(AYZX, BZXY), _mm_mul_ps(AZXY, BYZX)));
+}
+
+SM_INLINE FVector3A FVector3A::ScaleByInverseSqrt(float SquaredLength) const
+{
+	__m128 InvLength = _mm_div_ss(_mm_set_ss(1.0F), _mm_sqrt_ss(_mm_set_ss(SquaredLength)));
+	return FVector3A(_mm_mul_ps(V, _mm_shuffle_ps(InvLength, InvLength, _MM_SHUFFLE(0, 0, 0, 0))));
+}
+
+#else
+
+SM_INLINE FVector3A::FVector3A() : X(0.0F), Y(0.0F), Z(0.0F), W(0.0F) {}
+SM_INLINE FVector3A::FVector3A(float InX, float InY, float InZ) : X(InX), Y(InY), Z(InZ), W(0.0F) {}
+SM_INLINE FVector3A::FVector3A(float Scalar) : X(Scalar), Y(Scalar), Z(Scalar), W(Scalar) {}
+SM_INLINE FVector3A::FVector3A(const FVector3& Vector) : X(Vector.X), Y(Vector.Y), Z(Vector.Z), W(0.0F) {}
+
+SM_INLINE FVector3A FVector3A::operator+(const FVector3A& Other) const { return FVector3A(X + Other.X, Y + Other.Y, Z + Other.Z); }
+SM_INLINE FVector3A& FVector3A::operator+=(const FVector3A& Other) { X += Other.X; Y += Other.Y; Z += Other.Z; return *this; }
+SM_INLINE FVector3A FVector3A::operator-(const FVector3A& Other) const { return FVector3A(X - Other.X, Y - Other.Y, Z - Other.Z); }
+SM_INLINE FVector3A& FVector3A::operator-=(const FVector3A& Other) { X -= Other.X; Y -= Other.Y; Z -= Other.Z; return *this; }
+SM_INLINE FVector3A FVector3A::operator*(float Scalar) const { return FVector3A(X * Scalar, Y * Scalar, Z * Scalar); }
+SM_INLINE FVector3A& FVector3A::operator*=(float Scalar) { X *= Scalar; Y *= Scalar; Z *= Scalar; return *this; }
+SM_INLINE FVector3A FVector3A::operator*(const FVector3A& Other) const { return FVector3A(X * Other.X, Y * Other.Y, Z * Other.Z); }
+SM_INLINE FVector3A& FVector3A::operator*=(const FVector3A& Other) { X *= Other.X; Y *= Other.Y; Z *= Other.Z; return *this; }
+SM_INLINE FVector3A FVector3A::operator-() const { return FVector3A(-X, -Y, -Z); }
+
+SM_INLINE float FVector3A::LengthSquared() const
+{
+	return (X * X) + (Y * Y) + (Z * Z);
+}
+
+SM_INLINE float FVector3A::Length() const
+{
+	return FMath::Sqrt(LengthSquared());
+}
+
+SM_INLINE float FVector3A::DotProduct(const FVector3A& A, const FVector3A& B)
+{
+	return (A.X * B.X) + (A.Y * B.Y) + (A.Z * B.Z);
+}
+
+SM_INLINE FVector3A FVector3A::CrossProduct(const FVector3A& A, const FVector3A& B)
+{
+	return FVector3A(A.Y * B.Z - A.Z * B.Y, A.Z * B.X - A.X * B.Z, A.X * B.Y - A.Y * B.X);
+}
+
+SM_INLINE FVector3A FVector3A::ScaleByInverseSqrt(float SquaredLength) const
+{
+	return (*this) * (1.0F / FMath::Sqrt(SquaredLength));
+}
+
+#endif // SM_SIMD_VECTORS
+
+SM_INLINE bool FVector3A::IsNormalized(float Tolerance) const
+{
+	return FMath::Abs(LengthSquared() - 1.0F) <= Tolerance;
+}
+
+SM_INLINE FVector3A FVector3A::GetNormal() const
+{
+	return ScaleByInverseSqrt(LengthSquared());
+}
+
+SM_INLINE FVector3A FVector3A::GetNormalIf(float Tolerance) const
+{
+	float SquaredLength = LengthSquared();
+	if (FMath::Abs(SquaredLength - 1.0F) > Tolerance)
+	{
+		return ScaleByInverseSqrt(SquaredLength);
+	}
+	return (*this);
+}
+
+SM_INLINE FVector3A FVector3A::GetSafeNormal(float Threshold, const FVector3A& ResultIfError) const
+{
+	float SquaredLength = LengthSquared();
+	if (SquaredLength >= Threshold)
+	{
+		return ScaleByInverseSqrt(SquaredLength);
+	}
+	return ResultIfError;
+}
+
+SM_INLINE FVector3A FVector3A::GetSafeNormalIf(float Threshold, const FVector3A& ResultIfError, float Tolerance) const
+{
+	float SquaredLength = LengthSquared();
+	if (FMath::Abs(SquaredLength - 1.0F) > Tolerance)
+	{
+		if (SquaredLength >= Threshold)
+		{
+			return ScaleByInverseSqrt(SquaredLength);
+		}
+		return ResultIfError;
+	}
+	return (*this);
+}
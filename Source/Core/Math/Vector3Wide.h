@@ -0,0 +1,108 @@
+/**
+ *--------------------------------------------
+ * Vector3Wide.h <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 28 2022.
+ */
+
+#pragma once
+
+#include "Core/Math/SIMD.h"
+#include "Core/Math/Vector3.h"
+
+namespace SM
+{
+inline namespace SM_SIMD_NAMESPACE
+{
+
+/**
+ *---------------------------------------------------------------------------------
+ * N 3-component vectors, processed together (such as the directions of N rays).
+ *   The components are stored as structure-of-arrays, so every operation works on
+ *   the same component of all vectors at once.
+ * The operations are evaluated in the same order as the 'TVector3' ones, so every
+ *   lane gets the same result as the scalar code.
+ *---------------------------------------------------------------------------------
+ */
+template<uint32 N>
+struct TVector3Wide
+{
+public:
+	typedef TFloatWide<N> FFloat;
+	typedef TMaskWide<N> FMask;
+
+	FFloat X;
+	FFloat Y;
+	FFloat Z;
+
+public:
+	/** @return A vector with the same value in every lane. */
+	static SM_INLINE TVector3Wide Set(const FVector3& Vector) { return { FFloat::Set(Vector.X), FFloat::Set(Vector.Y), FFloat::Set(Vector.Z) }; }
+
+	/** Loads the components from three arrays, aligned like the ones of 'TFloatWide<N>::Load'. */
+	static SM_INLINE TVector3Wide Load(const float* InX, const float* InY, const float* InZ) { return { FFloat::Load(InX), FFloat::Load(InY), FFloat::Load(InZ) }; }
+
+	SM_INLINE void Store(float* OutX, float* OutY, float* OutZ) const
+	{
+		X.Store(OutX);
+		Y.Store(OutY);
+		Z.Store(OutZ);
+	}
+
+	/** @return The vector stored in the given lane. Meant for the code that leaves the wide path; it goes through memory. */
+	SM_INLINE FVector3 GetLane(uint32 Lane) const
+	{
+		alignas(sizeof(FFloat)) float Components[3][N];
+		Store(Components[0], Components[1], Components[2]);
+		return FVector3(Components[0][Lane], Components[1][Lane], Components[2][Lane]);
+	}
+
+public:
+	SM_INLINE TVector3Wide operator+(const TVector3Wide& Other) const { return { X + Other.X, Y + Other.Y, Z + Other.Z }; }
+	SM_INLINE TVector3Wide operator-(const TVector3Wide& Other) const { return { X - Other.X, Y - Other.Y, Z - Other.Z }; }
+	SM_INLINE TVector3Wide operator*(const FFloat& Scalar) const { return { X * Scalar, Y * Scalar, Z * Scalar }; }
+
+	/** Multiplies two vectors, component-wise. */
+	SM_INLINE TVector3Wide operator*(const TVector3Wide& Other) const { return { X * Other.X, Y * Other.Y, Z * Other.Z }; }
+	SM_INLINE TVector3Wide operator-() const { return { -X, -Y, -Z }; }
+
+public:
+	/** @return The square of every vector's length. */
+	SM_INLINE FFloat LengthSquared() const { return DotProduct(*this, *this); }
+
+	/** @return Every vector's length. */
+	SM_INLINE FFloat Length() const { return FFloat::Sqrt(LengthSquared()); }
+
+	static SM_INLINE FFloat DotProduct(const TVector3Wide& A, const TVector3Wide& B) { return (A.X * B.X + A.Y * B.Y) + A.Z * B.Z; }
+
+	static SM_INLINE TVector3Wide CrossProduct(const TVector3Wide& A, const TVector3Wide& B)
+	{
+		return { A.Y * B.Z - A.Z * B.Y, A.Z * B.X - A.X * B.Z, A.X * B.Y - A.Y * B.X };
+	}
+
+	/** @return The vectors with unit length. Same as 'TVector3<T>::GetNormal', per lane. */
+	SM_INLINE TVector3Wide GetNormal() const { return (*this) * (FFloat::Set(1.0F) / Length()); }
+
+	/** @return The vectors with (nearly) unit length, using 'TFloatWide<N>::RSqrt'. The results depend on the instruction set. */
+	SM_INLINE TVector3Wide GetNormalFast() const { return (*this) * FFloat::RSqrt(LengthSquared()); }
+
+public:
+	/** @return For every lane, the vector from 'A' if the mask is set, or the vector from 'B' otherwise. */
+	static SM_INLINE TVector3Wide Select(const FMask& Mask, const TVector3Wide& A, const TVector3Wide& B)
+	{
+		return { FFloat::Select(Mask, A.X, B.X), FFloat::Select(Mask, A.Y, B.Y), FFloat::Select(Mask, A.Z, B.Z) };
+	}
+
+	/** Component-wise 'TFloatWide<N>::Min'. */
+	static SM_INLINE TVector3Wide Min(const TVector3Wide& A, const TVector3Wide& B) { return { FFloat::Min(A.X, B.X), FFloat::Min(A.Y, B.Y), FFloat::Min(A.Z, B.Z) }; }
+
+	/** Component-wise 'TFloatWide<N>::Max'. */
+	static SM_INLINE TVector3Wide Max(const TVector3Wide& A, const TVector3Wide& B) { return { FFloat::Max(A.X, B.X), FFloat::Max(A.Y, B.Y), FFloat::Max(A.Z, B.Z) }; }
+};
+
+} // inline namespace SM_SIMD_NAMESPACE
+} // namespace SM
+
+/** 8 vectors, processed together. Used by the ray packets. @see 'TVector3Wide<N>'. */
+using FVector3Wide8 = SM::TVector3Wide<8>;
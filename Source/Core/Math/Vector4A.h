@@ -0,0 +1,132 @@
+/**
+ *--------------------------------------------
+ * Vector4A.h <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 27 2022.
+ */
+
+#pragma once
+
+#include "Core/Math/SIMD.h"
+#include "Core/Math/Vector4.h"
+#include "Core/Math/Vector3A.h"
+
+/**
+ *---------------------------------------------------------------------------------
+ * A 4-component vector of floats, aligned to 16 bytes and held in a single SSE
+ *   register, with the same interface as 'FVector4'. The results are identical
+ *   to the 'FVector4' ones.
+ * When SM_SIMD_VECTORS is 0, it is a plain struct of floats.
+ *---------------------------------------------------------------------------------
+ */
+struct alignas(16) FVector4A
+{
+public:
+#if SM_SIMD_VECTORS
+	union
+	{
+		__m128 V;
+		struct
+		{
+			float X;
+			float Y;
+			float Z;
+			float W;
+		};
+	};
+#else
+	float X;
+	float Y;
+	float Z;
+	float W;
+#endif // SM_SIMD_VECTORS
+
+public:
+	/** Initializes all components with 0. */
+	SM_INLINE FVector4A();
+
+	SM_INLINE FVector4A(float InX, float InY, float InZ, float InW);
+
+	/** Initializes all components with the same value. */
+	SM_INLINE explicit FVector4A(float Scalar);
+
+	SM_INLINE explicit FVector4A(const FVector4& Vector);
+
+	/** Uses the X, Y and Z components of the 3-component vector, and a separate value for the W component. */
+	SM_INLINE FVector4A(const FVector3A& Vector3, float InW);
+
+#if SM_SIMD_VECTORS
+	SM_INLINE explicit FVector4A(__m128 InV) : V(InV) {}
+#endif // SM_SIMD_VECTORS
+
+	/** @return The vector, as a storage vector. */
+	SM_INLINE FVector4 ToVector4() const { return FVector4(X, Y, Z, W); }
+
+	/** Writes the vector to a storage vector. */
+	SM_INLINE void Store(FVector4& Vector) const;
+
+public:
+	SM_INLINE FVector4A operator+(const FVector4A& Other) const;
+	SM_INLINE FVector4A& operator+=(const FVector4A& Other);
+	SM_INLINE FVector4A operator-(const FVector4A& Other) const;
+	SM_INLINE FVector4A& operator-=(const FVector4A& Other);
+	SM_INLINE FVector4A operator*(float Scalar) const;
+	SM_INLINE FVector4A& operator*=(float Scalar);
+
+public:
+	/** Same as 'FVector4::Clamp'; every component is clamped with 'FMath::Clamp'. */
+	SM_INLINE static FVector4A Clamp(const FVector4A& X, const FVector4A& Min, const FVector4A& Max);
+};
+
+SM_INLINE FVector4A operator*(float Scalar, const FVector4A& Vector)
+{
+	return Vector * Scalar;
+}
+
+#if SM_SIMD_VECTORS
+
+SM_INLINE FVector4A::FVector4A() : V(_mm_setzero_ps()) {}
+SM_INLINE FVector4A::FVector4A(float InX, float InY, float InZ, float InW) : V(_mm_setr_ps(InX, InY, InZ, InW)) {}
+SM_INLINE FVector4A::FVector4A(float Scalar) : V(_mm_set1_ps(Scalar)) {}
+SM_INLINE FVector4A::FVector4A(const FVector4& Vector) : V(_mm_loadu_ps(&Vector.X)) {}
+SM_INLINE FVector4A::FVector4A(const FVector3A& Vector3, float InW) : V(Vector3.V) { W = InW; }
+
+SM_INLINE void FVector4A::Store(FVector4& Vector) const { _mm_storeu_ps(&Vector.X, V); }
+
+SM_INLINE FVector4A FVector4A::operator+(const FVector4A& Other) const { return FVector4A(_mm_add_ps(V, Other.V)); }
+SM_INLINE FVector4A& FVector4A::operator+=(const FVector4A& Other) { V = _mm_add_ps(V, Other.V); return *this; }
+SM_INLINE FVector4A FVector4A::operator-(const FVector4A& Other) const { return FVector4A(_mm_sub_ps(V, Other.V)); }
+SM_INLINE FVector4A& FVector4A::operator-=(const FVector4A& Other) { V = _mm_sub_ps(V, Other.V); return *this; }
+SM_INLINE FVector4A FVector4A::operator*(float Scalar) const { return FVector4A(_mm_mul_ps(V, _mm_set1_ps(Scalar))); }
+SM_INLINE FVector4A& FVector4A::operator*=(float Scalar) { V = _mm_mul_ps(V, _mm_set1_ps(Scalar)); return *this; }
+
+SM_INLINE FVector4A FVector4A::Clamp(const FVector4A& X, const FVector4A& Min, const FVector4A& Max)
+{
+	// 'FMath::Clamp' is Min(Max, Max(Min, X)); the operands are in the same order, so NaNs are handled the same way.
+	return FVector4A(_mm_min_ps(Max.V, _mm_max_ps(Min.V, X.V)));
+}
+
+#else
+
+SM_INLINE FVector4A::FVector4A() : X(0.0F), Y(0.0F), Z(0.0F), W(0.0F) {}
+SM_INLINE FVector4A::FVector4A(float InX, float InY, float InZ, float InW) : X(InX), Y(InY), Z(InZ), W(InW) {}
+SM_INLINE FVector4A::FVector4A(float Scalar) : X(Scalar), Y(Scalar), Z(Scalar), W(Scalar) {}
+SM_INLINE FVector4A::FVector4A(const FVector4& Vector) : X(Vector.X), Y(Vector.Y), Z(Vector.Z), W(Vector.W) {}
+SM_INLINE FVector4A::FVector4A(const FVector3A& Vector3, float InW) : X(Vector3.X), Y(Vector3.Y), Z(Vector3.Z), W(InW) {}
+
+SM_INLINE void FVector4A::Store(FVector4& Vector) const { Vector = FVector4(X, Y, Z, W); }
+
+SM_INLINE FVector4A FVector4A::operator+(const FVector4A& Other) const { return FVector4A(X + Other.X, Y + Other.Y, Z + Other.Z, W + Other.W); }
+SM_INLINE FVector4A& FVector4A::operator+=(const FVector4A& Other) { X += Other.X; Y += Other.Y; Z += Other.Z; W += Other.W; return *this; }
+SM_INLINE FVector4A FVector4A::operator-(const FVector4A& Other) const { return FVector4A(X - Other.X, Y - Other.Y, Z - Other.Z, W - Other.W); }
+SM_INLINE FVector4A& FVector4A::operator-=(const FVector4A& Other) { X -= Other.X; Y -= Other.Y; Z -= Other.Z; W -= Other.W; return *this; }
+SM_INLINE FVector4A FVector4A::operator*(float Scalar) const { return FVector4A(X * Scalar, Y * Scalar, Z * Scalar, W * Scalar); }
+SM_INLINE FVector4A& FVector4A::operator*=(float Scalar) { X *= Scalar; Y *= Scalar; Z *= Scalar; W *= Scalar; return *this; }
+
+SM_INLINE FVector4A FVector4A::Clamp(const FVector4A& X, const FVector4A& Min, const FVector4A& Max)
+{
+	return FVector4A(FMath::Clamp(X.X, Min.X, Max.X), FMath::Clamp(X.Y, Min.Y, Max.Y), FMath::Clamp(X.Z, Min.Z, Max.Z), FMath::Clamp(X.W, Min.W, Max.W));
+}
+
+#endif // SM_SIMD_VECTORS
@@ -0,0 +1,86 @@
+/**
+ *--------------------------------------------
+ * Memory.cpp <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 14 2022.
+ */
+
+#include "Memory.h"
+
+#include "Core/Jobs/JobSystem.h"
+#include "Core/Math/MathUtilities.h"
+
+/** The minimum size of the blocks of the persistent arena. The image and the meshes usually get blocks of their own. */
+#define PERSISTENT_ARENA_BLOCK_SIZE (16 * 1024 * 1024)
+
+#define FRAME_ARENA_BLOCK_SIZE      (4 * 1024 * 1024)
+#define SCRATCH_ARENA_BLOCK_SIZE    (1024 * 1024)
+
+internal FMemoryArena  GPersistentArena;
+internal FMemoryArena  GFrameArena;
+internal FMemoryArena* GScratchArenas = nullptr;
+internal uint32        GScratchArenaCount = 0;
+
+void FMemory::Initialize()
+{
+	GPersistentArena.Initialize("Persistent", PERSISTENT_ARENA_BLOCK_SIZE);
+	GFrameArena.Initialize("Frame", FRAME_ARENA_BLOCK_SIZE);
+
+	GScratchArenaCount = FMath::Max(FJobSystem::GetThreadCount(), 1U);
+	GScratchArenas = new FMemoryArena[GScratchArenaCount];
+	for (uint32 ArenaIndex = 0; ArenaIndex < GScratchArenaCount; ++ArenaIndex)
+	{
+		GScratchArenas[ArenaIndex].Initialize("Scratch", SCRATCH_ARENA_BLOCK_SIZE);
+	}
+}
+
+void FMemory::Shutdown()
+{
+	for (uint32 ArenaIndex = 0; ArenaIndex < GScratchArenaCount; ++ArenaIndex)
+	{
+		GScratchArenas[ArenaIndex].Release();
+	}
+	delete[] GScratchArenas;
+	GScratchArenas = nullptr;
+	GScratchArenaCount = 0;
+
+	GFrameArena.Release();
+	GPersistentArena.Release();
+}
+
+FMemoryArena& FMemory::GetPersistentArena()
+{
+	return GPersistentArena;
+}
+
+FMemoryArena& FMemory::GetFrameArena()
+{
+	return GFrameArena;
+}
+
+FMemoryArena& FMemory::GetScratchArena()
+{
+	uint32 ThreadIndex = FJobSystem::GetCurrentThreadIndex();
+	return GScratchArenas[(ThreadIndex < GScratchArenaCount) ? ThreadIndex : 0];
+}
+
+void FMemory::BeginFrame()
+{
+	GFrameArena.Reset();
+}
+
+FMemoryArenaStats FMemory::GetScratchStats()
+{
+	FMemoryArenaStats Result = {};
+	for (uint32 ArenaIndex = 0; ArenaIndex < GScratchArenaCount; ++ArenaIndex)
+	{
+		const FMemoryArenaStats& Stats = GScratchArenas[ArenaIndex].GetStats();
+		Result.ReservedSize += Stats.ReservedSize;
+		Result.UsedSize += Stats.UsedSize;
+		Result.PeakUsedSize = FMath::Max(Result.PeakUsedSize, Stats.PeakUsedSize);
+		Result.BlockCount += Stats.BlockCount;
+		Result.PushCount += Stats.PushCount;
+	}
+	return Result;
+}
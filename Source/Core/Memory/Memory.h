@@ -0,0 +1,46 @@
+/**
+ *--------------------------------------------
+ * Memory.h <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 14 2022.
+ */
+
+#pragma once
+
+#include "MemoryArena.h"
+
+/**
+ *---------------------------------------------------------------------------------
+ * The global memory arenas.
+ *   - The persistent arena holds what lives until shutdown (such as the image and
+ *     the loaded meshes). It is only used by the main thread.
+ *   - The frame arena holds what lives for one frame, and is reset when a new one
+ *     begins. It is only used by the main thread.
+ *   - Every job system thread has its own scratch arena, for short-lived memory.
+ *     It must always be used with temporary memory, so it is empty between uses.
+ * Must be initialized after the job system, as it creates one scratch arena per
+ *   job system thread.
+ *---------------------------------------------------------------------------------
+ */
+class FMemory
+{
+public:
+	static void Initialize();
+	static void Shutdown();
+
+	static FMemoryArena& GetPersistentArena();
+	static FMemoryArena& GetFrameArena();
+
+	/**
+	 * @return The scratch arena of the calling thread. Threads unknown to the job system get the
+	 *   arena of the main thread, so they must not use it at the same time as the main thread.
+	 */
+	static FMemoryArena& GetScratchArena();
+
+	/** Frees everything allocated from the frame arena. */
+	static void BeginFrame();
+
+	/** @return The statistics of all scratch arenas, added together. The peak is the highest peak of any arena. */
+	static FMemoryArenaStats GetScratchStats();
+};
@@ -0,0 +1,141 @@
+/**
+ *--------------------------------------------
+ * MemoryArena.cpp <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 14 2022.
+ */
+
+#include "MemoryArena.h"
+
+#include "Core/Math/MathUtilities.h"
+
+#include <cstdlib>
+#include <cstring>
+
+/** @return The start of the usable memory of a block. */
+internal SM_INLINE uint8* GetBlockMemory(FMemoryArenaBlock* Block)
+{
+	return (uint8*)(Block + 1);
+}
+
+/** @return The number of bytes to skip so that the next push in the block is aligned. */
+internal SM_INLINE uint64 GetAlignmentPadding(FMemoryArenaBlock* Block, uint64 Alignment)
+{
+	uintptr_t Address = (uintptr_t)(GetBlockMemory(Block) + Block->Used);
+	return (uint64)((Alignment - (Address & (Alignment - 1))) & (Alignment - 1));
+}
+
+void FMemoryArena::Initialize(const char* InName, uint64 InBlockSize)
+{
+	Release();
+	Name = InName;
+	BlockSize = InBlockSize;
+}
+
+void FMemoryArena::Release()
+{
+	FMemoryArenaBlock* Block = FirstBlock;
+	while (Block)
+	{
+		FMemoryArenaBlock* Next = Block->Next;
+		free(Block);
+		Block = Next;
+	}
+
+	FirstBlock = nullptr;
+	CurrentBlock = nullptr;
+	Stats = {};
+}
+
+void* FMemoryArena::Push(uint64 Size, uint64 Alignment)
+{
+	uint64 Padding = CurrentBlock ? GetAlignmentPadding(CurrentBlock, Alignment) : 0;
+	if (!CurrentBlock || (CurrentBlock->Used + Padding + Size > CurrentBlock->Size))
+	{
+		// Enough room for the allocation, no matter how the new block is aligned.
+		AdvanceBlock(Size + Alignment - 1);
+		Padding = GetAlignmentPadding(CurrentBlock, Alignment);
+	}
+
+	void* Result = GetBlockMemory(CurrentBlock) + CurrentBlock->Used + Padding;
+	CurrentBlock->Used += Padding + Size;
+
+	Stats.UsedSize += Padding + Size;
+	Stats.PeakUsedSize = FMath::Max(Stats.PeakUsedSize, Stats.UsedSize);
+	++Stats.PushCount;
+	return Result;
+}
+
+void* FMemoryArena::PushZero(uint64 Size, uint64 Alignment)
+{
+	void* Result = Push(Size, Alignment);
+	memset(Result, 0, Size);
+	return Result;
+}
+
+void FMemoryArena::Reset()
+{
+	CurrentBlock = FirstBlock;
+	if (CurrentBlock)
+	{
+		CurrentBlock->Used = 0;
+	}
+	Stats.UsedSize = 0;
+}
+
+FTemporaryMemory FMemoryArena::BeginTemporaryMemory()
+{
+	FTemporaryMemory Result;
+	Result.Arena = this;
+	Result.Block = CurrentBlock;
+	Result.BlockUsed = CurrentBlock ? CurrentBlock->Used : 0;
+	Result.Used = Stats.UsedSize;
+	return Result;
+}
+
+void FMemoryArena::EndTemporaryMemory(const FTemporaryMemory& TemporaryMemory)
+{
+	if (!TemporaryMemory.Block)
+	{
+		// The arena had no blocks when the temporary memory began.
+		Reset();
+		return;
+	}
+
+	CurrentBlock = TemporaryMemory.Block;
+	CurrentBlock->Used = TemporaryMemory.BlockUsed;
+	Stats.UsedSize = TemporaryMemory.Used;
+}
+
+void FMemoryArena::AdvanceBlock(uint64 MinimumSize)
+{
+	FMemoryArenaBlock* Next = CurrentBlock ? CurrentBlock->Next : FirstBlock;
+	if (Next && (Next->Size >= MinimumSize))
+	{
+		Next->Used = 0;
+		CurrentBlock = Next;
+		return;
+	}
+
+	// The free blocks that are too small stay in the chain, after the new one.
+	uint64 NewBlockSize = FMath::Max(BlockSize, MinimumSize);
+	FMemoryArenaBlock* NewBlock = (FMemoryArenaBlock*)malloc(sizeof(FMemoryArenaBlock) + NewBlockSize);
+	NewBlock->Next = Next;
+	NewBlock->Size = NewBlockSize;
+	NewBlock->Used = 0;
+	NewBlock->Padding = 0;
+
+	if (CurrentBlock)
+	{
+		CurrentBlock->Next = NewBlock;
+	}
+	else
+	{
+		FirstBlock = NewBlock;
+	}
+	CurrentBlock = NewBlock;
+
+	Stats.ReservedSize += NewBlockSize;
+	++Stats.BlockCount;
+}
@@ -0,0 +1,166 @@
+/**
+ *--------------------------------------------
+ * MemoryArena.h <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 14 2022.
+ */
+
+#pragma once
+
+#include "Core/CoreTypes.h"
+
+/** The alignment of the allocations that don't request one. Enough for any scalar type and for SSE. */
+#define MEMORY_ARENA_DEFAULT_ALIGNMENT 16
+
+/** The size of a cache line. Arrays that are loaded by the SIMD kernels are aligned to it. */
+#define CACHE_LINE_SIZE 64
+
+/** The size of the blocks an arena allocates, unless a bigger allocation requires a bigger block. */
+#define MEMORY_ARENA_DEFAULT_BLOCK_SIZE (1024 * 1024)
+
+/** A block of memory owned by an arena. The usable memory follows the header. */
+struct FMemoryArenaBlock
+{
+	FMemoryArenaBlock* Next;
+	uint64             Size;
+	uint64             Used;
+	uint64             Padding;
+};
+
+struct FMemoryArenaStats
+{
+	/** The total size of the blocks allocated by the arena. */
+	uint64 ReservedSize;
+
+	/** The number of bytes currently allocated, including the alignment padding. */
+	uint64 UsedSize;
+
+	/** The highest value 'UsedSize' reached since the arena was initialized. */
+	uint64 PeakUsedSize;
+
+	/** The number of blocks allocated from the heap. Once an arena is warm, it stops growing. */
+	uint32 BlockCount;
+
+	/** The number of allocations made from the arena. */
+	uint64 PushCount;
+};
+
+/** The state of an arena at some point, which it can be rolled back to. See 'FMemoryArena::BeginTemporaryMemory'. */
+struct FTemporaryMemory
+{
+	struct FMemoryArena* Arena;
+	FMemoryArenaBlock*   Block;
+	uint64               BlockUsed;
+	uint64               Used;
+};
+
+/**
+ *---------------------------------------------------------------------------------
+ * Linear allocator. Memory is pushed on top of the arena and is never freed
+ *   individually; instead, the whole arena is reset, or rolled back to the state
+ *   saved by 'BeginTemporaryMemory'.
+ * The memory comes from blocks allocated on the heap. An arena that runs out of
+ *   space chains a new block, but the blocks are kept (and reused) when the arena
+ *   is reset or rolled back, so once an arena has seen its peak usage, it never
+ *   allocates again. Only 'Release' returns the blocks to the heap.
+ * Arenas are not thread-safe; every thread uses its own (see 'FMemory').
+ *---------------------------------------------------------------------------------
+ */
+struct FMemoryArena
+{
+public:
+	/**
+	 * Prepares the arena. No memory is allocated until the first push.
+	 *
+	 * @param InName The name of the arena, for reporting.
+	 * @param InBlockSize The minimum size of the blocks the arena allocates.
+	 */
+	void Initialize(const char* InName, uint64 InBlockSize = MEMORY_ARENA_DEFAULT_BLOCK_SIZE);
+
+	/** Frees all the blocks of the arena. Everything pushed on it is no longer valid. */
+	void Release();
+
+	/**
+	 * Allocates memory on top of the arena. The memory is not initialized.
+	 *
+	 * @param Size The number of bytes to allocate.
+	 * @param Alignment The alignment of the memory. Must be a power of two.
+	 *
+	 * @return The allocated memory.
+	 */
+	void* Push(uint64 Size, uint64 Alignment = MEMORY_ARENA_DEFAULT_ALIGNMENT);
+
+	/** Same as 'Push', but the memory is filled with zeros. */
+	void* PushZero(uint64 Size, uint64 Alignment = MEMORY_ARENA_DEFAULT_ALIGNMENT);
+
+	template<typename T>
+	SM_INLINE T* PushStruct(uint64 Alignment = alignof(T))
+	{
+		return (T*)Push(sizeof(T), Alignment);
+	}
+
+	template<typename T>
+	SM_INLINE T* PushArray(uint64 Count, uint64 Alignment = alignof(T))
+	{
+		return (T*)Push(sizeof(T) * Count, Alignment);
+	}
+
+	template<typename T>
+	SM_INLINE T* PushArrayZero(uint64 Count, uint64 Alignment = alignof(T))
+	{
+		return (T*)PushZero(sizeof(T) * Count, Alignment);
+	}
+
+	/** Frees everything pushed on the arena, but keeps its blocks for the next pushes. */
+	void Reset();
+
+	/**
+	 * Saves the current state of the arena. Everything pushed after it is freed by passing the
+	 *   state to 'EndTemporaryMemory'. Temporary memory can be nested, but must be ended in the
+	 *   reverse order.
+	 */
+	FTemporaryMemory BeginTemporaryMemory();
+
+	/** Rolls the arena back to a state saved by 'BeginTemporaryMemory'. */
+	void EndTemporaryMemory(const FTemporaryMemory& TemporaryMemory);
+
+	/** @return Statistics about the usage of the arena. */
+	SM_INLINE const FMemoryArenaStats& GetStats() const { return Stats; }
+
+	SM_INLINE const char* GetName() const { return Name; }
+
+private:
+	/** Makes 'CurrentBlock' a block with at least the given number of free bytes; reuses the next block if it can. */
+	void AdvanceBlock(uint64 MinimumSize);
+
+private:
+	const char*        Name = "Unnamed";
+	uint64             BlockSize = MEMORY_ARENA_DEFAULT_BLOCK_SIZE;
+
+	/** The first block of the chain. The blocks after the current one are free. */
+	FMemoryArenaBlock* FirstBlock = nullptr;
+	FMemoryArenaBlock* CurrentBlock = nullptr;
+
+	FMemoryArenaStats  Stats = {};
+};
+
+/** Rolls an arena back when it goes out of scope. */
+class FScopedTemporaryMemory
+{
+public:
+	SM_INLINE explicit FScopedTemporaryMemory(FMemoryArena& Arena)
+		: TemporaryMemory(Arena.BeginTemporaryMemory())
+	{}
+
+	SM_INLINE ~FScopedTemporaryMemory()
+	{
+		TemporaryMemory.Arena->EndTemporaryMemory(TemporaryMemory);
+	}
+
+	FScopedTemporaryMemory(const FScopedTemporaryMemory&) = delete;
+	FScopedTemporaryMemory& operator=(const FScopedTemporaryMemory&) = delete;
+
+private:
+	FTemporaryMemory TemporaryMemory;
+};
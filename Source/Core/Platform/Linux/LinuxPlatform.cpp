@@ -0,0 +1,142 @@
+/**
+ *--------------------------------------------
+ * LinuxPlatform.cpp <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 25 2022.
+ */
+
+#include "Core/CoreDefines.h"
+
+#if SM_PLATFORM_LINUX
+
+#include "Core/Platform/Platform.h"
+
+#include <cpuid.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace SM
+{
+
+float64 FPlatform::GetTimeSeconds()
+{
+	timespec Time;
+	clock_gettime(CLOCK_MONOTONIC, &Time);
+	return (float64)Time.tv_sec + (float64)Time.tv_nsec * 1e-9;
+}
+
+FILE* FPlatform::OpenFile(const char* FileName, const char* Mode)
+{
+	return fopen(FileName, Mode);
+}
+
+bool FPlatform::MapFile(const char* FileName, out FMappedFile& MappedFile)
+{
+	MappedFile = FMappedFile();
+
+	int File = open(FileName, O_RDONLY);
+	if (File < 0)
+	{
+		return false;
+	}
+
+	struct stat FileStatus;
+	if (fstat(File, &FileStatus) != 0)
+	{
+		close(File);
+		return false;
+	}
+
+	// Empty files can't be mapped.
+	if (FileStatus.st_size == 0)
+	{
+		close(File);
+		return true;
+	}
+
+	// The mapping keeps its own reference to the file, so the descriptor isn't needed after it's created.
+	void* Data = mmap(nullptr, (size_t)FileStatus.st_size, PROT_READ, MAP_PRIVATE, File, 0);
+	close(File);
+	if (Data == MAP_FAILED)
+	{
+		return false;
+	}
+
+	madvise(Data, (size_t)FileStatus.st_size, MADV_SEQUENTIAL);
+
+	MappedFile.Data = (const uint8*)Data;
+	MappedFile.Size = (uint64)FileStatus.st_size;
+	return true;
+}
+
+void FPlatform::UnmapFile(FMappedFile& MappedFile)
+{
+	if (MappedFile.Data)
+	{
+		munmap((void*)MappedFile.Data, (size_t)MappedFile.Size);
+	}
+
+	MappedFile = FMappedFile();
+}
+
+uint64 FPlatform::GetPeakMemoryUsage()
+{
+	struct rusage Usage = {};
+	getrusage(RUSAGE_SELF, &Usage);
+
+	// Linux reports the maximum resident set size in kilobytes.
+	return (uint64)Usage.ru_maxrss * 1024;
+}
+
+FCPUFeatures FPlatform::GetCPUFeatures()
+{
+	FCPUFeatures Features;
+
+	uint32 EAX, EBX, ECX, EDX;
+	if (!__get_cpuid(1, &EAX, &EBX, &ECX, &EDX))
+	{
+		return Features;
+	}
+	Features.bSSE41 = (ECX & Bit(19)) != 0;
+
+	// The AVX registers can only be used if the operating system saves them (OSXSAVE, then the XMM and YMM state in XCR0).
+	bool bOSSavesAVX = false;
+	bool bOSSavesAVX512 = false;
+	if ((ECX & Bit(27)) && (ECX & Bit(28)))
+	{
+		uint32 XCR0Low, XCR0High;
+		__asm__ volatile("xgetbv" : "=a"(XCR0Low), "=d"(XCR0High) : "c"(0));
+		bOSSavesAVX = (XCR0Low & 0x06) == 0x06;
+
+		// The opmask registers, and the upper halves of ZMM0-15 and ZMM16-31.
+		bOSSavesAVX512 = (XCR0Low & 0xE6) == 0xE6;
+	}
+	bool bFMA = (ECX & Bit(12)) != 0;
+
+	if (!bOSSavesAVX || !__get_cpuid_count(7, 0, &EAX, &EBX, &ECX, &EDX))
+	{
+		return Features;
+	}
+	Features.bAVX2 = (EBX & Bit(5)) != 0;
+	Features.bFMA = bFMA;
+
+	if (bOSSavesAVX512)
+	{
+		Features.bAVX512F = (EBX & Bit(16)) != 0;
+		Features.bAVX512DQ = (EBX & Bit(17)) != 0;
+		Features.bAVX512CD = (EBX & Bit(28)) != 0;
+		Features.bAVX512BW = (EBX & Bit(30)) != 0;
+		Features.bAVX512VL = (EBX & (1U << 31)) != 0;
+	}
+
+	return Features;
+}
+
+} // namespace SM
+
+#endif // SM_PLATFORM_LINUX
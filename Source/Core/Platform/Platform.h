@@ -0,0 +1,104 @@
+/**
+ *--------------------------------------------
+ * Platform.h <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 8 2022.
+ */
+
+#pragma once
+
+#include "Core/CoreTypes.h"
+
+#include <cstdio>
+
+namespace SM
+{
+
+/** A file mapped in the address space of the process, for reading. */
+struct FMappedFile
+{
+	const uint8* Data = nullptr;
+	uint64       Size = 0;
+
+	/** Platform-specific handles, owned by the mapping. */
+	void*        FileHandle = nullptr;
+	void*        MappingHandle = nullptr;
+};
+
+/**
+ * The instruction set extensions that both the processor and the operating system support (the
+ *   operating system must save the wider registers on context switches).
+ */
+struct FCPUFeatures
+{
+	bool bSSE41 = false;
+	bool bAVX2 = false;
+	bool bFMA = false;
+
+	/** The AVX-512 subsets that '/arch:AVX512' and '-march=x86-64-v4' enable together. */
+	bool bAVX512F = false;
+	bool bAVX512CD = false;
+	bool bAVX512BW = false;
+	bool bAVX512DQ = false;
+	bool bAVX512VL = false;
+};
+
+/**
+ *-----------------------------------------------------------------
+ * The interface to the operating system. Every supported platform
+ *   implements it in its own 'Platform/{Name}' directory.
+ *-----------------------------------------------------------------
+ */
+class FPlatform
+{
+public:
+	/**
+	 * Gets a high-resolution monotonic timestamp. It is only meaningful when compared
+	 *   to another timestamp.
+	 *
+	 * @return The timestamp, in seconds.
+	 */
+	static float64 GetTimeSeconds();
+
+	/**
+	 * Opens a file as a C stream, the same way 'fopen' does.
+	 *
+	 * @param FileName The path to the file.
+	 * @param Mode The 'fopen' mode string.
+	 *
+	 * @return The stream, or nullptr if the file could not be opened. Must be closed with 'fclose'.
+	 */
+	static FILE* OpenFile(const char* FileName, const char* Mode);
+
+	/**
+	 * Maps a whole file in memory, for reading. The pages are loaded by the operating system
+	 *   when they are first accessed, so no time is spent copying the file in a buffer.
+	 *
+	 * @param FileName The path to the file.
+	 * @param MappedFile The mapping. An empty file is mapped with a null data pointer.
+	 *
+	 * @return True if the file was mapped; false if it could not be opened or mapped.
+	 */
+	static bool MapFile(const char* FileName, out FMappedFile& MappedFile);
+
+	/** Unmaps a file mapped by 'MapFile'. Its data pointer is no longer valid. */
+	static void UnmapFile(FMappedFile& MappedFile);
+
+	/**
+	 * Gets the most physical memory the process has used since it started (its peak resident set, or
+	 *   working set), including the heap, the stacks and the pages of the mapped files that were accessed.
+	 *
+	 * @return The peak, in bytes.
+	 */
+	static uint64 GetPeakMemoryUsage();
+
+	/** @return The instruction set extensions that can be used, as reported by CPUID and XGETBV. */
+	static FCPUFeatures GetCPUFeatures();
+};
+
+} // namespace SM
+
+using FCPUFeatures = SM::FCPUFeatures;
+using FMappedFile = SM::FMappedFile;
+using FPlatform = SM::FPlatform;
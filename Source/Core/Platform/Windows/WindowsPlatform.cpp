@@ -8,9 +8,166 @@
 
 #include "Core/CoreDefines.h"
 
+#if SM_PLATFORM_WINDOWS
+
+#include "Core/Platform/Platform.h"
+
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#include <Psapi.h>
+#include <intrin.h>
+
 namespace SM
 {
 
+float64 FPlatform::GetTimeSeconds()
+{
+	static float64 SecondsPerTick = 0.0;
+	if (SecondsPerTick == 0.0)
+	{
+		LARGE_INTEGER Frequency;
+		QueryPerformanceFrequency(&Frequency);
+		SecondsPerTick = 1.0 / (float64)Frequency.QuadPart;
+	}
+
+	LARGE_INTEGER Counter;
+	QueryPerformanceCounter(&Counter);
+	return (float64)Counter.QuadPart * SecondsPerTick;
+}
+
+FILE* FPlatform::OpenFile(const char* FileName, const char* Mode)
+{
+	FILE* File;
+	if (fopen_s(&File, FileName, Mode) != 0)
+	{
+		return nullptr;
+	}
+	return File;
+}
+
+bool FPlatform::MapFile(const char* FileName, out FMappedFile& MappedFile)
+{
+	MappedFile = FMappedFile();
+
+	HANDLE File = CreateFileA(FileName, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (File == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER FileSize;
+	if (!GetFileSizeEx(File, &FileSize))
+	{
+		CloseHandle(File);
+		return false;
+	}
+
+	// Empty files can't be mapped.
+	if (FileSize.QuadPart == 0)
+	{
+		MappedFile.FileHandle = File;
+		return true;
+	}
+
+	HANDLE Mapping = CreateFileMappingA(File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!Mapping)
+	{
+		CloseHandle(File);
+		return false;
+	}
+
+	const void* Data = MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!Data)
+	{
+		CloseHandle(Mapping);
+		CloseHandle(File);
+		return false;
+	}
+
+	MappedFile.Data = (const uint8*)Data;
+	MappedFile.Size = (uint64)FileSize.QuadPart;
+	MappedFile.FileHandle = File;
+	MappedFile.MappingHandle = Mapping;
+	return true;
+}
+
+void FPlatform::UnmapFile(FMappedFile& MappedFile)
+{
+	if (MappedFile.Data)
+	{
+		UnmapViewOfFile(MappedFile.Data);
+	}
+	if (MappedFile.MappingHandle)
+	{
+		CloseHandle((HANDLE)MappedFile.MappingHandle);
+	}
+	if (MappedFile.FileHandle)
+	{
+		CloseHandle((HANDLE)MappedFile.FileHandle);
+	}
+
+	MappedFile = FMappedFile();
+}
+
+uint64 FPlatform::GetPeakMemoryUsage()
+{
+	PROCESS_MEMORY_COUNTERS Counters = {};
+	Counters.cb = sizeof(Counters);
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &Counters, sizeof(Counters)))
+	{
+		return 0;
+	}
+	return (uint64)Counters.PeakWorkingSetSize;
+}
+
+FCPUFeatures FPlatform::GetCPUFeatures()
+{
+	FCPUFeatures Features;
+
+	int32 Registers[4];
+	__cpuid(Registers, 0);
+	int32 MaxLeaf = Registers[0];
+
+	__cpuid(Registers, 1);
+	uint32 ECX = (uint32)Registers[2];
+	Features.bSSE41 = (ECX & Bit(19)) != 0;
+
+	// The AVX registers can only be used if the operating system saves them (OSXSAVE, then the XMM and YMM state in XCR0).
+	bool bOSSavesAVX = false;
+	bool bOSSavesAVX512 = false;
+	if ((ECX & Bit(27)) && (ECX & Bit(28)))
+	{
+		uint64 XCR0 = _xgetbv(0);
+		bOSSavesAVX = (XCR0 & 0x06) == 0x06;
+
+		// The opmask registers, and the upper halves of ZMM0-15 and ZMM16-31.
+		bOSSavesAVX512 = (XCR0 & 0xE6) == 0xE6;
+	}
+	bool bFMA = (ECX & Bit(12)) != 0;
+
+	if (!bOSSavesAVX || (MaxLeaf < 7))
+	{
+		return Features;
+	}
+
+	__cpuidex(Registers, 7, 0);
+	uint32 EBX = (uint32)Registers[1];
+	Features.bAVX2 = (EBX & Bit(5)) != 0;
+	Features.bFMA = bFMA;
+
+	if (bOSSavesAVX512)
+	{
+		Features.bAVX512F = (EBX & Bit(16)) != 0;
+		Features.bAVX512DQ = (EBX & Bit(17)) != 0;
+		Features.bAVX512CD = (EBX & Bit(28)) != 0;
+		Features.bAVX512BW = (EBX & Bit(30)) != 0;
+		Features.bAVX512VL = (EBX & (1U << 31)) != 0;
+	}
+
+	return Features;
+}
 
+} // namespace SM
 
-} // namespace SM
\ No newline at end of file
+#endif // SM_PLATFORM_WINDOWS
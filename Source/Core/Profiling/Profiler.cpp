@@ -0,0 +1,326 @@
+/**
+ *--------------------------------------------
+ * Profiler.cpp <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 26 2022.
+ */
+
+#include "Profiler.h"
+
+#include "Core/Jobs/JobSystem.h"
+#include "Core/Math/MathUtilities.h"
+#include "Core/Memory/MemoryArena.h"
+
+#include <atomic>
+
+struct FProfileEvent
+{
+	const char* Name;
+	float64     StartTime;
+	float64     Duration;
+	uint32      Index;
+};
+
+/** What a thread recorded during the capture. Every thread has its own cache lines, so they don't share them when recording. */
+struct alignas(CACHE_LINE_SIZE) FProfilerThread
+{
+	FProfileEvent* Events;
+	uint32         EventCount;
+	uint32         DroppedEventCount;
+
+	uint64         Counters[(uint32)EProfileCounter::Count];
+	float64        TimerSeconds[(uint32)EProfileTimer::Count];
+	uint64         TimerCallCounts[(uint32)EProfileTimer::Count];
+};
+
+/** The values of the counters recorded since the previous sample. */
+struct FProfileCounterSample
+{
+	float64 Time;
+	uint64  Values[(uint32)EProfileCounter::Count];
+};
+
+internal const char* GCounterNames[(uint32)EProfileCounter::Count] =
+{
+	"TracedRays",
+	"OcclusionRays",
+	"VisitedNodes",
+	"TestedPrimitives",
+};
+
+internal const char* GTimerNames[(uint32)EProfileTimer::Count] =
+{
+	"TraceRay",
+	"ClosestHit",
+	"RenderTile",
+};
+
+internal FMemoryArena           GProfilerArena;
+internal FProfilerThread*       GProfilerThreads = nullptr;
+internal uint32                 GProfilerThreadCount = 0;
+
+internal FProfileCounterSample* GCounterSamples = nullptr;
+internal uint32                 GCounterSampleCount = 0;
+internal uint64                 GLastSampledCounters[(uint32)EProfileCounter::Count];
+
+internal std::atomic<bool>      GIsCapturing = false;
+internal float64                GCaptureStartTime = 0.0;
+internal float64                GCaptureEndTime = 0.0;
+
+/** @return The buffers of the calling thread. Threads unknown to the job system share the buffers of the main thread. */
+internal SM_INLINE FProfilerThread& GetProfilerThread()
+{
+	uint32 ThreadIndex = FJobSystem::GetCurrentThreadIndex();
+	return GProfilerThreads[(ThreadIndex < GProfilerThreadCount) ? ThreadIndex : 0];
+}
+
+/** Adds the counters of all the threads together. */
+internal void GetCounterTotals(out uint64* Totals)
+{
+	for (uint32 CounterIndex = 0; CounterIndex < (uint32)EProfileCounter::Count; ++CounterIndex)
+	{
+		Totals[CounterIndex] = 0;
+		for (uint32 ThreadIndex = 0; ThreadIndex < GProfilerThreadCount; ++ThreadIndex)
+		{
+			Totals[CounterIndex] += GProfilerThreads[ThreadIndex].Counters[CounterIndex];
+		}
+	}
+}
+
+/** Adds the time and the calls of a timer of all the threads together. */
+internal void GetTimerTotal(uint32 TimerIndex, out float64& Seconds, out uint64& CallCount)
+{
+	Seconds = 0.0;
+	CallCount = 0;
+	for (uint32 ThreadIndex = 0; ThreadIndex < GProfilerThreadCount; ++ThreadIndex)
+	{
+		Seconds += GProfilerThreads[ThreadIndex].TimerSeconds[TimerIndex];
+		CallCount += GProfilerThreads[ThreadIndex].TimerCallCounts[TimerIndex];
+	}
+}
+
+internal float64 GetCaptureDuration()
+{
+	return (GIsCapturing ? FPlatform::GetTimeSeconds() : GCaptureEndTime) - GCaptureStartTime;
+}
+
+void FProfiler::Initialize()
+{
+	GProfilerArena.Initialize("Profiler", PROFILER_MAX_EVENT_COUNT_PER_THREAD * sizeof(FProfileEvent));
+
+	GProfilerThreadCount = FMath::Max(FJobSystem::GetThreadCount(), 1U);
+	GProfilerThreads = GProfilerArena.PushArrayZero<FProfilerThread>(GProfilerThreadCount, CACHE_LINE_SIZE);
+	for (uint32 ThreadIndex = 0; ThreadIndex < GProfilerThreadCount; ++ThreadIndex)
+	{
+		GProfilerThreads[ThreadIndex].Events = GProfilerArena.PushArray<FProfileEvent>(PROFILER_MAX_EVENT_COUNT_PER_THREAD, CACHE_LINE_SIZE);
+	}
+
+	GCounterSamples = GProfilerArena.PushArray<FProfileCounterSample>(PROFILER_MAX_COUNTER_SAMPLE_COUNT);
+	GCounterSampleCount = 0;
+}
+
+void FProfiler::Shutdown()
+{
+	GIsCapturing = false;
+	GProfilerArena.Release();
+	GProfilerThreads = nullptr;
+	GProfilerThreadCount = 0;
+	GCounterSamples = nullptr;
+	GCounterSampleCount = 0;
+}
+
+void FProfiler::BeginCapture()
+{
+	for (uint32 ThreadIndex = 0; ThreadIndex < GProfilerThreadCount; ++ThreadIndex)
+	{
+		FProfilerThread& Thread = GProfilerThreads[ThreadIndex];
+		FProfileEvent* Events = Thread.Events;
+		Thread = {};
+		Thread.Events = Events;
+	}
+
+	GCounterSampleCount = 0;
+	for (uint32 CounterIndex = 0; CounterIndex < (uint32)EProfileCounter::Count; ++CounterIndex)
+	{
+		GLastSampledCounters[CounterIndex] = 0;
+	}
+
+	GCaptureStartTime = FPlatform::GetTimeSeconds();
+	GCaptureEndTime = GCaptureStartTime;
+	GIsCapturing.store(true, std::memory_order_release);
+}
+
+void FProfiler::EndCapture()
+{
+	GIsCapturing.store(false, std::memory_order_release);
+	GCaptureEndTime = FPlatform::GetTimeSeconds();
+}
+
+bool FProfiler::IsCapturing()
+{
+	return GIsCapturing.load(std::memory_order_relaxed);
+}
+
+void FProfiler::RecordEvent(const char* Name, float64 StartTime, float64 EndTime, uint32 Index)
+{
+	if (!IsCapturing())
+	{
+		return;
+	}
+
+	FProfilerThread& Thread = GetProfilerThread();
+	if (Thread.EventCount == PROFILER_MAX_EVENT_COUNT_PER_THREAD)
+	{
+		++Thread.DroppedEventCount;
+		return;
+	}
+
+	FProfileEvent& Event = Thread.Events[Thread.EventCount++];
+	Event.Name = Name;
+	Event.StartTime = StartTime;
+	Event.Duration = EndTime - StartTime;
+	Event.Index = Index;
+}
+
+void FProfiler::AddCount(EProfileCounter Counter, uint64 Value)
+{
+	if (IsCapturing())
+	{
+		GetProfilerThread().Counters[(uint32)Counter] += Value;
+	}
+}
+
+void FProfiler::AddTime(EProfileTimer Timer, float64 Seconds)
+{
+	if (IsCapturing())
+	{
+		FProfilerThread& Thread = GetProfilerThread();
+		Thread.TimerSeconds[(uint32)Timer] += Seconds;
+		Thread.TimerCallCounts[(uint32)Timer] += 1;
+	}
+}
+
+void FProfiler::SampleCounters()
+{
+	if (!IsCapturing() || (GCounterSampleCount == PROFILER_MAX_COUNTER_SAMPLE_COUNT))
+	{
+		return;
+	}
+
+	uint64 Totals[(uint32)EProfileCounter::Count];
+	GetCounterTotals(Totals);
+
+	FProfileCounterSample& Sample = GCounterSamples[GCounterSampleCount++];
+	Sample.Time = FPlatform::GetTimeSeconds();
+	for (uint32 CounterIndex = 0; CounterIndex < (uint32)EProfileCounter::Count; ++CounterIndex)
+	{
+		Sample.Values[CounterIndex] = Totals[CounterIndex] - GLastSampledCounters[CounterIndex];
+		GLastSampledCounters[CounterIndex] = Totals[CounterIndex];
+	}
+}
+
+bool FProfiler::WriteChromeTrace(const char* FileName)
+{
+	FILE* File = FPlatform::OpenFile(FileName, "w");
+	if (!File)
+	{
+		return false;
+	}
+
+	// The timestamps of the trace are in microseconds, from the beginning of the capture.
+	fprintf(File, "{\"traceEvents\":[\n");
+	for (uint32 ThreadIndex = 0; ThreadIndex < GProfilerThreadCount; ++ThreadIndex)
+	{
+		fprintf(File, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"Thread %u\"}}",
+			(ThreadIndex > 0) ? ",\n" : "", ThreadIndex, ThreadIndex);
+
+		const FProfilerThread& Thread = GProfilerThreads[ThreadIndex];
+		for (uint32 EventIndex = 0; EventIndex < Thread.EventCount; ++EventIndex)
+		{
+			const FProfileEvent& Event = Thread.Events[EventIndex];
+			fprintf(File, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f", Event.Name, ThreadIndex,
+				(Event.StartTime - GCaptureStartTime) * 1e6, Event.Duration * 1e6);
+			if (Event.Index != UINT32_MAX)
+			{
+				fprintf(File, ",\"args\":{\"index\":%u}", Event.Index);
+			}
+			fprintf(File, "}");
+		}
+	}
+
+	for (uint32 SampleIndex = 0; SampleIndex < GCounterSampleCount; ++SampleIndex)
+	{
+		const FProfileCounterSample& Sample = GCounterSamples[SampleIndex];
+		fprintf(File, ",\n{\"name\":\"Counters\",\"ph\":\"C\",\"pid\":0,\"ts\":%.3f,\"args\":{", (Sample.Time - GCaptureStartTime) * 1e6);
+		for (uint32 CounterIndex = 0; CounterIndex < (uint32)EProfileCounter::Count; ++CounterIndex)
+		{
+			fprintf(File, "%s\"%s\":%llu", (CounterIndex > 0) ? "," : "", GCounterNames[CounterIndex], (unsigned long long)Sample.Values[CounterIndex]);
+		}
+		fprintf(File, "}}");
+	}
+	fprintf(File, "\n],\n\"displayTimeUnit\":\"ms\",\n\"otherData\":{\n");
+
+	// The totals, which the trace viewers show as the metadata of the trace.
+	float64 CaptureDuration = GetCaptureDuration();
+	uint32 DroppedEventCount = 0;
+	for (uint32 ThreadIndex = 0; ThreadIndex < GProfilerThreadCount; ++ThreadIndex)
+	{
+		DroppedEventCount += GProfilerThreads[ThreadIndex].DroppedEventCount;
+	}
+	fprintf(File, "\"CaptureMilliseconds\":%.3f,\n\"DroppedEvents\":%u", CaptureDuration * 1000.0, DroppedEventCount);
+
+	uint64 CounterTotals[(uint32)EProfileCounter::Count];
+	GetCounterTotals(CounterTotals);
+	for (uint32 CounterIndex = 0; CounterIndex < (uint32)EProfileCounter::Count; ++CounterIndex)
+	{
+		fprintf(File, ",\n\"%s\":%llu", GCounterNames[CounterIndex], (unsigned long long)CounterTotals[CounterIndex]);
+	}
+
+	for (uint32 TimerIndex = 0; TimerIndex < (uint32)EProfileTimer::Count; ++TimerIndex)
+	{
+		float64 Seconds;
+		uint64 CallCount;
+		GetTimerTotal(TimerIndex, Seconds, CallCount);
+		fprintf(File, ",\n\"%sMilliseconds\":%.3f,\n\"%sCalls\":%llu", GTimerNames[TimerIndex], Seconds * 1000.0, GTimerNames[TimerIndex], (unsigned long long)CallCount);
+	}
+
+	for (uint32 ThreadIndex = 0; ThreadIndex < GProfilerThreadCount; ++ThreadIndex)
+	{
+		float64 BusySeconds = GProfilerThreads[ThreadIndex].TimerSeconds[(uint32)EProfileTimer::RenderTile];
+		fprintf(File, ",\n\"Thread%uUtilisation\":%.4f", ThreadIndex, (CaptureDuration > 0.0) ? BusySeconds / CaptureDuration : 0.0);
+	}
+	fprintf(File, "\n}}\n");
+
+	fclose(File);
+	return true;
+}
+
+void FProfiler::PrintSummary()
+{
+	float64 CaptureDuration = GetCaptureDuration();
+	printf("Profiler capture of %.3f ms:\n", CaptureDuration * 1000.0);
+
+	uint64 CounterTotals[(uint32)EProfileCounter::Count];
+	GetCounterTotals(CounterTotals);
+	for (uint32 CounterIndex = 0; CounterIndex < (uint32)EProfileCounter::Count; ++CounterIndex)
+	{
+		printf("  %-18s %14llu\n", GCounterNames[CounterIndex], (unsigned long long)CounterTotals[CounterIndex]);
+	}
+
+	for (uint32 TimerIndex = 0; TimerIndex < (uint32)EProfileTimer::Count; ++TimerIndex)
+	{
+		float64 Seconds;
+		uint64 CallCount;
+		GetTimerTotal(TimerIndex, Seconds, CallCount);
+		printf("  %-18s %11.3f ms in %llu calls\n", GTimerNames[TimerIndex], Seconds * 1000.0, (unsigned long long)CallCount);
+	}
+
+	for (uint32 ThreadIndex = 0; ThreadIndex < GProfilerThreadCount; ++ThreadIndex)
+	{
+		const FProfilerThread& Thread = GProfilerThreads[ThreadIndex];
+		float64 BusySeconds = Thread.TimerSeconds[(uint32)EProfileTimer::RenderTile];
+		printf("  Thread %-3u %5.1f%% busy, %u events (%u dropped)\n", ThreadIndex, (CaptureDuration > 0.0) ? 100.0 * BusySeconds / CaptureDuration : 0.0,
+			Thread.EventCount, Thread.DroppedEventCount);
+	}
+}
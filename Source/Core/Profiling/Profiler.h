@@ -0,0 +1,195 @@
+/**
+ *--------------------------------------------
+ * Profiler.h <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 26 2022.
+ */
+
+#pragma once
+
+#include "Core/CoreTypes.h"
+#include "Core/Platform/Platform.h"
+
+/**
+ * Whether the profiling macros are compiled in. When 0 (the default), they expand to nothing, so
+ *   the instrumented code costs nothing.
+ */
+#ifndef SM_ENABLE_PROFILING
+	#define SM_ENABLE_PROFILING 0
+#endif // SM_ENABLE_PROFILING
+
+/** The maximum number of events every thread records during a capture. The events past it are dropped. */
+#define PROFILER_MAX_EVENT_COUNT_PER_THREAD   (256 * 1024)
+
+/** The maximum number of counter samples recorded during a capture. */
+#define PROFILER_MAX_COUNTER_SAMPLE_COUNT     4096
+
+/** Counters of the work done while tracing, added together across the threads. */
+enum class EProfileCounter : uint32
+{
+	/** The rays whose closest hit was searched, one at a time or in packets. */
+	TracedRays = 0,
+
+	/** The rays that only looked for any hit (the shadow rays). */
+	OcclusionRays,
+
+	/** The BVH nodes reached by the traversals, leaves included. With packets, a node counts once per packet. */
+	VisitedNodes,
+
+	/** The primitives of the leaves reached by the traversals. */
+	TestedPrimitives,
+
+	Count,
+};
+
+/**
+ * Time accumulated by functions that are called too often to be recorded as events. Every thread
+ *   adds the time it spends in them, and the number of calls.
+ */
+enum class EProfileTimer : uint32
+{
+	/** The closest hit searches of single rays and packets. The wavefront searches them in batches, recorded as events instead. */
+	TraceRay = 0,
+
+	ClosestHit,
+
+	/** The time spent rendering tiles, which is the useful work of a thread. Its utilisation is based on it. */
+	RenderTile,
+
+	Count,
+};
+
+/**
+ *---------------------------------------------------------------------------------
+ * Records what the threads do during a capture: scoped events (with their start
+ *   and duration), counters and accumulated timers. Every thread records into its
+ *   own buffers, so recording needs no synchronization. The capture is exported as
+ *   a Chrome trace (JSON), which can be opened in chrome://tracing or Perfetto.
+ * The code is instrumented with the 'SM_PROFILE_*' macros, which only record
+ *   anything when SM_ENABLE_PROFILING is 1. The events are only recorded while a
+ *   capture is in progress.
+ * Must be initialized after the job system, as it keeps buffers for every one of
+ *   its threads.
+ *---------------------------------------------------------------------------------
+ */
+class FProfiler
+{
+public:
+	static void Initialize();
+	static void Shutdown();
+
+	/**
+	 * Starts a capture, discarding what was recorded by the previous one. Must be called while no
+	 *   other thread is recording.
+	 */
+	static void BeginCapture();
+
+	/** Ends the capture. What was recorded is kept until the next capture begins. */
+	static void EndCapture();
+
+	/** @return True while a capture is in progress. */
+	static bool IsCapturing();
+
+	/**
+	 * Records an event of the calling thread.
+	 *
+	 * @param Name The name of the event. Must live as long as the capture (usually, a string literal).
+	 * @param StartTime The timestamp (from 'FPlatform::GetTimeSeconds') when the event started.
+	 * @param EndTime The timestamp when the event ended.
+	 * @param Index An index shown with the event (such as the index of a tile), or UINT32_MAX for none.
+	 */
+	static void RecordEvent(const char* Name, float64 StartTime, float64 EndTime, uint32 Index);
+
+	/** Adds a value to a counter of the calling thread. */
+	static void AddCount(EProfileCounter Counter, uint64 Value);
+
+	/** Adds the duration of a call to a timer of the calling thread. */
+	static void AddTime(EProfileTimer Timer, float64 Seconds);
+
+	/**
+	 * Records the current values of the counters (added together across the threads), which are shown
+	 *   as graphs over time. Must be called while no other thread is recording (for example, between
+	 *   two render passes).
+	 */
+	static void SampleCounters();
+
+	/**
+	 * Writes the last capture as a Chrome trace. Besides the events and the counter graphs, the trace
+	 *   holds the totals of the counters and of the timers, and the utilisation of every thread.
+	 *
+	 * @param FileName The path to the trace file.
+	 *
+	 * @return True if the trace was written; false if the file could not be opened.
+	 */
+	static bool WriteChromeTrace(const char* FileName);
+
+	/** Prints the totals of the last capture: the counters, the timers and the utilisation of every thread. */
+	static void PrintSummary();
+};
+
+/** Records the time between its construction and its destruction as an event. */
+class FScopedProfileEvent
+{
+public:
+	SM_INLINE FScopedProfileEvent(const char* InName, uint32 InIndex = UINT32_MAX)
+		: Name(InName)
+		, Index(InIndex)
+		, StartTime(FPlatform::GetTimeSeconds())
+	{}
+
+	SM_INLINE ~FScopedProfileEvent()
+	{
+		FProfiler::RecordEvent(Name, StartTime, FPlatform::GetTimeSeconds(), Index);
+	}
+
+private:
+	const char* Name;
+	uint32      Index;
+	float64     StartTime;
+};
+
+/** Adds the time between its construction and its destruction to a timer. */
+class FScopedProfileTimer
+{
+public:
+	SM_INLINE FScopedProfileTimer(EProfileTimer InTimer)
+		: Timer(InTimer)
+		, StartTime(FPlatform::GetTimeSeconds())
+	{}
+
+	SM_INLINE ~FScopedProfileTimer()
+	{
+		FProfiler::AddTime(Timer, FPlatform::GetTimeSeconds() - StartTime);
+	}
+
+private:
+	EProfileTimer Timer;
+	float64       StartTime;
+};
+
+#define SM_PROFILE_CONCAT_IMPL(A, B) A##B
+#define SM_PROFILE_CONCAT(A, B)      SM_PROFILE_CONCAT_IMPL(A, B)
+
+#if SM_ENABLE_PROFILING
+	/** Records the rest of the enclosing scope as an event. */
+	#define SM_PROFILE_SCOPE(NAME)                FScopedProfileEvent SM_PROFILE_CONCAT(ProfileEvent, __LINE__)(NAME)
+
+	/** Records the rest of the enclosing scope as an event, shown with an index (such as the index of a tile). */
+	#define SM_PROFILE_SCOPE_INDEX(NAME, INDEX)   FScopedProfileEvent SM_PROFILE_CONCAT(ProfileEvent, __LINE__)(NAME, INDEX)
+
+	/** Adds the time spent in the rest of the enclosing scope to a timer. */
+	#define SM_PROFILE_TIMER(TIMER)               FScopedProfileTimer SM_PROFILE_CONCAT(ProfileTimer, __LINE__)(EProfileTimer::TIMER)
+
+	/** Adds a value to a counter. */
+	#define SM_PROFILE_COUNT(COUNTER, VALUE)      FProfiler::AddCount(EProfileCounter::COUNTER, VALUE)
+
+	/** Records the current values of the counters. */
+	#define SM_PROFILE_SAMPLE_COUNTERS()          FProfiler::SampleCounters()
+#else
+	#define SM_PROFILE_SCOPE(NAME)
+	#define SM_PROFILE_SCOPE_INDEX(NAME, INDEX)
+	#define SM_PROFILE_TIMER(TIMER)
+	#define SM_PROFILE_COUNT(COUNTER, VALUE)
+	#define SM_PROFILE_SAMPLE_COUNTERS()
+#endif // SM_ENABLE_PROFILING
@@ -0,0 +1,94 @@
+/**
+ *--------------------------------------------
+ * MaterialTable.cpp <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 21 2022.
+ */
+
+#include "MaterialTable.h"
+
+#include "Core/Memory/Memory.h"
+
+internal void ShadeAbsorbing(const FShadingInput* Inputs, const uint32* Indices, uint32 Count, FShadingOutput* Outputs)
+{
+	for (uint32 Index = 0; Index < Count; ++Index)
+	{
+		FShadingOutput& Output = Outputs[Indices[Index]];
+		Output.Emission = FVector3(0.0F);
+		Output.SunWeight = FVector3(0.0F);
+		Output.BounceDirection = Inputs[Indices[Index]].Normal;
+		Output.BounceWeight = FVector3(0.0F);
+		Output.bTransmitted = false;
+	}
+}
+
+/** The registered shading functions. The built-in types are shaded by the kernels, unless a function is registered for them. */
+internal FShadeMaterialsFunction GShadeFunctions[MATERIAL_TYPE_MAX_COUNT] = {};
+
+void FMaterialTable::Register(uint32 MaterialTypeID, FShadeMaterialsFunction Function)
+{
+	if (MaterialTypeID < MATERIAL_TYPE_MAX_COUNT)
+	{
+		GShadeFunctions[MaterialTypeID] = Function;
+	}
+}
+
+FShadeMaterialsFunction FMaterialTable::Get(uint32 MaterialTypeID)
+{
+	return (MaterialTypeID < MATERIAL_TYPE_MAX_COUNT) ? GShadeFunctions[MaterialTypeID] : nullptr;
+}
+
+void FMaterialTable::Shade(const FShadingContext& Context, const FShadingInput* Inputs, uint32 Count, FShadingOutput* Outputs, const FShadeMaterialsFunction* BuiltInFunctions)
+{
+	FMemoryArena& ScratchArena = FMemory::GetScratchArena();
+	FScopedTemporaryMemory ScratchMemory(ScratchArena);
+
+	// Counting sort of the hits by material type. The last bucket holds the types that are out of range.
+	// The buckets are counted two slots ahead and scattered one slot ahead, so the last bucket
+	//   (MATERIAL_TYPE_MAX_COUNT) is counted in the slot MATERIAL_TYPE_MAX_COUNT + 2.
+	uint32 TypeOffsets[MATERIAL_TYPE_MAX_COUNT + 3] = {};
+	uint32* HitTypes = ScratchArena.PushArray<uint32>(Count);
+	for (uint32 HitIndex = 0; HitIndex < Count; ++HitIndex)
+	{
+		uint32 MaterialTypeID = Context.Materials[Inputs[HitIndex].MaterialIndex].MaterialTypeID;
+		HitTypes[HitIndex] = FMath::Min(MaterialTypeID, (uint32)MATERIAL_TYPE_MAX_COUNT);
+		++TypeOffsets[HitTypes[HitIndex] + 2];
+	}
+
+	for (uint32 Type = 2; Type < ArrayCount(TypeOffsets); ++Type)
+	{
+		TypeOffsets[Type] += TypeOffsets[Type - 1];
+	}
+
+	// After the scatter, 'TypeOffsets[Type]' is the beginning of the type's hits and 'TypeOffsets[Type + 1]' their end.
+	uint32* SortedIndices = ScratchArena.PushArray<uint32>(Count);
+	for (uint32 HitIndex = 0; HitIndex < Count; ++HitIndex)
+	{
+		SortedIndices[TypeOffsets[HitTypes[HitIndex] + 1]++] = HitIndex;
+	}
+
+	for (uint32 Type = 0; Type <= MATERIAL_TYPE_MAX_COUNT; ++Type)
+	{
+		uint32 First = TypeOffsets[Type];
+		uint32 TypeCount = TypeOffsets[Type + 1] - First;
+		if (TypeCount == 0)
+		{
+			continue;
+		}
+
+		FShadeMaterialsFunction Function = (Type < MATERIAL_TYPE_MAX_COUNT) ? GShadeFunctions[Type] : nullptr;
+		if (!Function && (Type < (uint32)EMaterialType::BuiltInCount))
+		{
+			Function = BuiltInFunctions[Type];
+		}
+		if (Function)
+		{
+			Function(Context, Inputs, SortedIndices + First, TypeCount, Outputs);
+		}
+		else
+		{
+			ShadeAbsorbing(Inputs, SortedIndices + First, TypeCount, Outputs);
+		}
+	}
+}
@@ -0,0 +1,105 @@
+/**
+ *--------------------------------------------
+ * MaterialTable.h <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 21 2022.
+ */
+
+#pragma once
+
+#include "World/Material.h"
+
+/** A surface hit by a path, to be shaded by its material. */
+struct FShadingInput
+{
+	/** The normal of the surface, on the side the ray came from. */
+	FVector3 Normal;
+
+	/** The direction of the ray that hit the surface. */
+	FVector3 Direction;
+
+	/** Random numbers for sampling the bounce: a point for the direction, and a number for choosing between lobes. */
+	FVector2 DirectionSample;
+	float    LobeSample;
+
+	uint32   MaterialIndex;
+
+	/** Whether the ray hit the outer side of the surface (the side the geometric normal points to). */
+	bool     bFrontFace;
+};
+
+/** How a surface interacts with the light: what it emits, how it's lit by the sun and where the path bounces. */
+struct FShadingOutput
+{
+	/** The radiance emitted by the surface, towards the ray. */
+	FVector3 Emission;
+
+	/** The BSDF times the cosine, towards the sun. Zero if the sun is behind the surface, or the material can't be lit directly. */
+	FVector3 SunWeight;
+
+	FVector3 BounceDirection;
+
+	/** The BSDF times the cosine, divided by the probability density of the bounce direction. Zero ends the path. */
+	FVector3 BounceWeight;
+
+	/** Whether the bounce goes through the surface, so its origin must be on the other side. */
+	bool     bTransmitted;
+};
+
+/** The parameters shared by all the hits that are shaded together. */
+struct FShadingContext
+{
+	const FMaterial* Materials;
+
+	/** The direction towards the sun. */
+	FVector3         SunDirection;
+};
+
+/**
+ * Shades a batch of hits whose materials are all of the same type.
+ *
+ * @param Context The shading parameters.
+ * @param Inputs The hits; only the ones in 'Indices' are shaded.
+ * @param Indices The indices of the hits to shade.
+ * @param Count The number of hits to shade.
+ * @param Outputs The results, at the same indices as the hits.
+ */
+typedef void (*FShadeMaterialsFunction)(const FShadingContext& Context, const FShadingInput* Inputs, const uint32* Indices, uint32 Count, FShadingOutput* Outputs);
+
+/**
+ * The shading functions of the material types, indexed by 'FMaterial::MaterialTypeID'. The built-in
+ *   types are shaded by the kernels of the instruction set the renderer selected (@see 'FRenderKernels'),
+ *   unless another function is registered for them.
+ * Hits are shaded in batches sorted by material type, so every shading function runs once over all
+ *   the hits of its type, instead of switching between the functions from one hit to the next.
+ */
+class FMaterialTable
+{
+public:
+	/**
+	 * Registers the shading function of a material type, replacing the previous one.
+	 * Must not be called while rendering.
+	 *
+	 * @param MaterialTypeID The type, in the range [0, MATERIAL_TYPE_MAX_COUNT).
+	 * @param Function The shading function. If nullptr, the built-in types go back to the built-in shading,
+	 *   and the hits of the other types absorb all the light.
+	 */
+	static void Register(uint32 MaterialTypeID, FShadeMaterialsFunction Function);
+
+	/** @return The shading function registered for a material type, or nullptr if none is (not even for the built-in types). */
+	static FShadeMaterialsFunction Get(uint32 MaterialTypeID);
+
+	/**
+	 * Shades a set of hits of any material types. The hits are sorted by type, and every type's
+	 *   function is called once, with all its hits.
+	 *
+	 * @param Context The shading parameters.
+	 * @param Inputs The hits.
+	 * @param Count The number of hits.
+	 * @param Outputs The results, one for every hit.
+	 * @param BuiltInFunctions The shading functions of the built-in types, indexed by 'EMaterialType'; used
+	 *   for the built-in types without a registered function.
+	 */
+	static void Shade(const FShadingContext& Context, const FShadingInput* Inputs, uint32 Count, FShadingOutput* Outputs, const FShadeMaterialsFunction* BuiltInFunctions);
+};
@@ -0,0 +1,105 @@
+/**
+ *--------------------------------------------
+ * RenderKernels.cpp <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 29 2022.
+ */
+
+#include "RenderKernels.h"
+
+#include "Core/Platform/Platform.h"
+
+#include <cctype>
+#include <cstring>
+
+/** The kernels of every instruction set, indexed by 'EKernelISA'. */
+internal const FRenderKernels* GKernelsByISA[(uint32)EKernelISA::Count] =
+{
+	&GRenderKernelsSSE,
+	&GRenderKernelsAVX2,
+};
+
+/** The selected kernels, or nullptr until they are first needed. */
+internal const FRenderKernels* GSelectedKernels = nullptr;
+
+bool FKernelDispatch::Initialize(EKernelISA ISA)
+{
+	bool bSupported = (ISA == EKernelISA::Count) || IsSupported(ISA);
+	if (!bSupported || (ISA == EKernelISA::Count))
+	{
+		ISA = GetBestSupported();
+	}
+
+	GSelectedKernels = GKernelsByISA[(uint32)ISA];
+	return bSupported;
+}
+
+const FRenderKernels& FKernelDispatch::GetKernels()
+{
+	if (!GSelectedKernels)
+	{
+		Initialize();
+	}
+	return *GSelectedKernels;
+}
+
+const FRenderKernels& FKernelDispatch::GetKernels(EKernelISA ISA)
+{
+	return *GKernelsByISA[(uint32)ISA];
+}
+
+bool FKernelDispatch::IsSupported(EKernelISA ISA)
+{
+	// CPUID is slow (it serializes the processor, and traps in virtual machines), so it's only queried once.
+	static const FCPUFeatures Features = FPlatform::GetCPUFeatures();
+
+	switch (ISA)
+	{
+		case EKernelISA::SSE:
+			return Features.bSSE41;
+		case EKernelISA::AVX2:
+			return Features.bAVX2 && Features.bFMA;
+		default:
+			return false;
+	}
+}
+
+EKernelISA FKernelDispatch::GetBestSupported()
+{
+	// The instruction sets newer than the baseline, from the newest. The baseline is always there, since the rest of the binary needs it.
+	for (uint32 Index = (uint32)EKernelISA::Count - 1; Index > (uint32)EKernelISA::AVX2; --Index)
+	{
+		if (IsSupported((EKernelISA)Index))
+		{
+			return (EKernelISA)Index;
+		}
+	}
+	return EKernelISA::AVX2;
+}
+
+bool FKernelDispatch::Parse(const char* Name, out EKernelISA& ISA)
+{
+	char LowerName[16] = {};
+	for (uint32 Index = 0; Name[Index] && (Index + 1 < ArrayCount(LowerName)); ++Index)
+	{
+		LowerName[Index] = (char)tolower((unsigned char)Name[Index]);
+	}
+
+	if (strcmp(LowerName, "auto") == 0)
+	{
+		ISA = EKernelISA::Count;
+		return true;
+	}
+
+	for (uint32 Index = 0; Index < (uint32)EKernelISA::Count; ++Index)
+	{
+		if (strcmp(LowerName, GKernelsByISA[Index]->Name) == 0)
+		{
+			ISA = (EKernelISA)Index;
+			return true;
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,143 @@
+/**
+ *--------------------------------------------
+ * RenderKernels.h <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 29 2022.
+ */
+
+#pragma once
+
+#include "Core/Math/Math.h"
+#include "Renderer/MaterialTable.h"
+#include "Renderer/Wavefront.h"
+#include "World/World.h"
+#include "World/WorldAcceleration.h"
+
+/**
+ *---------------------------------------------------------------------------------
+ * The hot loops of the renderer (intersection, shading and the packing of the
+ *   pixels) are compiled once for every instruction set below, each in its own
+ *   translation unit, and the best one the processor supports is picked at
+ *   startup. The rest of the binary only targets the baseline instruction set.
+ * The kernels only exchange plain data with the rest of the renderer, so none of
+ *   the types whose code depends on the instruction set cross the boundary.
+ *---------------------------------------------------------------------------------
+ */
+
+/** The instruction sets the kernels are compiled for, from the oldest to the newest. */
+enum class EKernelISA : uint32
+{
+	/**
+	 * The 4-wide paths of the lane-wide types, compiled without AVX. The rest of the binary still needs
+	 *   the baseline instruction set, so these are only there to measure what the wider paths bring.
+	 */
+	SSE = 0,
+	AVX2,
+
+	Count,
+};
+
+/** The running sums of a pixel's luminance samples, from which its variance is estimated. */
+struct FPixelMoments
+{
+	float Sum;
+	float SquaredSum;
+};
+
+/** What the kernels trace the rays against. */
+struct FKernelScene
+{
+	const FWorld*             World;
+	const FWorldAcceleration* Acceleration;
+};
+
+/** The kernels compiled for one instruction set. */
+struct FRenderKernels
+{
+	EKernelISA  ISA;
+
+	/** The name of the instruction set, as accepted by 'FKernelDispatch::Parse'. */
+	const char* Name;
+
+	/**
+	 * Finds the closest hit of a ray. The objects are indexed in the order planes, spheres, meshes.
+	 *
+	 * @param Scene The world to trace the ray against.
+	 * @param Ray The ray.
+	 * @param HitDistance The distance to the closest hit, or BIG_NUMBER if nothing is hit.
+	 * @param ObjectIndex The index of the object hit, or UINT32_MAX if the ray escaped the world.
+	 * @param PrimitiveIndex For meshes, the index of the triangle hit; 0 otherwise.
+	 */
+	void (*TraceRay)(const FKernelScene& Scene, const FRay& Ray, out float& HitDistance, out uint32& ObjectIndex, out uint32& PrimitiveIndex);
+
+	/**
+	 * Finds the closest hit of every ray of a queue, like 'TraceRay'.
+	 *
+	 * @param bUsePackets Whether the rays are traced in packets of 8 consecutive rays; only worth it if they are coherent.
+	 */
+	void (*TraceRays)(const FKernelScene& Scene, const FRayQueue& Rays, FHitQueue& Hits, bool bUsePackets);
+
+	/** @return True if anything is hit by the ray in the range (0, MaxDistance). Returns on the first hit found. */
+	bool (*Occluded)(const FKernelScene& Scene, const FRay& Ray, float MaxDistance);
+
+	/** Adds the radiance of every shadow ray that is not occluded to the radiance of its path. */
+	void (*TraceShadowRays)(const FKernelScene& Scene, const FShadowQueue& Shadows, FVector3* PathRadiance);
+
+	/** The shading functions of the built-in material types, indexed by 'EMaterialType'. */
+	FShadeMaterialsFunction ShadeMaterials[(uint32)EMaterialType::BuiltInCount];
+
+	/**
+	 * Adds a sample to a row of pixels, and resolves their mean to the output format.
+	 *
+	 * @param Accumulated The sum of the samples of every pixel. Updated.
+	 * @param Moments The luminance moments of every pixel. Updated.
+	 * @param Colors The new sample of every pixel.
+	 * @param Count The number of pixels.
+	 * @param InvSampleCount The inverse of the number of samples, including the new one.
+	 * @param Pixels The resolved pixels, packed as BGRA8.
+	 */
+	void (*AccumulateAndResolve)(FVector4* Accumulated, FPixelMoments* Moments, const FVector4* Colors, uint32 Count, float InvSampleCount, uint32* Pixels);
+};
+
+/** The kernels of every instruction set, defined by their translation units. */
+extern const FRenderKernels GRenderKernelsSSE;
+extern const FRenderKernels GRenderKernelsAVX2;
+
+/**
+ * Picks the kernels the renderers use. The processor is queried once; the best kernels it supports
+ *   are used, unless others are requested (to compare them, for example).
+ */
+class FKernelDispatch
+{
+public:
+	/**
+	 * Selects the kernels. Must be called before creating the renderers; if it's not, the best
+	 *   supported kernels are selected when they are first needed.
+	 *
+	 * @param ISA The instruction set whose kernels to use. EKernelISA::Count selects the best supported one.
+	 *
+	 * @return False if the processor doesn't support the instruction set; the best supported one is selected instead.
+	 */
+	static bool Initialize(EKernelISA ISA = EKernelISA::Count);
+
+	/** @return The selected kernels. */
+	static const FRenderKernels& GetKernels();
+
+	/** @return The kernels compiled for an instruction set. */
+	static const FRenderKernels& GetKernels(EKernelISA ISA);
+
+	/** @return True if the processor (and the operating system) support the kernels of an instruction set. */
+	static bool IsSupported(EKernelISA ISA);
+
+	/** @return The newest instruction set supported by the processor. */
+	static EKernelISA GetBestSupported();
+
+	/**
+	 * Parses the name of an instruction set, as given on a command line: "sse", "avx2" or "auto"
+	 *   (which is EKernelISA::Count, the best supported one). Case-insensitive.
+	 *
+	 * @return False if the name is unknown.
+	 */
+	static bool Parse(const char* Name, out EKernelISA& ISA);
+};
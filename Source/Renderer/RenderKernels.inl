@@ -0,0 +1,568 @@
+/**
+ *--------------------------------------------
+ * RenderKernels.inl <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 29 2022.
+ */
+
+/**
+ * The code of the render kernels, shared by all the instruction sets. It's included by one translation
+ *   unit per instruction set ('RenderKernels{ISA}.cpp'), which is compiled with its own flags and defines
+ *   before the include:
+ *   RENDER_KERNELS_TABLE The name of the 'FRenderKernels' to define, declared in 'RenderKernels.h'.
+ *   RENDER_KERNELS_ISA   The 'EKernelISA' of the translation unit.
+ *   RENDER_KERNELS_NAME  The name of the instruction set.
+ * Everything is either 'internal' or declared in the inline namespace of the instruction set, so the
+ *   translation units never define the same symbol differently; the code they share with the rest of the
+ *   binary (the vector math and the rays) is force-inlined, in every configuration. Anything else shared
+ *   would be emitted out of line by every translation unit, and the linker could keep the copy compiled
+ *   for a newer instruction set.
+ */
+
+#include "Renderer/RenderKernels.h"
+
+#include "Core/Math/IntersectionsSIMD.h"
+#include "Core/Math/RayPacket.h"
+#include "Core/Math/Vector3A.h"
+#include "Core/Math/Vector4A.h"
+#include "World/BVHTraversal.h"
+
+#if !defined(RENDER_KERNELS_TABLE) || !defined(RENDER_KERNELS_ISA) || !defined(RENDER_KERNELS_NAME)
+	#error RenderKernels.inl must only be included by the translation unit of an instruction set.
+#endif // !defined(RENDER_KERNELS_TABLE) || !defined(RENDER_KERNELS_ISA) || !defined(RENDER_KERNELS_NAME)
+
+/*
+ *---------------------------------------------------------------------------------
+ * Intersection.
+ *---------------------------------------------------------------------------------
+ */
+
+internal void TracePlanes(const FKernelScene& Scene, const FRay& Ray, float& ClosestHitDistance, uint32& ObjectIndex)
+{
+	const FWorld* World = Scene.World;
+	for (uint32 PlaneIndex = 0; PlaneIndex < World->PlaneCount; ++PlaneIndex)
+	{
+		const FPlane* Plane = World->Planes + PlaneIndex;
+
+		float HitDistance;
+		if (IntersectPlane(Ray, Plane->Normal, Plane->Distance, HitDistance))
+		{
+			if ((HitDistance > 0) && (HitDistance < ClosestHitDistance))
+			{
+				ClosestHitDistance = HitDistance;
+				ObjectIndex = PlaneIndex;
+			}
+		}
+	}
+}
+
+/** Finds the closest sphere hit by the ray, by traversing the sphere BVH. */
+internal void TraceSpheres(const FKernelScene& Scene, const FRay& Ray, float& ClosestHitDistance, uint32& ObjectIndex)
+{
+	const FSphereSoA& SphereData = Scene.Acceleration->SphereData;
+	uint32 PlaneCount = Scene.World->PlaneCount;
+
+	TraverseBVH(Scene.Acceleration->SphereBVH, Ray, ClosestHitDistance, [&](uint32 First, uint32 Count, float& ClosestDistance)
+	{
+		uint32 HitIndex = IntersectSpheres8(Ray, SphereData.X, SphereData.Y, SphereData.Z, SphereData.RadiusSquared, First, First + Count, ClosestDistance);
+		if (HitIndex != UINT32_MAX)
+		{
+			ObjectIndex = PlaneCount + SphereData.SphereIndex[HitIndex];
+		}
+	});
+}
+
+/** Finds the closest triangle hit by the ray, by traversing the BVH of every mesh. */
+internal void TraceMeshes(const FKernelScene& Scene, const FRay& Ray, float& ClosestHitDistance, uint32& ObjectIndex, uint32& PrimitiveIndex)
+{
+	const FWorld* World = Scene.World;
+	if (World->MeshCount == 0)
+	{
+		return;
+	}
+
+	FWatertightRay WatertightRay = PrepareWatertightRay(Ray);
+
+	for (uint32 MeshIndex = 0; MeshIndex < World->MeshCount; ++MeshIndex)
+	{
+		const FTriangleMesh& Mesh = World->Meshes[MeshIndex];
+		const FBVH& BVH = Scene.Acceleration->MeshBVHs[MeshIndex];
+
+		TraverseBVH(BVH, Ray, ClosestHitDistance, [&](uint32 First, uint32 Count, float& ClosestDistance)
+		{
+			for (uint32 Index = First; Index < First + Count; ++Index)
+			{
+				uint32 TriangleIndex = BVH.PrimitiveIndices[Index];
+				const uint32* Indices = Mesh.Indices + 3 * (uint64)TriangleIndex;
+
+				float HitDistance, U, V;
+				if (IntersectTriangle(Ray, WatertightRay, Mesh.Vertices[Indices[0]], Mesh.Vertices[Indices[1]], Mesh.Vertices[Indices[2]], HitDistance, U, V))
+				{
+					if (HitDistance < ClosestDistance)
+					{
+						ClosestDistance = HitDistance;
+						ObjectIndex = World->PlaneCount + World->SphereCount + MeshIndex;
+						PrimitiveIndex = TriangleIndex;
+					}
+				}
+			}
+		});
+	}
+}
+
+internal void TraceRay(const FKernelScene& Scene, const FRay& Ray, out float& HitDistance, out uint32& ObjectIndex, out uint32& PrimitiveIndex)
+{
+	HitDistance = BIG_NUMBER;
+	ObjectIndex = UINT32_MAX;
+	PrimitiveIndex = 0;
+
+	TracePlanes(Scene, Ray, HitDistance, ObjectIndex);
+	TraceSpheres(Scene, Ray, HitDistance, ObjectIndex);
+	TraceMeshes(Scene, Ray, HitDistance, ObjectIndex, PrimitiveIndex);
+}
+
+/**
+ * @return The packet of the rays [First, First + 8) of a queue. The lanes past the end of the queue are inactive.
+ *   'First' must be a multiple of 8.
+ */
+internal SM_INLINE FRayPacket8 LoadRayPacket(const FRayQueue& Rays, uint32 First)
+{
+	FRayPacket8 Packet;
+	Packet.OriginX = FFloat8::Load(Rays.OriginX + First);
+	Packet.OriginY = FFloat8::Load(Rays.OriginY + First);
+	Packet.OriginZ = FFloat8::Load(Rays.OriginZ + First);
+	Packet.DirectionX = FFloat8::Load(Rays.DirectionX + First);
+	Packet.DirectionY = FFloat8::Load(Rays.DirectionY + First);
+	Packet.DirectionZ = FFloat8::Load(Rays.DirectionZ + First);
+
+	uint32 LaneCount = FMath::Min(Rays.Count - First, 8U);
+	Packet.ActiveMask = FMask8::FromBits((1U << LaneCount) - 1);
+	return Packet;
+}
+
+/** Packet version of 'TracePlanes'. */
+internal void TracePlanesPacket(const FKernelScene& Scene, const FRayPacket8& Packet, FFloat8& ClosestHitDistance, uint32* ObjectIndex)
+{
+	const FWorld* World = Scene.World;
+	for (uint32 PlaneIndex = 0; PlaneIndex < World->PlaneCount; ++PlaneIndex)
+	{
+		const FPlane* Plane = World->Planes + PlaneIndex;
+
+		FFloat8 HitDistance;
+		FMask8 HitMask = IntersectPlane8(Packet, Plane->Normal, Plane->Distance, HitDistance);
+		HitMask = HitMask & Packet.ActiveMask & (HitDistance > FFloat8::Set(0.0F)) & (HitDistance < ClosestHitDistance);
+
+		uint32 HitBits = HitMask.GetBits();
+		if (HitBits)
+		{
+			ClosestHitDistance = FFloat8::Select(HitMask, HitDistance, ClosestHitDistance);
+			for (uint32 Lane = 0; Lane < 8; ++Lane)
+			{
+				if (HitBits & (1 << Lane))
+				{
+					ObjectIndex[Lane] = PlaneIndex;
+				}
+			}
+		}
+	}
+}
+
+/**
+ * Packet version of 'TraceSpheres'. The rays traverse the sphere BVH together, visiting a node if
+ *   any of the active rays intersects it.
+ */
+internal void TraceSpheresPacket(const FKernelScene& Scene, const FRayPacket8& Packet, FFloat8& ClosestHitDistance, uint32* ObjectIndex)
+{
+	const FSphereSoA& SphereData = Scene.Acceleration->SphereData;
+	uint32 PlaneCount = Scene.World->PlaneCount;
+
+	TraverseBVHPacket(Scene.Acceleration->SphereBVH, Packet, ClosestHitDistance, [&](uint32 First, uint32 Count, FFloat8& ClosestDistance)
+	{
+		uint32 HitIndex[8] = {};
+		FMask8 HitMask = IntersectSpheresPacket8(Packet, SphereData.X, SphereData.Y, SphereData.Z, SphereData.RadiusSquared, First, First + Count, ClosestDistance, HitIndex);
+
+		uint32 HitBits = HitMask.GetBits();
+		for (uint32 Lane = 0; Lane < 8; ++Lane)
+		{
+			if (HitBits & (1 << Lane))
+			{
+				ObjectIndex[Lane] = PlaneCount + SphereData.SphereIndex[HitIndex[Lane]];
+			}
+		}
+	});
+}
+
+/** Packet version of 'TraceMeshes'. */
+internal void TraceMeshesPacket(const FKernelScene& Scene, const FRayPacket8& Packet, FFloat8& ClosestHitDistance, uint32* ObjectIndex, uint32* PrimitiveIndex)
+{
+	const FWorld* World = Scene.World;
+	if (World->MeshCount == 0)
+	{
+		return;
+	}
+
+	// The packet shares the traversal, but the watertight test depends on the ray's dominant axis,
+	//   so the triangles are tested against every ray separately.
+	uint32 ActiveBits = Packet.ActiveMask.GetBits();
+	FRay Rays[8];
+	FWatertightRay WatertightRays[8];
+	for (uint32 Lane = 0; Lane < 8; ++Lane)
+	{
+		if (ActiveBits & (1 << Lane))
+		{
+			Rays[Lane] = Packet.GetRay(Lane);
+			WatertightRays[Lane] = PrepareWatertightRay(Rays[Lane]);
+		}
+	}
+
+	for (uint32 MeshIndex = 0; MeshIndex < World->MeshCount; ++MeshIndex)
+	{
+		const FTriangleMesh& Mesh = World->Meshes[MeshIndex];
+		const FBVH& BVH = Scene.Acceleration->MeshBVHs[MeshIndex];
+
+		TraverseBVHPacket(BVH, Packet, ClosestHitDistance, [&](uint32 First, uint32 Count, FFloat8& ClosestDistance)
+		{
+			alignas(32) float ClosestDistances[8];
+			ClosestDistance.Store(ClosestDistances);
+
+			for (uint32 Index = First; Index < First + Count; ++Index)
+			{
+				uint32 TriangleIndex = BVH.PrimitiveIndices[Index];
+				const uint32* Indices = Mesh.Indices + 3 * (uint64)TriangleIndex;
+				const FVector3& V0 = Mesh.Vertices[Indices[0]];
+				const FVector3& V1 = Mesh.Vertices[Indices[1]];
+				const FVector3& V2 = Mesh.Vertices[Indices[2]];
+
+				for (uint32 Lane = 0; Lane < 8; ++Lane)
+				{
+					if (!(ActiveBits & (1 << Lane)))
+					{
+						continue;
+					}
+
+					float HitDistance, U, V;
+					if (IntersectTriangle(Rays[Lane], WatertightRays[Lane], V0, V1, V2, HitDistance, U, V))
+					{
+						if (HitDistance < ClosestDistances[Lane])
+						{
+							ClosestDistances[Lane] = HitDistance;
+							ObjectIndex[Lane] = World->PlaneCount + World->SphereCount + MeshIndex;
+							PrimitiveIndex[Lane] = TriangleIndex;
+						}
+					}
+				}
+			}
+
+			ClosestDistance = FFloat8::Load(ClosestDistances);
+		});
+	}
+}
+
+internal void TraceRays(const FKernelScene& Scene, const FRayQueue& Rays, FHitQueue& Hits, bool bUsePackets)
+{
+	if (bUsePackets)
+	{
+		// The queues are padded to a whole number of packets, so the inactive lanes of the last one can be written.
+		for (uint32 First = 0; First < Rays.Count; First += 8)
+		{
+			FRayPacket8 Packet = LoadRayPacket(Rays, First);
+			FFloat8 ClosestHitDistance = FFloat8::Set(BIG_NUMBER);
+			uint32* ObjectIndex = Hits.ObjectIndex + First;
+			uint32* PrimitiveIndex = Hits.PrimitiveIndex + First;
+			for (uint32 Lane = 0; Lane < 8; ++Lane)
+			{
+				ObjectIndex[Lane] = UINT32_MAX;
+				PrimitiveIndex[Lane] = 0;
+			}
+
+			TracePlanesPacket(Scene, Packet, ClosestHitDistance, ObjectIndex);
+			TraceSpheresPacket(Scene, Packet, ClosestHitDistance, ObjectIndex);
+			TraceMeshesPacket(Scene, Packet, ClosestHitDistance, ObjectIndex, PrimitiveIndex);
+			ClosestHitDistance.Store(Hits.HitDistance + First);
+		}
+		return;
+	}
+
+	for (uint32 RayIndex = 0; RayIndex < Rays.Count; ++RayIndex)
+	{
+		TraceRay(Scene, Rays.GetRay(RayIndex), Hits.HitDistance[RayIndex], Hits.ObjectIndex[RayIndex], Hits.PrimitiveIndex[RayIndex]);
+	}
+}
+
+internal bool Occluded(const FKernelScene& Scene, const FRay& Ray, float MaxDistance)
+{
+	const FWorld* World = Scene.World;
+	for (uint32 PlaneIndex = 0; PlaneIndex < World->PlaneCount; ++PlaneIndex)
+	{
+		const FPlane* Plane = World->Planes + PlaneIndex;
+
+		float HitDistance;
+		if (IntersectPlane(Ray, Plane->Normal, Plane->Distance, HitDistance) && (HitDistance > 0) && (HitDistance < MaxDistance))
+		{
+			return true;
+		}
+	}
+
+	const FSphereSoA& SphereData = Scene.Acceleration->SphereData;
+	bool bHitSphere = TraverseBVHAnyHit(Scene.Acceleration->SphereBVH, Ray, MaxDistance, [&](uint32 First, uint32 Count) -> bool
+	{
+		return IntersectSpheresAny8(Ray, SphereData.X, SphereData.Y, SphereData.Z, SphereData.RadiusSquared, First, First + Count, MaxDistance);
+	});
+	if (bHitSphere)
+	{
+		return true;
+	}
+
+	if (World->MeshCount == 0)
+	{
+		return false;
+	}
+
+	FWatertightRay WatertightRay = PrepareWatertightRay(Ray);
+
+	for (uint32 MeshIndex = 0; MeshIndex < World->MeshCount; ++MeshIndex)
+	{
+		const FTriangleMesh& Mesh = World->Meshes[MeshIndex];
+		const FBVH& BVH = Scene.Acceleration->MeshBVHs[MeshIndex];
+
+		bool bHitTriangle = TraverseBVHAnyHit(BVH, Ray, MaxDistance, [&](uint32 First, uint32 Count) -> bool
+		{
+			for (uint32 Index = First; Index < First + Count; ++Index)
+			{
+				const uint32* Indices = Mesh.Indices + 3 * (uint64)BVH.PrimitiveIndices[Index];
+
+				float HitDistance, U, V;
+				if (IntersectTriangle(Ray, WatertightRay, Mesh.Vertices[Indices[0]], Mesh.Vertices[Indices[1]], Mesh.Vertices[Indices[2]], HitDistance, U, V) && (HitDistance < MaxDistance))
+				{
+					return true;
+				}
+			}
+			return false;
+		});
+		if (bHitTriangle)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+internal void TraceShadowRays(const FKernelScene& Scene, const FShadowQueue& Shadows, FVector3* PathRadiance)
+{
+	for (uint32 RayIndex = 0; RayIndex < Shadows.Rays.Count; ++RayIndex)
+	{
+		if (!Occluded(Scene, Shadows.Rays.GetRay(RayIndex), BIG_NUMBER))
+		{
+			PathRadiance[Shadows.Rays.PathIndex[RayIndex]] += Shadows.Radiance[RayIndex];
+		}
+	}
+}
+
+/*
+ *---------------------------------------------------------------------------------
+ * Shading.
+ *---------------------------------------------------------------------------------
+ */
+
+/**
+ * Maps a point of the unit square to a direction of the hemisphere around the normal, with a density
+ *   proportional to the cosine between the direction and the normal.
+ */
+internal SM_INLINE FVector3 SampleCosineHemisphere(const FVector3& Normal, FVector2 Sample)
+{
+	// An orthonormal basis around the normal, without branches (Duff et al., 2017).
+	float Sign = Normal.Z >= 0.0F ? 1.0F : -1.0F;
+	float A = -1.0F / (Sign + Normal.Z);
+	float B = Normal.X * Normal.Y * A;
+	FVector3 Tangent = FVector3(1.0F + Sign * Normal.X * Normal.X * A, Sign * B, -Sign * Normal.X);
+	FVector3 Bitangent = FVector3(B, Sign + Normal.Y * Normal.Y * A, -Normal.Y);
+
+	float Radius = FMath::Sqrt(Sample.X);
+	float Angle = TWO_PI * Sample.Y;
+	float Height = FMath::Sqrt(FMath::Max(0.0F, 1.0F - Sample.X));
+	return Tangent * (Radius * FMath::FastCos(Angle)) + Bitangent * (Radius * FMath::FastSin(Angle)) + Normal * Height;
+}
+
+/** Maps a point of the unit square to a uniformly distributed direction. */
+internal SM_INLINE FVector3 SampleUniformSphere(FVector2 Sample)
+{
+	float Z = 1.0F - 2.0F * Sample.X;
+	float Radius = FMath::Sqrt(FMath::Max(0.0F, 1.0F - Z * Z));
+	float Angle = TWO_PI * Sample.Y;
+	return FVector3(Radius * FMath::FastCos(Angle), Radius * FMath::FastSin(Angle), Z);
+}
+
+/** @return The direction, mirrored around the normal. */
+internal SM_INLINE FVector3 Reflect(const FVector3& Direction, const FVector3& Normal)
+{
+	return Direction - Normal * (2.0F * (Direction | Normal));
+}
+
+internal void ShadeDiffuse(const FShadingContext& Context, const FShadingInput* Inputs, const uint32* Indices, uint32 Count, FShadingOutput* Outputs)
+{
+	for (uint32 Index = 0; Index < Count; ++Index)
+	{
+		const FShadingInput& Input = Inputs[Indices[Index]];
+		FShadingOutput& Output = Outputs[Indices[Index]];
+		const FMaterialDiffuse& Material = Context.Materials[Input.MaterialIndex].GetData<FMaterialDiffuse>();
+
+		float SunCosine = FMath::Max(0.0F, Input.Normal | Context.SunDirection);
+
+		Output.Emission = FVector3(0.0F);
+		Output.SunWeight = Material.Albedo * (SunCosine * INV_PI);
+
+		// Sampling proportionally to the cosine makes the BRDF and the pdf cancel out to the albedo.
+		Output.BounceDirection = SampleCosineHemisphere(Input.Normal, Input.DirectionSample);
+		Output.BounceWeight = Material.Albedo;
+		Output.bTransmitted = false;
+	}
+}
+
+internal void ShadeMetal(const FShadingContext& Context, const FShadingInput* Inputs, const uint32* Indices, uint32 Count, FShadingOutput* Outputs)
+{
+	for (uint32 Index = 0; Index < Count; ++Index)
+	{
+		const FShadingInput& Input = Inputs[Indices[Index]];
+		FShadingOutput& Output = Outputs[Indices[Index]];
+		const FMaterialMetal& Material = Context.Materials[Input.MaterialIndex].GetData<FMaterialMetal>();
+
+		// The mirror direction, perturbed by a random offset as long as the roughness.
+		FVector3A Perturbed = FVector3A(Reflect(Input.Direction, Input.Normal)) + FVector3A(SampleUniformSphere(Input.DirectionSample)) * Material.Roughness;
+		FVector3 Direction = Perturbed.GetNormal().ToVector3();
+
+		// The reflections are (nearly) specular, so the sun can't be gathered explicitly.
+		Output.Emission = FVector3(0.0F);
+		Output.SunWeight = FVector3(0.0F);
+		Output.BounceDirection = Direction;
+
+		// Perturbed directions that go into the surface are absorbed.
+		Output.BounceWeight = (Direction | Input.Normal) > 0.0F ? Material.Reflectance : FVector3(0.0F);
+		Output.bTransmitted = false;
+	}
+}
+
+internal void ShadeDielectric(const FShadingContext& Context, const FShadingInput* Inputs, const uint32* Indices, uint32 Count, FShadingOutput* Outputs)
+{
+	for (uint32 Index = 0; Index < Count; ++Index)
+	{
+		const FShadingInput& Input = Inputs[Indices[Index]];
+		FShadingOutput& Output = Outputs[Indices[Index]];
+		const FMaterialDielectric& Material = Context.Materials[Input.MaterialIndex].GetData<FMaterialDielectric>();
+
+		float RelativeIndex = Input.bFrontFace ? (1.0F / Material.IndexOfRefraction) : Material.IndexOfRefraction;
+		float CosineIn = FMath::Min(-(Input.Direction | Input.Normal), 1.0F);
+		float SineOutSquared = RelativeIndex * RelativeIndex * (1.0F - CosineIn * CosineIn);
+
+		// Schlick's approximation of the Fresnel reflectance.
+		float R0 = (1.0F - Material.IndexOfRefraction) / (1.0F + Material.IndexOfRefraction);
+		R0 = R0 * R0;
+		float OneMinusCosine = 1.0F - CosineIn;
+		float OneMinusCosine2 = OneMinusCosine * OneMinusCosine;
+		float Reflectance = R0 + (1.0F - R0) * OneMinusCosine2 * OneMinusCosine2 * OneMinusCosine;
+
+		Output.Emission = FVector3(0.0F);
+		Output.SunWeight = FVector3(0.0F);
+
+		// Either lobe is chosen with the probability of its Fresnel weight, so the weights cancel out.
+		if ((SineOutSquared > 1.0F) || (Input.LobeSample < Reflectance))
+		{
+			Output.BounceDirection = Reflect(Input.Direction, Input.Normal);
+			Output.BounceWeight = FVector3(1.0F);
+			Output.bTransmitted = false;
+		}
+		else
+		{
+			float CosineOut = FMath::Sqrt(1.0F - SineOutSquared);
+			FVector3A Refracted = FVector3A(Input.Direction) * RelativeIndex + FVector3A(Input.Normal) * (RelativeIndex * CosineIn - CosineOut);
+			Output.BounceDirection = Refracted.GetNormal().ToVector3();
+			Output.BounceWeight = Material.Tint;
+			Output.bTransmitted = true;
+		}
+	}
+}
+
+internal void ShadeEmissive(const FShadingContext& Context, const FShadingInput* Inputs, const uint32* Indices, uint32 Count, FShadingOutput* Outputs)
+{
+	for (uint32 Index = 0; Index < Count; ++Index)
+	{
+		const FShadingInput& Input = Inputs[Indices[Index]];
+		FShadingOutput& Output = Outputs[Indices[Index]];
+		const FMaterialEmissive& Material = Context.Materials[Input.MaterialIndex].GetData<FMaterialEmissive>();
+
+		Output.Emission = Material.Radiance;
+		Output.SunWeight = FVector3(0.0F);
+		Output.BounceDirection = Input.Normal;
+		Output.BounceWeight = FVector3(0.0F);
+		Output.bTransmitted = false;
+	}
+}
+
+/*
+ *---------------------------------------------------------------------------------
+ * Packing.
+ *---------------------------------------------------------------------------------
+ */
+
+internal SM_INLINE uint32 BGRAPackFloat4(FVector4 Unpacked)
+{
+	uint8 R = (uint8)(Unpacked.X * 255.0F);
+	uint8 G = (uint8)(Unpacked.Y * 255.0F);
+	uint8 B = (uint8)(Unpacked.Z * 255.0F);
+	uint8 A = (uint8)(Unpacked.W * 255.0F);
+	uint32 Result = (A << 24) | (R << 16) | (G << 8) | (B << 0);
+	return Result;
+}
+
+/** Same as the 'FVector4' version. The components must be in the [0, 1] range. */
+internal SM_INLINE uint32 BGRAPackFloat4(const FVector4A& Unpacked)
+{
+#if SM_SIMD_VECTORS
+	// Truncated like the casts, then reordered to B, G, R, A and narrowed to bytes (the values always fit).
+	__m128i Integers = _mm_cvttps_epi32(_mm_mul_ps(Unpacked.V, _mm_set1_ps(255.0F)));
+	Integers = _mm_shuffle_epi32(Integers, _MM_SHUFFLE(3, 0, 1, 2));
+	Integers = _mm_packus_epi32(Integers, Integers);
+	Integers = _mm_packus_epi16(Integers, Integers);
+	return (uint32)_mm_cvtsi128_si32(Integers);
+#else
+	return BGRAPackFloat4(Unpacked.ToVector4());
+#endif // SM_SIMD_VECTORS
+}
+
+/** @return The luminance of a linear color (Rec. 709 weights). */
+internal SM_INLINE float GetLuminance(const FVector4A& Color)
+{
+	return 0.2126F * Color.X + 0.7152F * Color.Y + 0.0722F * Color.Z;
+}
+
+internal void AccumulateAndResolve(FVector4* Accumulated, FPixelMoments* Moments, const FVector4* Colors, uint32 Count, float InvSampleCount, uint32* Pixels)
+{
+	for (uint32 Index = 0; Index < Count; ++Index)
+	{
+		FVector4A Sample = FVector4A(Colors[Index]);
+		FVector4A Sum = FVector4A(Accumulated[Index]) + Sample;
+		Sum.Store(Accumulated[Index]);
+
+		// The variance is estimated on the displayed (clamped) value; what the clamp hides doesn't need more samples.
+		float Luminance = GetLuminance(FVector4A::Clamp(Sample, FVector4A(0.0F), FVector4A(1.0F)));
+		Moments[Index].Sum += Luminance;
+		Moments[Index].SquaredSum += Luminance * Luminance;
+
+		FVector4A Mean = FVector4A::Clamp(Sum * InvSampleCount, FVector4A(0.0F), FVector4A(1.0F));
+		Pixels[Index] = BGRAPackFloat4(Mean);
+	}
+}
+
+// Declared 'extern' in the header, so the table is visible to the dispatcher.
+const FRenderKernels RENDER_KERNELS_TABLE =
+{
+	EKernelISA::RENDER_KERNELS_ISA,
+	RENDER_KERNELS_NAME,
+	TraceRay,
+	TraceRays,
+	Occluded,
+	TraceShadowRays,
+	{ ShadeDiffuse, ShadeMetal, ShadeDielectric, ShadeEmissive },
+	AccumulateAndResolve,
+};
@@ -0,0 +1,20 @@
+/**
+ *--------------------------------------------
+ * RenderKernelsAVX2.cpp <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 29 2022.
+ */
+
+// The build compiles this file with AVX2 and FMA, even when the rest of the binary targets a newer instruction set.
+#if !defined(__AVX2__)
+	#error RenderKernelsAVX2.cpp must be compiled with AVX2 enabled ('/arch:AVX2' or '-mavx2').
+#endif // !defined(__AVX2__)
+
+#define SM_SIMD_DISABLE_AVX512 1
+
+#define RENDER_KERNELS_TABLE GRenderKernelsAVX2
+#define RENDER_KERNELS_ISA   AVX2
+#define RENDER_KERNELS_NAME  "avx2"
+
+#include "Renderer/RenderKernels.inl"
@@ -0,0 +1,17 @@
+/**
+ *--------------------------------------------
+ * RenderKernelsSSE.cpp <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 29 2022.
+ */
+
+// The lane-wide types use SSE registers, whatever the file is compiled for. The build compiles it without
+//   AVX, so the compiler doesn't use AVX on its own either.
+#define SM_SIMD_DISABLE_AVX2   1
+
+#define RENDER_KERNELS_TABLE GRenderKernelsSSE
+#define RENDER_KERNELS_ISA   SSE
+#define RENDER_KERNELS_NAME  "sse"
+
+#include "Renderer/RenderKernels.inl"
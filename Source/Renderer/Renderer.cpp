@@ -8,22 +8,66 @@
 
 #include "Renderer.h"
 
-inline uint32 BGRAPackFloat4(FVector4 Unpacked)
-{
-	uint8 R = (uint8)(Unpacked.X * 255.0F);
-	uint8 G = (uint8)(Unpacked.Y * 255.0F);
-	uint8 B = (uint8)(Unpacked.Z * 255.0F);
-	uint8 A = (uint8)(Unpacked.W * 255.0F);
-	uint32 Result = (A << 24) | (R << 16) | (G << 8) | (B << 0);
-	return Result;
-}
+#include "Core/Jobs/JobSystem.h"
+#include "Core/Math/Vector3A.h"
+#include "Core/Math/Vector3Wide.h"
+#include "Core/Platform/Platform.h"
+#include "Core/Profiling/Profiler.h"
+#include "Core/Memory/Memory.h"
+#include "Renderer/MaterialTable.h"
+#include "Renderer/RenderKernels.h"
+#include "Renderer/Wavefront.h"
+
+#include <cstdlib>
+
+/** The width and height (in pixels) of the blocks whose convergence is tracked. As wide as a ray packet. */
+#define SAMPLE_BLOCK_SIZE 8
+
+/** The number of pixels of a block, which is the most paths traced together. */
+#define SAMPLE_BLOCK_PIXEL_COUNT (SAMPLE_BLOCK_SIZE * SAMPLE_BLOCK_SIZE)
+
+/**
+ * The dimensions of a sample, as consumed from the sampler: the position inside the pixel, and then
+ *   the direction (2D), the lobe choice (1D) and the Russian roulette decision (1D) of every bounce.
+ */
+#define SAMPLE_DIMENSION_PIXEL        0
+#define SAMPLE_DIMENSION_FIRST_BOUNCE 2
+#define SAMPLE_DIMENSIONS_PER_BOUNCE  4
+
+/** The probability of a path to survive Russian roulette never exceeds this, so every path eventually ends. */
+#define RUSSIAN_ROULETTE_MAX_SURVIVAL 0.95F
+
+/** The distance by which the rays leaving a surface are offset along its normal, so they don't hit the surface again. */
+#define RAY_ORIGIN_OFFSET             1e-3F
 
 FRenderer::FRenderer()
 	: World(nullptr)
 	, ImageTarget(nullptr)
-{}
+	, Acceleration(nullptr)
+	, Kernels(&FKernelDispatch::GetKernels())
+	, Accumulation(nullptr)
+	, Moments(nullptr)
+	, Tiles(nullptr)
+	, TileCountX(0)
+	, TileCount(0)
+	, Blocks(nullptr)
+	, BlockCountPerTileAxis(0)
+	, BlockCountPerTile(0)
+	, PassCount(0)
+	, RenderTimeSeconds(0.0)
+	, RayCounters(nullptr)
+	, RayCounterCount(0)
+{
+	ImageArena.Initialize("Image");
+}
+
+FRenderer::~FRenderer()
+{
+	OwnedAcceleration.Release();
+	ImageArena.Release();
+}
 
-void FRenderer::SetWorld(const FWorld* InWorld)
+void FRenderer::SetWorld(const FWorld* InWorld, const FWorldAcceleration* PrebuiltAcceleration)
 {
 	World = InWorld;
 
@@ -35,50 +79,494 @@ void FRenderer::SetWorld(const FWorld* InWorld)
 	CameraData.FilmHeight = 1;
 	CameraData.FilmWidth = CameraData.FilmHeight * World->Camera.AspectRatio;
 	CameraData.FilmCenter = World->Camera.Position + CameraData.AxisZ;
+
+	if (PrebuiltAcceleration)
+	{
+		OwnedAcceleration.Release();
+		Acceleration = PrebuiltAcceleration;
+	}
+	else
+	{
+		OwnedAcceleration.Build(*World, Settings.BVHSettings);
+		Acceleration = &OwnedAcceleration;
+	}
+
+	ResetAccumulation();
 }
 
 void FRenderer::SetImageTarget(const FImage* InImageTarget)
 {
 	ImageTarget = InImageTarget;
+	AllocateImageBuffers();
+}
+
+void FRenderer::SetSettings(const FRenderSettings& InSettings)
+{
+	Settings = InSettings;
+	if (Settings.TileSize == 0)
+	{
+		Settings.TileSize = 1;
+	}
+	if (Settings.MaxSampleCount == 0)
+	{
+		Settings.MaxSampleCount = 1;
+	}
+	Settings.AdaptiveMinSampleCount = FMath::Max(Settings.AdaptiveMinSampleCount, 2U);
+
+	// The tile grid depends on the tile size.
+	if (ImageTarget)
+	{
+		AllocateImageBuffers();
+	}
+	ResetAccumulation();
+}
+
+void FRenderer::AllocateImageBuffers()
+{
+	uint32 TileSize = Settings.TileSize;
+	TileCountX = (ImageTarget->Width + TileSize - 1) / TileSize;
+	TileCount = TileCountX * ((ImageTarget->Height + TileSize - 1) / TileSize);
+
+	BlockCountPerTileAxis = (TileSize + SAMPLE_BLOCK_SIZE - 1) / SAMPLE_BLOCK_SIZE;
+	BlockCountPerTile = BlockCountPerTileAxis * BlockCountPerTileAxis;
+
+	uint64 PixelCount = (uint64)ImageTarget->Width * ImageTarget->Height;
+	ImageArena.Reset();
+	Accumulation = ImageArena.PushArray<FVector4>(PixelCount, CACHE_LINE_SIZE);
+	Moments = ImageArena.PushArray<FPixelMoments>(PixelCount, CACHE_LINE_SIZE);
+	Tiles = ImageArena.PushArray<FTileState>(TileCount, CACHE_LINE_SIZE);
+	Blocks = ImageArena.PushArray<FSampleBlock>((uint64)TileCount * BlockCountPerTile, CACHE_LINE_SIZE);
+
+	RayCounterCount = FMath::Max(FJobSystem::GetThreadCount(), 1U);
+	RayCounters = ImageArena.PushArray<FRayCounters>(RayCounterCount, CACHE_LINE_SIZE);
+
+	ResetAccumulation();
+}
+
+void FRenderer::ResetAccumulation()
+{
+	// The pixel buffers are cleared lazily: the first sample of a block overwrites them instead of adding to them.
+	for (uint32 TileIndex = 0; TileIndex < TileCount; ++TileIndex)
+	{
+		FTileState& Tile = Tiles[TileIndex];
+		Tile.ActiveBlockCount = 0;
+
+		for (uint32 BlockIndex = 0; BlockIndex < BlockCountPerTile; ++BlockIndex)
+		{
+			// The blocks that fall outside the image (in the tiles at the right and bottom edges) never need samples.
+			FSampleBlock& Block = Blocks[(uint64)TileIndex * BlockCountPerTile + BlockIndex];
+			Block = {};
+			Block.bConverged = (GetBlockPixelCount(TileIndex, BlockIndex) == 0);
+			Tile.ActiveBlockCount += Block.bConverged ? 0 : 1;
+		}
+	}
+	PassCount = 0;
+
+	RenderTimeSeconds = 0.0;
+	for (uint32 CounterIndex = 0; CounterIndex < RayCounterCount; ++CounterIndex)
+	{
+		RayCounters[CounterIndex] = {};
+	}
 }
 
 void FRenderer::Render()
 {
-	uint32* Pixel = ImageTarget->Pixels;
-	for (uint32 Y = 0; Y < ImageTarget->Height; ++Y)
+	SM_PROFILE_SCOPE("Render");
+
+	ResetAccumulation();
+	RenderPass();
+}
+
+uint32 FRenderer::RenderProgressive(float64 TimeBudgetSeconds)
+{
+	SM_PROFILE_SCOPE("RenderProgressive");
+
+	float64 StartTime = FPlatform::GetTimeSeconds();
+	float64 EndTime = StartTime + TimeBudgetSeconds;
+
+	uint32 RenderedPassCount = 0;
+	float64 PassStartTime = StartTime;
+	for (;;)
+	{
+		uint32 ActiveBlockCount = RenderPass();
+		++RenderedPassCount;
+		if (ActiveBlockCount == 0)
+		{
+			break;
+		}
+
+		// Assume the next pass takes as long as the last one. Passes get cheaper as blocks converge, so this is conservative.
+		float64 Now = FPlatform::GetTimeSeconds();
+		float64 PassDuration = Now - PassStartTime;
+		if (Now + PassDuration > EndTime)
+		{
+			break;
+		}
+		PassStartTime = Now;
+	}
+
+	return RenderedPassCount;
+}
+
+uint32 FRenderer::RenderPass()
+{
+	SM_PROFILE_SCOPE("RenderPass");
+	float64 StartTime = FPlatform::GetTimeSeconds();
+
+	// The tiles are disjoint, so the pixels can be written without any synchronization.
+	FJobSystem::ParallelFor(TileCount, 1, [this](uint32 TileBegin, uint32 TileEnd)
+	{
+		for (uint32 TileIndex = TileBegin; TileIndex < TileEnd; ++TileIndex)
+		{
+			if (Tiles[TileIndex].ActiveBlockCount > 0)
+			{
+				RenderTile(TileIndex);
+			}
+		}
+	});
+	++PassCount;
+	RenderTimeSeconds += FPlatform::GetTimeSeconds() - StartTime;
+	SM_PROFILE_SAMPLE_COUNTERS();
+
+	uint32 ActiveBlockCount = 0;
+	for (uint32 TileIndex = 0; TileIndex < TileCount; ++TileIndex)
+	{
+		ActiveBlockCount += Tiles[TileIndex].ActiveBlockCount;
+	}
+	return ActiveBlockCount;
+}
+
+FRenderer::FRenderStats FRenderer::GetStats() const
+{
+	FRenderStats Stats = {};
+	Stats.PassCount = PassCount;
+
+	for (uint32 TileIndex = 0; TileIndex < TileCount; ++TileIndex)
+	{
+		for (uint32 BlockIndex = 0; BlockIndex < BlockCountPerTile; ++BlockIndex)
+		{
+			uint32 PixelCount = GetBlockPixelCount(TileIndex, BlockIndex);
+			if (PixelCount == 0)
+			{
+				continue;
+			}
+
+			const FSampleBlock& Block = Blocks[(uint64)TileIndex * BlockCountPerTile + BlockIndex];
+			Stats.SampleCount += (uint64)PixelCount * Block.SampleCount;
+			Stats.BlockCount += 1;
+			Stats.ConvergedBlockCount += Block.bConverged ? 1 : 0;
+		}
+	}
+
+	for (uint32 CounterIndex = 0; CounterIndex < RayCounterCount; ++CounterIndex)
+	{
+		const FRayCounters& Counters = RayCounters[CounterIndex];
+		Stats.PrimaryRayCount += Counters.PrimaryRayCount;
+		Stats.SecondaryRayCount += Counters.SecondaryRayCount;
+		Stats.ShadowRayCount += Counters.ShadowRayCount;
+		Stats.HitCount += Counters.HitCount;
+	}
+	Stats.RenderTimeSeconds = RenderTimeSeconds;
+
+	return Stats;
+}
+
+FRenderer::FRayCounters& FRenderer::GetRayCounters()
+{
+	uint32 ThreadIndex = FJobSystem::GetCurrentThreadIndex();
+	return RayCounters[(ThreadIndex < RayCounterCount) ? ThreadIndex : 0];
+}
+
+void FRenderer::GetBlockBounds(uint32 TileIndex, uint32 BlockIndex, out uint32& MinX, out uint32& MinY, out uint32& MaxX, out uint32& MaxY) const
+{
+	uint32 TileMinX = (TileIndex % TileCountX) * Settings.TileSize;
+	uint32 TileMinY = (TileIndex / TileCountX) * Settings.TileSize;
+	uint32 TileMaxX = FMath::Min(TileMinX + Settings.TileSize, ImageTarget->Width);
+	uint32 TileMaxY = FMath::Min(TileMinY + Settings.TileSize, ImageTarget->Height);
+
+	MinX = FMath::Min(TileMinX + (BlockIndex % BlockCountPerTileAxis) * SAMPLE_BLOCK_SIZE, TileMaxX);
+	MinY = FMath::Min(TileMinY + (BlockIndex / BlockCountPerTileAxis) * SAMPLE_BLOCK_SIZE, TileMaxY);
+	MaxX = FMath::Min(MinX + SAMPLE_BLOCK_SIZE, TileMaxX);
+	MaxY = FMath::Min(MinY + SAMPLE_BLOCK_SIZE, TileMaxY);
+}
+
+uint32 FRenderer::GetBlockPixelCount(uint32 TileIndex, uint32 BlockIndex) const
+{
+	uint32 MinX, MinY, MaxX, MaxY;
+	GetBlockBounds(TileIndex, BlockIndex, MinX, MinY, MaxX, MaxY);
+	return (MaxX - MinX) * (MaxY - MinY);
+}
+
+void FRenderer::RenderTile(uint32 TileIndex)
+{
+	SM_PROFILE_SCOPE_INDEX("RenderTile", TileIndex);
+	SM_PROFILE_TIMER(RenderTile);
+
+	if (Settings.bUseWavefront && (Settings.Integrator == EIntegrator::PathTracing))
+	{
+		RenderTileWavefront(TileIndex);
+		return;
+	}
+
+	FTileState& Tile = Tiles[TileIndex];
+	FSampleBlock* TileBlocks = Blocks + (uint64)TileIndex * BlockCountPerTile;
+
+	for (uint32 BlockIndex = 0; BlockIndex < BlockCountPerTile; ++BlockIndex)
+	{
+		FSampleBlock& Block = TileBlocks[BlockIndex];
+		if (Block.bConverged)
+		{
+			continue;
+		}
+
+		uint32 MinX, MinY, MaxX, MaxY;
+		GetBlockBounds(TileIndex, BlockIndex, MinX, MinY, MaxX, MaxY);
+		RenderBlock(Block, MinX, MinY, MaxX, MaxY);
+		UpdateBlockConvergence(Tile, Block, MinX, MinY, MaxX, MaxY);
+	}
+}
+
+void FRenderer::UpdateBlockConvergence(FTileState& Tile, FSampleBlock& Block, uint32 MinX, uint32 MinY, uint32 MaxX, uint32 MaxY)
+{
+	// A block stops receiving samples once it has converged, or once it has the maximum number of them.
+	bool bDone = (Block.SampleCount >= Settings.MaxSampleCount);
+	if (Settings.bAdaptiveSampling && (Block.SampleCount >= Settings.AdaptiveMinSampleCount))
+	{
+		bDone = bDone || IsBlockConverged(MinX, MinY, MaxX, MaxY, Block.SampleCount);
+	}
+
+	if (bDone)
+	{
+		Block.bConverged = true;
+		--Tile.ActiveBlockCount;
+	}
+}
+
+void FRenderer::RenderBlock(FSampleBlock& Block, uint32 MinX, uint32 MinY, uint32 MaxX, uint32 MaxY)
+{
+	uint32 SampleIndex = Block.SampleCount;
+	uint32 Width = MaxX - MinX;
+	uint32 PixelCount = Width * (MaxY - MinY);
+
+	// A block is as wide as a packet, so every row is traced as one.
+	FRay Rays[SAMPLE_BLOCK_PIXEL_COUNT];
+	FHitPayload Payloads[SAMPLE_BLOCK_PIXEL_COUNT];
+	for (uint32 Y = MinY; Y < MaxY; ++Y)
 	{
-		for (uint32 X = 0; X < ImageTarget->Width; ++X)
+		uint32 RowOffset = (Y - MinY) * Width;
+		TracePrimaryRays(MinX, Y, Width, SampleIndex, Rays + RowOffset, Payloads + RowOffset);
+	}
+
+	FRayCounters& Counters = GetRayCounters();
+	Counters.PrimaryRayCount += PixelCount;
+	for (uint32 PixelIndex = 0; PixelIndex < PixelCount; ++PixelIndex)
+	{
+		Counters.HitCount += (Payloads[PixelIndex].HitDistance > 0) ? 1 : 0;
+	}
+
+	FVector4 Colors[SAMPLE_BLOCK_PIXEL_COUNT];
+	if (Settings.Integrator == EIntegrator::DirectLighting)
+	{
+		for (uint32 PixelIndex = 0; PixelIndex < PixelCount; ++PixelIndex)
 		{
-			FVector4 Color = PerPixel(X, Y);
-			Color = FVector4::Clamp(Color, FVector4(0.0F), FVector4(1.0F));
-			*Pixel++ = BGRAPackFloat4(Color);
+			Colors[PixelIndex] = ShadeDirectLighting(Payloads[PixelIndex]);
 		}
 	}
+	else
+	{
+		TracePaths(MinX, MinY, Width, PixelCount, SampleIndex, Rays, Payloads, Colors, Counters);
+	}
+
+	AccumulateBlock(Block, MinX, MinY, MaxX, MaxY, Colors);
 }
 
-FVector4 FRenderer::PerPixel(uint32 PixelX, uint32 PixelY)
+void FRenderer::AccumulateBlock(FSampleBlock& Block, uint32 MinX, uint32 MinY, uint32 MaxX, uint32 MaxY, const FVector4* Colors)
 {
-	float FilmX = ((float)PixelX / (float)ImageTarget->Width) - 0.5F;
-	float FilmY = ((float)PixelY / (float)ImageTarget->Height) - 0.5F;
+	uint32 SampleIndex = Block.SampleCount;
+
+	// The first sample of a pixel replaces whatever the buffers hold.
+	bool bFirstSample = (SampleIndex == 0);
+	float InvSampleCount = 1.0F / (float)(SampleIndex + 1);
+
+	uint32 Width = MaxX - MinX;
+	const FVector4* RowColors = Colors;
+	for (uint32 Y = MinY; Y < MaxY; ++Y, RowColors += Width)
+	{
+		uint64 RowOffset = (uint64)Y * ImageTarget->Width + MinX;
+		uint32* Pixels = ImageTarget->Pixels + RowOffset;
+		FVector4* Accumulated = Accumulation + RowOffset;
+		FPixelMoments* PixelMoments = Moments + RowOffset;
+		if (bFirstSample)
+		{
+			for (uint32 X = MinX; X < MaxX; ++X)
+			{
+				Accumulated[X - MinX] = FVector4(0.0F);
+				PixelMoments[X - MinX] = {};
+			}
+		}
+
+		Kernels->AccumulateAndResolve(Accumulated, PixelMoments, RowColors, Width, InvSampleCount, Pixels);
+	}
+
+	Block.SampleCount = SampleIndex + 1;
+}
+
+bool FRenderer::IsBlockConverged(uint32 MinX, uint32 MinY, uint32 MaxX, uint32 MaxY, uint32 SampleCount) const
+{
+	float N = (float)SampleCount;
+
+	// Compared against the variance of the mean, to avoid a square root per pixel.
+	float MaxVarianceOfMean = Settings.AdaptiveErrorThreshold * Settings.AdaptiveErrorThreshold;
+
+	for (uint32 Y = MinY; Y < MaxY; ++Y)
+	{
+		const FPixelMoments* PixelMoments = Moments + (uint64)Y * ImageTarget->Width + MinX;
+		for (uint32 X = MinX; X < MaxX; ++X, ++PixelMoments)
+		{
+			// Unbiased sample variance, divided by N for the variance of the mean.
+			float Variance = (PixelMoments->SquaredSum - PixelMoments->Sum * PixelMoments->Sum / N) / (N - 1.0F);
+			if (Variance > MaxVarianceOfMean * N)
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+void FRenderer::TracePrimaryRays(uint32 PixelX, uint32 PixelY, uint32 PixelCount, uint32 SampleIndex, FRay* Rays, FHitPayload* Payloads)
+{
+	if (!Settings.bUseRayPackets)
+	{
+		for (uint32 Index = 0; Index < PixelCount; ++Index)
+		{
+			Rays[Index] = GetPrimaryRay(PixelX + Index, PixelY, SampleIndex);
+			Payloads[Index] = TraceRay(Rays[Index]);
+		}
+		return;
+	}
+
+	SM_PROFILE_TIMER(TraceRay);
+	SM_PROFILE_COUNT(TracedRays, PixelCount);
+
+	// The packet is handed to the kernels as a queue of a single packet.
+	FRayPacket8 Packet = GetPrimaryRayPacket(PixelX, PixelY, PixelCount, SampleIndex);
+
+	alignas(32) float Components[6][8];
+	FRayQueue PacketRays;
+	PacketRays.OriginX = Components[0];
+	PacketRays.OriginY = Components[1];
+	PacketRays.OriginZ = Components[2];
+	PacketRays.DirectionX = Components[3];
+	PacketRays.DirectionY = Components[4];
+	PacketRays.DirectionZ = Components[5];
+	PacketRays.PathIndex = nullptr;
+	PacketRays.Count = PixelCount;
+	Packet.OriginX.Store(PacketRays.OriginX);
+	Packet.OriginY.Store(PacketRays.OriginY);
+	Packet.OriginZ.Store(PacketRays.OriginZ);
+	Packet.DirectionX.Store(PacketRays.DirectionX);
+	Packet.DirectionY.Store(PacketRays.DirectionY);
+	Packet.DirectionZ.Store(PacketRays.DirectionZ);
+
+	alignas(32) float HitDistance[8];
+	uint32 ObjectIndex[8];
+	uint32 PrimitiveIndex[8];
+	FHitQueue PacketHits;
+	PacketHits.HitDistance = HitDistance;
+	PacketHits.ObjectIndex = ObjectIndex;
+	PacketHits.PrimitiveIndex = PrimitiveIndex;
+	Kernels->TraceRays(GetKernelScene(), PacketRays, PacketHits, true);
+
+	for (uint32 Lane = 0; Lane < PixelCount; ++Lane)
+	{
+		Rays[Lane] = PacketRays.GetRay(Lane);
+		if (ObjectIndex[Lane] != UINT32_MAX)
+		{
+			Payloads[Lane] = ClosestHit(Rays[Lane], HitDistance[Lane], ObjectIndex[Lane], PrimitiveIndex[Lane]);
+		}
+		else
+		{
+			Payloads[Lane] = Miss(Rays[Lane]);
+		}
+	}
+}
+
+FRay FRenderer::GetPrimaryRay(uint32 PixelX, uint32 PixelY, uint32 SampleIndex)
+{
+	FVector2 SampleOffset = GetSampleOffset(PixelX, PixelY, SampleIndex);
+	float FilmX = (((float)PixelX + SampleOffset.X) / (float)ImageTarget->Width) - 0.5F;
+	float FilmY = (((float)PixelY + SampleOffset.Y) / (float)ImageTarget->Height) - 0.5F;
+
+	FVector3A Direction = FVector3A(CameraData.FilmCenter)
+		+ (FilmX * CameraData.FilmWidth * FVector3A(CameraData.AxisX))
+		+ (FilmY * CameraData.FilmHeight * FVector3A(CameraData.AxisY))
+		- FVector3A(World->Camera.Position);
 
 	FRay Ray;
 	Ray.Origin = World->Camera.Position;
-	Ray.Direction = CameraData.FilmCenter + (FilmX * CameraData.FilmWidth * CameraData.AxisX) + (FilmY * CameraData.FilmHeight * CameraData.AxisY) - World->Camera.Position;
-	Ray.Direction = Ray.Direction.GetNormal();
+	Ray.Direction = Direction.GetNormal().ToVector3();
+	return Ray;
+}
 
+FRayPacket8 FRenderer::GetPrimaryRayPacket(uint32 PixelX, uint32 PixelY, uint32 PixelCount, uint32 SampleIndex)
+{
+	alignas(32) float PixelXs[8];
+	alignas(32) float PixelYs[8];
+	for (uint32 Lane = 0; Lane < 8; ++Lane)
+	{
+		FVector2 SampleOffset = GetSampleOffset(PixelX + Lane, PixelY, SampleIndex);
+		PixelXs[Lane] = (float)(PixelX + Lane) + SampleOffset.X;
+		PixelYs[Lane] = (float)PixelY + SampleOffset.Y;
+	}
+
+	// Same expressions as 'GetPrimaryRay', evaluated in the same order, so the rays are identical.
+	FFloat8 FilmX = FFloat8::Load(PixelXs) / FFloat8::Set((float)ImageTarget->Width) - FFloat8::Set(0.5F);
+	FFloat8 FilmY = FFloat8::Load(PixelYs) / FFloat8::Set((float)ImageTarget->Height) - FFloat8::Set(0.5F);
+
+	FFloat8 FilmXWidth = FilmX * FFloat8::Set(CameraData.FilmWidth);
+	FFloat8 FilmYHeight = FilmY * FFloat8::Set(CameraData.FilmHeight);
+	const FVector3& Position = World->Camera.Position;
+
+	FVector3Wide8 Direction = ((FVector3Wide8::Set(CameraData.FilmCenter) + FVector3Wide8::Set(CameraData.AxisX) * FilmXWidth) + FVector3Wide8::Set(CameraData.AxisY) * FilmYHeight) - FVector3Wide8::Set(Position);
+	Direction = Direction.GetNormal();
+
+	FRayPacket8 Packet;
+	Packet.OriginX = FFloat8::Set(Position.X);
+	Packet.OriginY = FFloat8::Set(Position.Y);
+	Packet.OriginZ = FFloat8::Set(Position.Z);
+	Packet.DirectionX = Direction.X;
+	Packet.DirectionY = Direction.Y;
+	Packet.DirectionZ = Direction.Z;
+	Packet.ActiveMask = FMask8::FromBits((1U << PixelCount) - 1);
+	return Packet;
+}
+
+FVector2 FRenderer::GetSampleOffset(uint32 PixelX, uint32 PixelY, uint32 SampleIndex) const
+{
+	if (SampleIndex == 0)
+	{
+		return FVector2(0.0F, 0.0F);
+	}
+
+	return FSampler::Get2D(Settings.Sampler, PixelX, PixelY, SampleIndex, SAMPLE_DIMENSION_PIXEL);
+}
+
+FVector4 FRenderer::ShadeDirectLighting(const FHitPayload& Payload)
+{
 	FVector4 Result = FVector4(0.0F);
 
-	FHitPayload Payload = TraceRay(Ray);
 	if (Payload.HitDistance > 0)
 	{
-		const FMaterial* AbstractMaterial = World->Materials + Payload.MaterialIndex;
-		const FMaterialDefault* Material = (const FMaterialDefault*)(AbstractMaterial->AbstractMaterialData);
+		// Every built-in material type starts with its base color.
+		const FVector3& Color = World->Materials[Payload.MaterialIndex].GetData<FVector3>();
 
 		FVector3 LightDirection = { -1, 1, -1 };
 		LightDirection = LightDirection.GetNormal();
 
 		float LightIntensity = FMath::Max(0.075F, (-LightDirection) | Payload.WorldNormal);
-		Result = FVector4(Material->Color * LightIntensity, 1);
+		Result = FVector4(Color * LightIntensity, 1);
 	}
 	else
 	{
@@ -88,73 +576,430 @@ FVector4 FRenderer::PerPixel(uint32 PixelX, uint32 PixelY)
 	return Result;
 }
 
-FRenderer::FHitPayload FRenderer::TraceRay(const FRay& Ray)
+void FRenderer::TracePaths(uint32 MinX, uint32 MinY, uint32 Width, uint32 PathCount, uint32 SampleIndex, FRay* Rays, FHitPayload* Payloads, FVector4* Colors, FRayCounters& Counters)
 {
-	float ClosestHitDistance = BIG_NUMBER;
-	uint32 ObjectIndex = UINT32_MAX;
+	const FEnvironment& Environment = World->Environment;
+
+	FVector3 Radiance[SAMPLE_BLOCK_PIXEL_COUNT];
+	FVector3 Throughput[SAMPLE_BLOCK_PIXEL_COUNT];
+	uint32 ActivePaths[SAMPLE_BLOCK_PIXEL_COUNT];
+	for (uint32 PathIndex = 0; PathIndex < PathCount; ++PathIndex)
+	{
+		Radiance[PathIndex] = FVector3(0.0F);
+		Throughput[PathIndex] = FVector3(1.0F);
+		ActivePaths[PathIndex] = PathIndex;
+	}
+	uint32 ActiveCount = PathCount;
+
+	FShadingContext Context;
+	Context.Materials = World->Materials;
+	Context.SunDirection = Environment.SunDirection;
 
-	for (uint32 PlaneIndex = 0; PlaneIndex < World->PlaneCount; ++PlaneIndex)
+	FShadingInput Inputs[SAMPLE_BLOCK_PIXEL_COUNT];
+	FShadingOutput Outputs[SAMPLE_BLOCK_PIXEL_COUNT];
+
+	// The paths advance together, one bounce at a time, so the hits of a bounce are shaded together.
+	for (uint32 Depth = 0; ActiveCount > 0; ++Depth)
 	{
-		const FPlane* Plane = World->Planes + PlaneIndex;
+		uint32 Dimension = SAMPLE_DIMENSION_FIRST_BOUNCE + Depth * SAMPLE_DIMENSIONS_PER_BOUNCE;
+
+		// The paths that escaped the world gather the sky; the hits of the others are shaded.
+		uint32 HitCount = 0;
+		for (uint32 ActiveIndex = 0; ActiveIndex < ActiveCount; ++ActiveIndex)
+		{
+			uint32 PathIndex = ActivePaths[ActiveIndex];
+			const FHitPayload& Payload = Payloads[PathIndex];
+			if (Payload.HitDistance < 0)
+			{
+				Radiance[PathIndex] += Throughput[PathIndex] * Environment.SkyRadiance;
+				continue;
+			}
 
-		float HitDistance;
-		if (IntersectPlane(Ray, Plane->Normal, Plane->Distance, HitDistance))
+			uint32 PixelX = MinX + PathIndex % Width;
+			uint32 PixelY = MinY + PathIndex / Width;
+
+			// Surfaces are shaded on the side the ray comes from.
+			FShadingInput& Input = Inputs[HitCount];
+			Input.Direction = Rays[PathIndex].Direction;
+			Input.Normal = Payload.WorldNormal;
+			if ((Input.Normal | Input.Direction) > 0)
+			{
+				Input.Normal = -Input.Normal;
+			}
+			Input.DirectionSample = FSampler::Get2D(Settings.Sampler, PixelX, PixelY, SampleIndex, Dimension);
+			Input.LobeSample = FSampler::Get1D(Settings.Sampler, PixelX, PixelY, SampleIndex, Dimension + 2);
+			Input.MaterialIndex = Payload.MaterialIndex;
+			Input.bFrontFace = Payload.bFrontFace;
+
+			ActivePaths[HitCount++] = PathIndex;
+		}
+
+		FMaterialTable::Shade(Context, Inputs, HitCount, Outputs, Kernels->ShadeMaterials);
+
+		ActiveCount = 0;
+		for (uint32 HitIndex = 0; HitIndex < HitCount; ++HitIndex)
 		{
-			if ((HitDistance > 0) && (HitDistance < ClosestHitDistance))
+			uint32 PathIndex = ActivePaths[HitIndex];
+			const FShadingInput& Input = Inputs[HitIndex];
+			const FShadingOutput& Output = Outputs[HitIndex];
+			const FVector3& Position = Payloads[PathIndex].WorldPosition;
+
+			Radiance[PathIndex] += Throughput[PathIndex] * Output.Emission;
+
+			// The sun is infinitely small, so it can't be hit by chance; its light is gathered explicitly, at every surface.
+			if (FMath::Max(FMath::Max(Output.SunWeight.X, Output.SunWeight.Y), Output.SunWeight.Z) > 0)
+			{
+				FRay ShadowRay;
+				ShadowRay.Origin = Position + Input.Normal * RAY_ORIGIN_OFFSET;
+				ShadowRay.Direction = Environment.SunDirection;
+				++Counters.ShadowRayCount;
+				if (!Occluded(ShadowRay, BIG_NUMBER))
+				{
+					Radiance[PathIndex] += Throughput[PathIndex] * Output.SunWeight * Environment.SunIrradiance;
+				}
+			}
+
+			if (Depth + 1 >= Settings.MaxPathDepth)
+			{
+				continue;
+			}
+
+			FVector3& PathThroughput = Throughput[PathIndex];
+			PathThroughput *= Output.BounceWeight;
+
+			float MaxThroughput = FMath::Max(FMath::Max(PathThroughput.X, PathThroughput.Y), PathThroughput.Z);
+			if (MaxThroughput < Settings.MinPathThroughput)
 			{
-				ClosestHitDistance = HitDistance;
-				ObjectIndex = PlaneIndex;
+				continue;
 			}
+
+			if (Depth + 1 >= Settings.RussianRouletteDepth)
+			{
+				uint32 PixelX = MinX + PathIndex % Width;
+				uint32 PixelY = MinY + PathIndex / Width;
+
+				float SurvivalProbability = FMath::Min(MaxThroughput, RUSSIAN_ROULETTE_MAX_SURVIVAL);
+				if (FSampler::Get1D(Settings.Sampler, PixelX, PixelY, SampleIndex, Dimension + 3) >= SurvivalProbability)
+				{
+					continue;
+				}
+				PathThroughput *= 1.0F / SurvivalProbability;
+			}
+
+			FRay& Ray = Rays[PathIndex];
+			Ray.Origin = Position + Input.Normal * (Output.bTransmitted ? -RAY_ORIGIN_OFFSET : RAY_ORIGIN_OFFSET);
+			Ray.Direction = Output.BounceDirection;
+			ActivePaths[ActiveCount++] = PathIndex;
+		}
+
+		for (uint32 ActiveIndex = 0; ActiveIndex < ActiveCount; ++ActiveIndex)
+		{
+			uint32 PathIndex = ActivePaths[ActiveIndex];
+			Payloads[PathIndex] = TraceRay(Rays[PathIndex]);
+			Counters.HitCount += (Payloads[PathIndex].HitDistance > 0) ? 1 : 0;
 		}
+		Counters.SecondaryRayCount += ActiveCount;
 	}
 
-	for (uint32 SphereIndex = 0; SphereIndex < World->SphereCount; ++SphereIndex)
+	for (uint32 PathIndex = 0; PathIndex < PathCount; ++PathIndex)
+	{
+		Colors[PathIndex] = FVector4(Radiance[PathIndex], 1);
+	}
+}
+
+void FRenderer::RenderTileWavefront(uint32 TileIndex)
+{
+	FTileState& Tile = Tiles[TileIndex];
+	FSampleBlock* TileBlocks = Blocks + (uint64)TileIndex * BlockCountPerTile;
+
+	FMemoryArena& ScratchArena = FMemory::GetScratchArena();
+	FScopedTemporaryMemory ScratchMemory(ScratchArena);
+
+	FWavefront Wavefront;
+	Wavefront.Allocate(ScratchArena, BlockCountPerTile * SAMPLE_BLOCK_PIXEL_COUNT);
+
+	// Generate: a path for every pixel of the blocks that still need samples, block after block, row by row.
+	FPathQueue& Paths = Wavefront.Paths;
+	for (uint32 BlockIndex = 0; BlockIndex < BlockCountPerTile; ++BlockIndex)
 	{
-		const FSphere* Sphere = World->Spheres + SphereIndex;
-	
-		float HitDistance;
-		if (IntersectSphere(Ray, Sphere->Position, Sphere->Radius, HitDistance))
+		const FSampleBlock& Block = TileBlocks[BlockIndex];
+		if (Block.bConverged)
+		{
+			continue;
+		}
+
+		uint32 MinX, MinY, MaxX, MaxY;
+		GetBlockBounds(TileIndex, BlockIndex, MinX, MinY, MaxX, MaxY);
+		for (uint32 Y = MinY; Y < MaxY; ++Y)
 		{
-			if ((HitDistance > 0) && (HitDistance < ClosestHitDistance))
+			// A block is as wide as a packet, so the rays of a row are generated as one.
+			FRayPacket8 Packet = GetPrimaryRayPacket(MinX, Y, MaxX - MinX, Block.SampleCount);
+			alignas(32) float Components[6][8];
+			Packet.OriginX.Store(Components[0]);
+			Packet.OriginY.Store(Components[1]);
+			Packet.OriginZ.Store(Components[2]);
+			Packet.DirectionX.Store(Components[3]);
+			Packet.DirectionY.Store(Components[4]);
+			Packet.DirectionZ.Store(Components[5]);
+
+			for (uint32 X = MinX; X < MaxX; ++X)
 			{
-				ClosestHitDistance = HitDistance;
-				ObjectIndex = World->PlaneCount + SphereIndex;
+				uint32 Lane = X - MinX;
+				uint32 PathIndex = Paths.Count++;
+				Paths.PixelX[PathIndex] = X;
+				Paths.PixelY[PathIndex] = Y;
+				Paths.SampleIndex[PathIndex] = Block.SampleCount;
+				Paths.Throughput[PathIndex] = FVector3(1.0F);
+				Paths.Radiance[PathIndex] = FVector3(0.0F);
+				Wavefront.Rays.Push(FRay(FVector3(Components[0][Lane], Components[1][Lane], Components[2][Lane]),
+					FVector3(Components[3][Lane], Components[4][Lane], Components[5][Lane])), PathIndex);
 			}
 		}
 	}
 
+	FRayCounters& Counters = GetRayCounters();
+	Counters.PrimaryRayCount += Wavefront.Rays.Count;
+
+	for (uint32 Depth = 0; Wavefront.Rays.Count > 0; ++Depth)
+	{
+		// The primary rays are already coherent, and traced in the order of the pixels.
+		if (Settings.bSortRays && (Depth > 0))
+		{
+			SortRays(Wavefront.Rays, Wavefront.SortedRays);
+
+			FRayQueue UnsortedRays = Wavefront.Rays;
+			Wavefront.Rays = Wavefront.SortedRays;
+			Wavefront.SortedRays = UnsortedRays;
+		}
+
+		// Only the primary rays are coherent enough to share the traversal of a packet.
+		ExtendRays(Wavefront.Rays, Wavefront.Hits, Settings.bUseRayPackets && (Depth == 0));
+		Counters.HitCount += ShadeHits(Wavefront, Depth);
+		Counters.ShadowRayCount += Wavefront.Shadows.Rays.Count;
+		Counters.SecondaryRayCount += Wavefront.NextRays.Count;
+		TraceShadowRays(Wavefront);
+
+		FRayQueue ExtendedRays = Wavefront.Rays;
+		Wavefront.Rays = Wavefront.NextRays;
+		Wavefront.NextRays = ExtendedRays;
+	}
+
+	// Accumulate: the paths are visited in the order in which they were generated.
+	FVector4 Colors[SAMPLE_BLOCK_PIXEL_COUNT];
+	uint32 PathIndex = 0;
+	for (uint32 BlockIndex = 0; BlockIndex < BlockCountPerTile; ++BlockIndex)
+	{
+		FSampleBlock& Block = TileBlocks[BlockIndex];
+		if (Block.bConverged)
+		{
+			continue;
+		}
+
+		uint32 MinX, MinY, MaxX, MaxY;
+		GetBlockBounds(TileIndex, BlockIndex, MinX, MinY, MaxX, MaxY);
+		uint32 PixelCount = (MaxX - MinX) * (MaxY - MinY);
+		for (uint32 PixelIndex = 0; PixelIndex < PixelCount; ++PixelIndex)
+		{
+			Colors[PixelIndex] = FVector4(Paths.Radiance[PathIndex++], 1);
+		}
+
+		AccumulateBlock(Block, MinX, MinY, MaxX, MaxY, Colors);
+		UpdateBlockConvergence(Tile, Block, MinX, MinY, MaxX, MaxY);
+	}
+}
+
+void FRenderer::ExtendRays(const FRayQueue& Rays, FHitQueue& Hits, bool bUsePackets)
+{
+	SM_PROFILE_SCOPE("ExtendRays");
+	SM_PROFILE_COUNT(TracedRays, Rays.Count);
+
+	Kernels->TraceRays(GetKernelScene(), Rays, Hits, bUsePackets);
+}
+
+uint32 FRenderer::ShadeHits(FWavefront& Wavefront, uint32 Depth)
+{
+	SM_PROFILE_SCOPE("ShadeHits");
+
+	const FEnvironment& Environment = World->Environment;
+	FPathQueue& Paths = Wavefront.Paths;
+	const FRayQueue& Rays = Wavefront.Rays;
+	const FHitQueue& Hits = Wavefront.Hits;
+	uint32 Dimension = SAMPLE_DIMENSION_FIRST_BOUNCE + Depth * SAMPLE_DIMENSIONS_PER_BOUNCE;
+
+	// The paths that escaped the world gather the sky; the hits of the others are compacted, to be shaded together.
+	uint32 HitCount = 0;
+	for (uint32 RayIndex = 0; RayIndex < Rays.Count; ++RayIndex)
+	{
+		uint32 PathIndex = Rays.PathIndex[RayIndex];
+		if (Hits.ObjectIndex[RayIndex] == UINT32_MAX)
+		{
+			Paths.Radiance[PathIndex] += Paths.Throughput[PathIndex] * Environment.SkyRadiance;
+			continue;
+		}
+
+		FRay Ray = Rays.GetRay(RayIndex);
+		FHitPayload Payload = ClosestHit(Ray, Hits.HitDistance[RayIndex], Hits.ObjectIndex[RayIndex], Hits.PrimitiveIndex[RayIndex]);
+
+		uint32 PixelX = Paths.PixelX[PathIndex];
+		uint32 PixelY = Paths.PixelY[PathIndex];
+		uint32 SampleIndex = Paths.SampleIndex[PathIndex];
+
+		// Surfaces are shaded on the side the ray comes from.
+		FShadingInput& Input = Wavefront.ShadingInputs[HitCount];
+		Input.Direction = Ray.Direction;
+		Input.Normal = Payload.WorldNormal;
+		if ((Input.Normal | Input.Direction) > 0)
+		{
+			Input.Normal = -Input.Normal;
+		}
+		Input.DirectionSample = FSampler::Get2D(Settings.Sampler, PixelX, PixelY, SampleIndex, Dimension);
+		Input.LobeSample = FSampler::Get1D(Settings.Sampler, PixelX, PixelY, SampleIndex, Dimension + 2);
+		Input.MaterialIndex = Payload.MaterialIndex;
+		Input.bFrontFace = Payload.bFrontFace;
+
+		Wavefront.HitPositions[HitCount] = Payload.WorldPosition;
+		Wavefront.HitPathIndices[HitCount] = PathIndex;
+		++HitCount;
+	}
+
+	FShadingContext Context;
+	Context.Materials = World->Materials;
+	Context.SunDirection = Environment.SunDirection;
+	FMaterialTable::Shade(Context, Wavefront.ShadingInputs, HitCount, Wavefront.ShadingOutputs, Kernels->ShadeMaterials);
+
+	FRayQueue& NextRays = Wavefront.NextRays;
+	FShadowQueue& Shadows = Wavefront.Shadows;
+	NextRays.Count = 0;
+	Shadows.Rays.Count = 0;
+
+	for (uint32 HitIndex = 0; HitIndex < HitCount; ++HitIndex)
+	{
+		uint32 PathIndex = Wavefront.HitPathIndices[HitIndex];
+		const FShadingInput& Input = Wavefront.ShadingInputs[HitIndex];
+		const FShadingOutput& Output = Wavefront.ShadingOutputs[HitIndex];
+		const FVector3& Position = Wavefront.HitPositions[HitIndex];
+		FVector3& PathThroughput = Paths.Throughput[PathIndex];
+
+		Paths.Radiance[PathIndex] += PathThroughput * Output.Emission;
+
+		if (FMath::Max(FMath::Max(Output.SunWeight.X, Output.SunWeight.Y), Output.SunWeight.Z) > 0)
+		{
+			Shadows.Radiance[Shadows.Rays.Count] = PathThroughput * Output.SunWeight * Environment.SunIrradiance;
+			Shadows.Rays.Push(FRay(Position + Input.Normal * RAY_ORIGIN_OFFSET, Environment.SunDirection), PathIndex);
+		}
+
+		if (Depth + 1 >= Settings.MaxPathDepth)
+		{
+			continue;
+		}
+
+		PathThroughput *= Output.BounceWeight;
+
+		float MaxThroughput = FMath::Max(FMath::Max(PathThroughput.X, PathThroughput.Y), PathThroughput.Z);
+		if (MaxThroughput < Settings.MinPathThroughput)
+		{
+			continue;
+		}
+
+		if (Depth + 1 >= Settings.RussianRouletteDepth)
+		{
+			float SurvivalProbability = FMath::Min(MaxThroughput, RUSSIAN_ROULETTE_MAX_SURVIVAL);
+			if (FSampler::Get1D(Settings.Sampler, Paths.PixelX[PathIndex], Paths.PixelY[PathIndex], Paths.SampleIndex[PathIndex], Dimension + 3) >= SurvivalProbability)
+			{
+				continue;
+			}
+			PathThroughput *= 1.0F / SurvivalProbability;
+		}
+
+		// The paths that continue are compacted into the next queue, so the next extend stage has no holes.
+		NextRays.Push(FRay(Position + Input.Normal * (Output.bTransmitted ? -RAY_ORIGIN_OFFSET : RAY_ORIGIN_OFFSET), Output.BounceDirection), PathIndex);
+	}
+
+	return HitCount;
+}
+
+void FRenderer::TraceShadowRays(FWavefront& Wavefront)
+{
+	SM_PROFILE_SCOPE("TraceShadowRays");
+	SM_PROFILE_COUNT(OcclusionRays, Wavefront.Shadows.Rays.Count);
+
+	Kernels->TraceShadowRays(GetKernelScene(), Wavefront.Shadows, Wavefront.Paths.Radiance);
+}
+
+FRenderer::FHitPayload FRenderer::TraceRay(const FRay& Ray)
+{
+	SM_PROFILE_TIMER(TraceRay);
+	SM_PROFILE_COUNT(TracedRays, 1);
+
+	float HitDistance;
+	uint32 ObjectIndex, PrimitiveIndex;
+	Kernels->TraceRay(GetKernelScene(), Ray, HitDistance, ObjectIndex, PrimitiveIndex);
+
 	if (ObjectIndex != UINT32_MAX)
 	{
-		return ClosestHit(Ray, ClosestHitDistance, ObjectIndex);
+		return ClosestHit(Ray, HitDistance, ObjectIndex, PrimitiveIndex);
 	}
 
 	return Miss(Ray);
 }
 
-FRenderer::FHitPayload FRenderer::ClosestHit(const FRay& Ray, float HitDistance, uint32 ObjectIndex)
+bool FRenderer::Occluded(const FRay& Ray, float MaxDistance)
+{
+	SM_PROFILE_COUNT(OcclusionRays, 1);
+
+	return Kernels->Occluded(GetKernelScene(), Ray, MaxDistance);
+}
+
+FRenderer::FHitPayload FRenderer::ClosestHit(const FRay& Ray, float HitDistance, uint32 ObjectIndex, uint32 PrimitiveIndex)
 {
+	SM_PROFILE_TIMER(ClosestHit);
+
 	FHitPayload Result = {};
 	Result.HitDistance = HitDistance;
 	Result.ObjectIndex = ObjectIndex;
+	Result.PrimitiveIndex = PrimitiveIndex;
 	Result.WorldPosition = Ray.Origin + Ray.Direction * HitDistance;
 
+	uint32 MeshObjectIndex = World->PlaneCount + World->SphereCount;
+
 	if (ObjectIndex < World->PlaneCount)
 	{
 		const FPlane* Plane = World->Planes + ObjectIndex;
 		Result.WorldNormal = Plane->Normal;
 		Result.MaterialIndex = Plane->MaterialIndex;
+		Result.bFrontFace = (Result.WorldNormal | Ray.Direction) < 0;
 	}
-	else
+	else if (ObjectIndex < MeshObjectIndex)
 	{
 		const FSphere* Sphere = World->Spheres + (ObjectIndex - World->PlaneCount);
-		Result.WorldNormal = FVector3(Result.WorldPosition - Sphere->Position).GetNormal();
+		Result.WorldNormal = (FVector3A(Result.WorldPosition) - FVector3A(Sphere->Position)).GetNormal().ToVector3();
 		Result.MaterialIndex = Sphere->MaterialIndex;
+		Result.bFrontFace = (Result.WorldNormal | Ray.Direction) < 0;
+	}
+	else
+	{
+		const FTriangleMesh* Mesh = World->Meshes + (ObjectIndex - MeshObjectIndex);
+		const uint32* Indices = Mesh->Indices + 3 * (uint64)PrimitiveIndex;
+		const FVector3& V0 = Mesh->Vertices[Indices[0]];
+		const FVector3& V1 = Mesh->Vertices[Indices[1]];
+		const FVector3& V2 = Mesh->Vertices[Indices[2]];
+
+		// Triangles are hit from both sides, so the normal always faces the ray. The front face is the counter-clockwise one.
+		FVector3A Vertex0 = FVector3A(V0);
+		Result.WorldNormal = FVector3A::CrossProduct(FVector3A(V1) - Vertex0, FVector3A(V2) - Vertex0).GetNormal().ToVector3();
+		Result.bFrontFace = (Result.WorldNormal | Ray.Direction) < 0;
+		if (!Result.bFrontFace)
+		{
+			Result.WorldNormal = -Result.WorldNormal;
+		}
+
+		Result.MaterialIndex = Mesh->TriangleMaterialIndices ? Mesh->TriangleMaterialIndices[PrimitiveIndex] : Mesh->MaterialIndex;
 	}
 
 	return Result;
 }
 
-FRenderer::FHitPayload FRenderer::Miss(const FRay& Ray)
+FRenderer::FHitPayload FRenderer::Miss(const FRay& /*Ray*/)
 {
 	FHitPayload Result = {};
 	Result.HitDistance = -1;
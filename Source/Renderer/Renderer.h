@@ -8,7 +8,11 @@
 #pragma once
 
 #include "Core/Math/Math.h"
+#include "Core/Math/RayPacket.h"
+#include "Core/Math/Sampler.h"
+#include "Renderer/RenderKernels.h"
 #include "World/World.h"
+#include "World/WorldAcceleration.h"
 
 struct FImage
 {
@@ -17,6 +21,90 @@ struct FImage
 	uint32  Height;
 };
 
+enum class EIntegrator : uint8
+{
+	/** Shades the first surface hit by the sun only, without shadows. Fast, for previews. */
+	DirectLighting,
+
+	/**
+	 * Monte Carlo path tracing. Paths bounce off diffuse surfaces, gathering the light of the sun
+	 *   (with shadows) at every bounce and of the sky when they escape the world.
+	 */
+	PathTracing,
+};
+
+struct FRenderSettings
+{
+	/** The width and height (in pixels) of a render tile. Tiles are distributed across the job system threads. */
+	uint32 TileSize = 32;
+
+	/**
+	 * Whether the primary rays are traced in packets of 8 horizontally adjacent pixels.
+	 * The image is the same as when tracing the rays one at a time.
+	 */
+	bool bUseRayPackets = true;
+
+	/** The settings used to build the acceleration structures, when the world is set. */
+	FBVHBuildSettings BVHSettings;
+
+	/**
+	 * Generates the positions of the jittered samples inside the pixels. The samples only depend on the
+	 *   pixel and the sample index, so the image doesn't depend on the number of threads.
+	 */
+	ESamplerType Sampler = ESamplerType::Sobol;
+
+	/** How the color of a sample is computed. */
+	EIntegrator Integrator = EIntegrator::PathTracing;
+
+	/** The maximum number of surfaces a path hits, the first one included. Bounds the cost of a sample. */
+	uint32 MaxPathDepth = 8;
+
+	/**
+	 * The depth from which paths are terminated randomly (Russian roulette), with a probability that
+	 *   increases as their throughput decreases. The surviving paths are weighted up, so the image
+	 *   is not biased.
+	 */
+	uint32 RussianRouletteDepth = 3;
+
+	/**
+	 * Paths whose throughput falls below this value are terminated, since the light they could still
+	 *   gather is negligible (for example, after hitting a black surface).
+	 */
+	float  MinPathThroughput = 0.001F;
+
+	/**
+	 * Whether the paths are traced as a wavefront: all the paths of a tile advance together, and every
+	 *   stage (extend, shade, shadow) runs over all of them before the next one starts. Otherwise, the
+	 *   paths advance block by block. Only used by the path tracing integrator; the image is the same.
+	 */
+	bool   bUseWavefront = true;
+
+	/**
+	 * Whether the wavefront sorts the bounced rays before tracing them, by the octant of their direction
+	 *   and the position of their origin. Neighbouring rays then visit mostly the same BVH nodes, which
+	 *   makes better use of the caches, at the cost of the sort. The image is the same.
+	 */
+	bool   bSortRays = false;
+
+	/** Progressive rendering stops once every pixel has this many samples. */
+	uint32 MaxSampleCount = 1024;
+
+	/**
+	 * Whether blocks of 8x8 pixels stop receiving samples once all their pixels have converged, which
+	 *   leaves the samples to the noisy regions (such as edges).
+	 */
+	bool   bAdaptiveSampling = true;
+
+	/** The number of samples a block gets before its convergence is estimated. At least 2. */
+	uint32 AdaptiveMinSampleCount = 8;
+
+	/**
+	 * A pixel is converged when the standard error of its mean luminance falls below this value
+	 *   (in display units, where 1 is white). The default is about one 8-bit step.
+	 */
+	float  AdaptiveErrorThreshold = 0.004F;
+};
+
 class FRenderer
 {
 private:
@@ -30,35 +118,304 @@ private:
 		FVector3 FilmCenter;
 	};
 
+	/**
+	 * The progressive rendering state of a block of pixels. Convergence is tracked per block, rather
+	 *   than per tile, so flat regions next to an edge don't keep receiving samples.
+	 */
+	struct FSampleBlock
+	{
+		uint32 SampleCount;
+
+		/** Whether the block doesn't need samples anymore (it has converged or reached the maximum sample count). */
+		bool   bConverged;
+	};
+
+	struct FTileState
+	{
+		/** The number of blocks of the tile that still need samples. Tiles without any are skipped. */
+		uint32 ActiveBlockCount;
+	};
+
+	/** The number of rays traced by a thread. Aligned to a cache line, so no two threads write to the same one. */
+	struct alignas(CACHE_LINE_SIZE) FRayCounters
+	{
+		uint64 PrimaryRayCount;
+		uint64 SecondaryRayCount;
+		uint64 ShadowRayCount;
+
+		/** The number of primary and secondary rays that hit a surface. */
+		uint64 HitCount;
+	};
+
 	struct FHitPayload
 	{
 		uint32   ObjectIndex;
+
+		/** For meshes, the index of the triangle that was hit. */
+		uint32   PrimitiveIndex;
+
 		float    HitDistance;
 		FVector3 WorldPosition;
 		FVector3 WorldNormal;
 		uint32   MaterialIndex;
+
+		/** Whether the ray hit the outer side of the surface (for triangles, the counter-clockwise one). */
+		bool     bFrontFace;
+	};
+
+public:
+	struct FRenderStats
+	{
+		/** The number of passes rendered since the accumulation was reset. */
+		uint32 PassCount;
+
+		/** The number of samples taken since the accumulation was reset, over all pixels. */
+		uint64 SampleCount;
+
+		uint32 BlockCount;
+
+		/** The number of blocks that don't need samples anymore (converged or at the maximum sample count). */
+		uint32 ConvergedBlockCount;
+
+		/** The number of rays traced from the camera. */
+		uint64 PrimaryRayCount;
+
+		/** The number of rays traced from the surfaces, to continue the paths. */
+		uint64 SecondaryRayCount;
+
+		/** The number of rays traced towards the sun, to test whether surfaces are in shadow. */
+		uint64 ShadowRayCount;
+
+		/** The number of primary and secondary rays that hit a surface (the others escape the world). */
+		uint64 HitCount;
+
+		/** The time spent rendering passes, in seconds. */
+		float64 RenderTimeSeconds;
 	};
 
 public:
 	FRenderer();
+	~FRenderer();
 
-	void SetWorld(const FWorld* InWorld);
+	/**
+	 * Sets the world to render.
+	 *
+	 * @param InWorld The world.
+	 * @param PrebuiltAcceleration The world's acceleration structures, if they were built ahead of time (for
+	 *   example, loaded together with the world from a scene file). They must outlive the renderer's use of the
+	 *   world. If nullptr, the renderer builds them, using the current settings.
+	 */
+	void SetWorld(const FWorld* InWorld, const FWorldAcceleration* PrebuiltAcceleration = nullptr);
 	void SetImageTarget(const FImage* InImageTarget);
+	void SetSettings(const FRenderSettings& InSettings);
+
+	/** @return The acceleration structures of the current world. */
+	SM_INLINE const FWorldAcceleration& GetAcceleration() const { return *Acceleration; }
+
+	/** @return The arena holding the buffers that depend on the image target (accumulation, tiles and blocks). */
+	SM_INLINE const FMemoryArena& GetImageArena() const { return ImageArena; }
+
+	/** @return Statistics about the sphere BVH of the current world. */
+	SM_INLINE const FBVHBuildStats& GetSphereBVHStats() const { return Acceleration->SphereBVHStats; }
 
 public:
+	/** Renders the image with one sample per pixel, through the pixel's corner. Discards the accumulated samples. */
 	void Render();
 
+	/**
+	 * Adds one sample to every pixel of the blocks that still need samples, and resolves them from the
+	 *   mean of their accumulated samples.
+	 * The first sample of a pixel goes through its corner (so a single pass is the same as 'Render');
+	 *   the next ones are jittered across the pixel, which anti-aliases the image.
+	 *
+	 * @return The number of blocks that still need samples (neither converged, nor at 'MaxSampleCount').
+	 */
+	uint32 RenderPass();
+
+	/**
+	 * Renders passes until the time budget is spent or no block needs samples anymore, refining the
+	 *   accumulated image. A pass is not started if it's expected to exceed the budget, but at least
+	 *   one pass is always rendered. The image target is valid after every pass.
+	 *
+	 * @param TimeBudgetSeconds The time to spend rendering, in seconds.
+	 *
+	 * @return The number of passes rendered.
+	 */
+	uint32 RenderProgressive(float64 TimeBudgetSeconds);
+
+	/** Discards the accumulated samples. Done automatically when the world, the image target or the settings change. */
+	void ResetAccumulation();
+
+	/** @return Statistics about the samples accumulated since the last reset. */
+	FRenderStats GetStats() const;
+
 private:
-	FVector4 PerPixel(uint32 PixelX, uint32 PixelY);
+	/** Allocates the accumulation buffers and the tile grid of the image target. */
+	void AllocateImageBuffers();
+
+	/**
+	 * Renders the blocks of a tile that still need samples, writing them directly in the image target.
+	 * Tiles never overlap, so multiple threads can render different tiles at the same time.
+	 */
+	void RenderTile(uint32 TileIndex);
+
+	/** @return The ray counters of the calling thread. Threads unknown to the job system share the main thread's. */
+	FRayCounters& GetRayCounters();
+
+	/** Adds a sample to all pixels of a block, and resolves them. */
+	void RenderBlock(FSampleBlock& Block, uint32 MinX, uint32 MinY, uint32 MaxX, uint32 MaxY);
+
+	/**
+	 * Adds the colors of a sample to the pixels of a block, and resolves them.
+	 *
+	 * @param Block The block.
+	 * @param MinX, MinY, MaxX, MaxY The pixel range covered by the block.
+	 * @param Colors The color of every pixel of the block, row by row.
+	 */
+	void AccumulateBlock(FSampleBlock& Block, uint32 MinX, uint32 MinY, uint32 MaxX, uint32 MaxY, const FVector4* Colors);
+
+	/** Marks a block as converged if it doesn't need samples anymore, after it has received one. */
+	void UpdateBlockConvergence(FTileState& Tile, FSampleBlock& Block, uint32 MinX, uint32 MinY, uint32 MaxX, uint32 MaxY);
+
+	/**
+	 * Wavefront version of 'RenderTile'. Generates a path for every pixel of the blocks that still need
+	 *   samples, traces them all bounce by bounce, and accumulates them.
+	 */
+	void RenderTileWavefront(uint32 TileIndex);
+
+	/**
+	 * The extend stage of the wavefront: finds the closest hit of every ray of a queue.
+	 *
+	 * @param Rays The rays.
+	 * @param Hits The closest hit of every ray.
+	 * @param bUsePackets Whether the rays are traced in packets of 8 consecutive rays; only worth it if they are coherent.
+	 */
+	void ExtendRays(const FRayQueue& Rays, FHitQueue& Hits, bool bUsePackets);
+
+	/**
+	 * The shade stage of the wavefront: gathers the sky for the rays that escaped the world and shades the
+	 *   hits of the others, sorted by material type. Queues the shadow rays towards the sun, and the bounces
+	 *   of the paths that continue.
+	 *
+	 * @return The number of rays that hit a surface.
+	 */
+	uint32 ShadeHits(FWavefront& Wavefront, uint32 Depth);
+
+	/** The shadow stage of the wavefront: adds the light of the sun to the paths whose shadow rays are not occluded. */
+	void TraceShadowRays(FWavefront& Wavefront);
+
+	/** @return True if the standard error of every pixel of the block is below the threshold. */
+	bool IsBlockConverged(uint32 MinX, uint32 MinY, uint32 MaxX, uint32 MaxY, uint32 SampleCount) const;
 
+	/** Gets the pixel range covered by a block of a tile. Empty if the block is outside the image. */
+	void GetBlockBounds(uint32 TileIndex, uint32 BlockIndex, out uint32& MinX, out uint32& MinY, out uint32& MaxX, out uint32& MaxY) const;
+
+	uint32 GetBlockPixelCount(uint32 TileIndex, uint32 BlockIndex) const;
+
+	/**
+	 * Traces the primary rays of up to 8 horizontally adjacent pixels; as a packet, if the settings allow it.
+	 *
+	 * @param PixelX The first pixel's X coordinate.
+	 * @param PixelY The pixels' Y coordinate.
+	 * @param PixelCount The number of pixels, in the range [1, 8].
+	 * @param SampleIndex The index of the sample, in every pixel.
+	 * @param Rays The primary rays.
+	 * @param Payloads The payloads of the primary rays.
+	 */
+	void TracePrimaryRays(uint32 PixelX, uint32 PixelY, uint32 PixelCount, uint32 SampleIndex, FRay* Rays, FHitPayload* Payloads);
+
+	/** @return The primary ray of a sample of a pixel. */
+	FRay GetPrimaryRay(uint32 PixelX, uint32 PixelY, uint32 SampleIndex);
+
+	/** @return The primary rays of up to 8 horizontally adjacent pixels. Same as 'GetPrimaryRay', per lane. */
+	FRayPacket8 GetPrimaryRayPacket(uint32 PixelX, uint32 PixelY, uint32 PixelCount, uint32 SampleIndex);
+
+	/** @return The position of a sample inside a pixel, in the range [0, 1) on both axes. The first sample is at the corner. */
+	FVector2 GetSampleOffset(uint32 PixelX, uint32 PixelY, uint32 SampleIndex) const;
+
+	/** @return The color of the surface hit by the primary ray, lit by the sun only (no shadows, no bounces). */
+	FVector4 ShadeDirectLighting(const FHitPayload& Payload);
+
+	/**
+	 * Traces the paths of a block's pixels, starting with their primary rays. The paths advance together,
+	 *   one bounce at a time, and the hits of a bounce are shaded together, sorted by material type. A path
+	 *   ends when it escapes the world, reaches the maximum depth or is terminated by Russian roulette.
+	 *
+	 * @param MinX, MinY The block's first pixel.
+	 * @param Width The block's width, in pixels.
+	 * @param PathCount The number of pixels of the block; at most 64.
+	 * @param SampleIndex The index of the sample, in every pixel.
+	 * @param Rays The primary rays, row by row. Overwritten by the bounces.
+	 * @param Payloads The payloads of the primary rays. Overwritten by the bounces.
+	 * @param Colors The color of every pixel.
+	 * @param Counters The counters to add the traced rays to.
+	 */
+	void TracePaths(uint32 MinX, uint32 MinY, uint32 Width, uint32 PathCount, uint32 SampleIndex, FRay* Rays, FHitPayload* Payloads, FVector4* Colors, FRayCounters& Counters);
+
+	/** Finds the closest hit of a ray with the selected kernels, and fills its payload. */
 	FHitPayload TraceRay(const FRay& Ray);
 
-	FHitPayload ClosestHit(const FRay& Ray, float HitDistance, uint32 ObjectIndex);
+	/**
+	 * Finds whether anything is hit by the ray, closer than a distance. Used for visibility tests, such as
+	 *   shadow rays: it returns on the first hit found, and doesn't compute a payload.
+	 *
+	 * @param Ray The ray.
+	 * @param MaxDistance Only hits in the range (0, MaxDistance) occlude the ray.
+	 *
+	 * @return True if the ray is occluded.
+	 */
+	bool Occluded(const FRay& Ray, float MaxDistance);
+
+	/**
+	 * Fills the payload of a hit.
+	 * The objects are indexed in the order planes, spheres, meshes; for meshes, the primitive index is the triangle's.
+	 */
+	FHitPayload ClosestHit(const FRay& Ray, float HitDistance, uint32 ObjectIndex, uint32 PrimitiveIndex);
 
 	FHitPayload Miss(const FRay& Ray);
 
+	/** @return What the kernels trace against. */
+	SM_INLINE FKernelScene GetKernelScene() const { return { World, Acceleration }; }
+
 private:
 	const FWorld* World;
 	const FImage* ImageTarget;
 	FCameraData   CameraData;
+
+	/** The acceleration structures used for tracing; either the owned ones or prebuilt ones. */
+	const FWorldAcceleration* Acceleration;
+
+	/** The kernels selected when the renderer was created. @see 'FKernelDispatch'. */
+	const FRenderKernels*     Kernels;
+
+	/** The acceleration structures built by the renderer, when the world doesn't come with prebuilt ones. */
+	FWorldAcceleration        OwnedAcceleration;
+
+	FRenderSettings Settings;
+
+	/** The sum of the samples of every pixel, in linear (unclamped) color. Allocated from 'ImageArena'. */
+	FVector4*       Accumulation;
+	FPixelMoments*  Moments;
+
+	/** The tiles of the image target, row by row. Allocated from 'ImageArena'. */
+	FTileState*     Tiles;
+	uint32          TileCountX;
+	uint32          TileCount;
+
+	/** The blocks of every tile, tile after tile, row by row inside a tile. Allocated from 'ImageArena'. */
+	FSampleBlock*   Blocks;
+	uint32          BlockCountPerTileAxis;
+	uint32          BlockCountPerTile;
+
+	uint32          PassCount;
+
+	/** The time spent in 'RenderPass' since the accumulation was reset. */
+	float64         RenderTimeSeconds;
+
+	/** The rays traced since the accumulation was reset, one set of counters per job system thread. Allocated from 'ImageArena'. */
+	FRayCounters*   RayCounters;
+	uint32          RayCounterCount;
+
+	/** Holds the buffers that depend on the image target. Reset every time the target changes. */
+	FMemoryArena    ImageArena;
 };
\ No newline at end of file
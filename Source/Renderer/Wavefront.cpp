@@ -0,0 +1,106 @@
+/**
+ *--------------------------------------------
+ * Wavefront.cpp <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 23 2022.
+ */
+
+#include "Wavefront.h"
+
+#include "Core/Memory/Memory.h"
+#include "Core/Profiling/Profiler.h"
+
+/** The number of bits of the sort keys: the octant of the direction, above the Morton code of the origin. */
+#define RAY_SORT_KEY_BITS (3 + 3 * RAY_SORT_MORTON_BITS_PER_AXIS)
+
+/** The number of bits sorted by every pass of the radix sort. */
+#define RAY_SORT_RADIX_BITS 8
+
+/** @return The bits of the value, spread out so there are two zero bits between every two of them. */
+internal SM_INLINE uint32 SpreadBits(uint32 X)
+{
+	X = (X | (X << 16)) & 0x030000FF;
+	X = (X | (X << 8)) & 0x0300F00F;
+	X = (X | (X << 4)) & 0x030C30C3;
+	X = (X | (X << 2)) & 0x09249249;
+	return X;
+}
+
+void SortRays(const FRayQueue& Rays, FRayQueue& SortedRays)
+{
+	SM_PROFILE_SCOPE("SortRays");
+
+	constexpr uint32 CellCount = 1U << RAY_SORT_MORTON_BITS_PER_AXIS;
+	constexpr uint32 BucketCount = 1U << RAY_SORT_RADIX_BITS;
+
+	FMemoryArena& ScratchArena = FMemory::GetScratchArena();
+	FScopedTemporaryMemory ScratchMemory(ScratchArena);
+
+	FBox Bounds = FBox::Empty();
+	for (uint32 RayIndex = 0; RayIndex < Rays.Count; ++RayIndex)
+	{
+		Bounds.Grow(FVector3(Rays.OriginX[RayIndex], Rays.OriginY[RayIndex], Rays.OriginZ[RayIndex]));
+	}
+
+	// The grid covers the bounds; the origins on their maximum side are clamped into the last cell.
+	FVector3 Extent = Bounds.GetExtent();
+	FVector3 CellScale = FVector3((float)CellCount / FMath::Max(Extent.X, SMALL_NUMBER), (float)CellCount / FMath::Max(Extent.Y, SMALL_NUMBER),
+		(float)CellCount / FMath::Max(Extent.Z, SMALL_NUMBER));
+
+	uint32* Keys = ScratchArena.PushArray<uint32>(Rays.Count);
+	uint32* Indices = ScratchArena.PushArray<uint32>(Rays.Count);
+	for (uint32 RayIndex = 0; RayIndex < Rays.Count; ++RayIndex)
+	{
+		uint32 CellX = FMath::Min((uint32)((Rays.OriginX[RayIndex] - Bounds.Min.X) * CellScale.X), CellCount - 1);
+		uint32 CellY = FMath::Min((uint32)((Rays.OriginY[RayIndex] - Bounds.Min.Y) * CellScale.Y), CellCount - 1);
+		uint32 CellZ = FMath::Min((uint32)((Rays.OriginZ[RayIndex] - Bounds.Min.Z) * CellScale.Z), CellCount - 1);
+		uint32 MortonCode = SpreadBits(CellX) | (SpreadBits(CellY) << 1) | (SpreadBits(CellZ) << 2);
+
+		uint32 Octant = (Rays.DirectionX[RayIndex] < 0.0F ? 1 : 0) | (Rays.DirectionY[RayIndex] < 0.0F ? 2 : 0) | (Rays.DirectionZ[RayIndex] < 0.0F ? 4 : 0);
+
+		Keys[RayIndex] = (Octant << (3 * RAY_SORT_MORTON_BITS_PER_AXIS)) | MortonCode;
+		Indices[RayIndex] = RayIndex;
+	}
+
+	// Least significant digit radix sort, ping-ponging between two sets of arrays.
+	uint32* SortedKeys = ScratchArena.PushArray<uint32>(Rays.Count);
+	uint32* SortedIndices = ScratchArena.PushArray<uint32>(Rays.Count);
+	for (uint32 Shift = 0; Shift < RAY_SORT_KEY_BITS; Shift += RAY_SORT_RADIX_BITS)
+	{
+		uint32 BucketOffsets[BucketCount] = {};
+		for (uint32 Index = 0; Index < Rays.Count; ++Index)
+		{
+			++BucketOffsets[(Keys[Index] >> Shift) & (BucketCount - 1)];
+		}
+
+		uint32 Offset = 0;
+		for (uint32 Bucket = 0; Bucket < BucketCount; ++Bucket)
+		{
+			uint32 Count = BucketOffsets[Bucket];
+			BucketOffsets[Bucket] = Offset;
+			Offset += Count;
+		}
+
+		for (uint32 Index = 0; Index < Rays.Count; ++Index)
+		{
+			uint32 Destination = BucketOffsets[(Keys[Index] >> Shift) & (BucketCount - 1)]++;
+			SortedKeys[Destination] = Keys[Index];
+			SortedIndices[Destination] = Indices[Index];
+		}
+
+		uint32* Swap = Keys;
+		Keys = SortedKeys;
+		SortedKeys = Swap;
+
+		Swap = Indices;
+		Indices = SortedIndices;
+		SortedIndices = Swap;
+	}
+
+	SortedRays.Count = 0;
+	for (uint32 Index = 0; Index < Rays.Count; ++Index)
+	{
+		SortedRays.Push(Rays.GetRay(Indices[Index]), Rays.PathIndex[Indices[Index]]);
+	}
+}
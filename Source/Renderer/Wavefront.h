@@ -0,0 +1,198 @@
+/**
+ *--------------------------------------------
+ * Wavefront.h <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 22 2022.
+ */
+
+#pragma once
+
+#include "Core/Math/Math.h"
+#include "Core/Math/Ray.h"
+#include "Core/Memory/MemoryArena.h"
+#include "Renderer/MaterialTable.h"
+
+/**
+ *---------------------------------------------------------------------------------
+ * The queues of the wavefront path tracer. Instead of following one path (or one
+ *   block of paths) at a time, the wavefront keeps all the paths of a tile in
+ *   flight, and runs every stage (extend, shade, shadow) over all of them before
+ *   moving to the next stage. Every stage runs a single tight loop over long
+ *   queues, which keeps its code and data hot in the caches.
+ * The rays are stored as structure-of-arrays, so a group of 8 rays can be loaded
+ *   directly as a ray packet. The capacities are rounded up to a multiple of 8,
+ *   so the last packet of a queue never reads past the arrays.
+ *---------------------------------------------------------------------------------
+ */
+
+/**
+ * The number of bits of every axis of the ray origins' Morton codes, when sorting rays. The origins
+ *   are binned into a grid of (2 ^ bits) ^ 3 cells, over the bounds of the queue.
+ */
+#define RAY_SORT_MORTON_BITS_PER_AXIS 4
+
+/** @return The capacity rounded up to a whole number of ray packets. */
+SM_INLINE uint32 GetWavefrontCapacity(uint32 Capacity)
+{
+	return (Capacity + 7) & ~7U;
+}
+
+/** A queue of rays, each belonging to a path of the wavefront. */
+struct FRayQueue
+{
+	float*  OriginX;
+	float*  OriginY;
+	float*  OriginZ;
+	float*  DirectionX;
+	float*  DirectionY;
+	float*  DirectionZ;
+
+	/** The path every ray belongs to. */
+	uint32* PathIndex;
+
+	uint32  Count;
+
+	void Allocate(FMemoryArena& Arena, uint32 Capacity)
+	{
+		Capacity = GetWavefrontCapacity(Capacity);
+		OriginX = Arena.PushArray<float>(Capacity, CACHE_LINE_SIZE);
+		OriginY = Arena.PushArray<float>(Capacity, CACHE_LINE_SIZE);
+		OriginZ = Arena.PushArray<float>(Capacity, CACHE_LINE_SIZE);
+		DirectionX = Arena.PushArray<float>(Capacity, CACHE_LINE_SIZE);
+		DirectionY = Arena.PushArray<float>(Capacity, CACHE_LINE_SIZE);
+		DirectionZ = Arena.PushArray<float>(Capacity, CACHE_LINE_SIZE);
+		PathIndex = Arena.PushArray<uint32>(Capacity, CACHE_LINE_SIZE);
+		Count = 0;
+	}
+
+	SM_INLINE void Push(const FRay& Ray, uint32 Path)
+	{
+		OriginX[Count] = Ray.Origin.X;
+		OriginY[Count] = Ray.Origin.Y;
+		OriginZ[Count] = Ray.Origin.Z;
+		DirectionX[Count] = Ray.Direction.X;
+		DirectionY[Count] = Ray.Direction.Y;
+		DirectionZ[Count] = Ray.Direction.Z;
+		PathIndex[Count] = Path;
+		++Count;
+	}
+
+	SM_INLINE FRay GetRay(uint32 Index) const
+	{
+		return FRay(FVector3(OriginX[Index], OriginY[Index], OriginZ[Index]), FVector3(DirectionX[Index], DirectionY[Index], DirectionZ[Index]));
+	}
+};
+
+/** The closest hits of the rays of a queue, at the same indices. */
+struct FHitQueue
+{
+	float*  HitDistance;
+
+	/** The object that was hit, or UINT32_MAX if the ray escaped the world. */
+	uint32* ObjectIndex;
+
+	/** For meshes, the index of the triangle that was hit. */
+	uint32* PrimitiveIndex;
+
+	void Allocate(FMemoryArena& Arena, uint32 Capacity)
+	{
+		Capacity = GetWavefrontCapacity(Capacity);
+		HitDistance = Arena.PushArray<float>(Capacity, CACHE_LINE_SIZE);
+		ObjectIndex = Arena.PushArray<uint32>(Capacity, CACHE_LINE_SIZE);
+		PrimitiveIndex = Arena.PushArray<uint32>(Capacity, CACHE_LINE_SIZE);
+	}
+};
+
+/** The shadow rays towards the sun, with the radiance every one of them adds to its path if it's not occluded. */
+struct FShadowQueue
+{
+	FRayQueue Rays;
+	FVector3* Radiance;
+
+	void Allocate(FMemoryArena& Arena, uint32 Capacity)
+	{
+		Rays.Allocate(Arena, Capacity);
+		Radiance = Arena.PushArray<FVector3>(Capacity, CACHE_LINE_SIZE);
+	}
+};
+
+/** The state of the paths of a wavefront, indexed by path. */
+struct FPathQueue
+{
+	/** The pixel and the sample every path belongs to, which select its sample dimensions. */
+	uint32*   PixelX;
+	uint32*   PixelY;
+	uint32*   SampleIndex;
+
+	/** The fraction of the light gathered from the path's next vertex that reaches the camera. */
+	FVector3* Throughput;
+
+	/** The light gathered so far. */
+	FVector3* Radiance;
+
+	uint32    Count;
+
+	void Allocate(FMemoryArena& Arena, uint32 Capacity)
+	{
+		PixelX = Arena.PushArray<uint32>(Capacity, CACHE_LINE_SIZE);
+		PixelY = Arena.PushArray<uint32>(Capacity, CACHE_LINE_SIZE);
+		SampleIndex = Arena.PushArray<uint32>(Capacity, CACHE_LINE_SIZE);
+		Throughput = Arena.PushArray<FVector3>(Capacity, CACHE_LINE_SIZE);
+		Radiance = Arena.PushArray<FVector3>(Capacity, CACHE_LINE_SIZE);
+		Count = 0;
+	}
+};
+
+/**
+ * All the queues of a wavefront. The rays of a bounce are extended from 'Rays', and the shade stage
+ *   compacts the paths that continue into 'NextRays'; the two are swapped between the bounces.
+ */
+struct FWavefront
+{
+	FPathQueue      Paths;
+	FRayQueue       Rays;
+	FHitQueue       Hits;
+	FRayQueue       NextRays;
+	FShadowQueue    Shadows;
+
+	/** Where the rays are sorted into, before being swapped with 'Rays'. */
+	FRayQueue       SortedRays;
+
+	/** The hits of the bounce being shaded, compacted (the rays that escaped the world are skipped). */
+	FShadingInput*  ShadingInputs;
+	FShadingOutput* ShadingOutputs;
+	FVector3*       HitPositions;
+	uint32*         HitPathIndices;
+
+	/**
+	 * Allocates the queues. Their memory is not initialized.
+	 *
+	 * @param Arena The arena to allocate the queues from.
+	 * @param Capacity The maximum number of paths.
+	 */
+	void Allocate(FMemoryArena& Arena, uint32 Capacity)
+	{
+		Paths.Allocate(Arena, Capacity);
+		Rays.Allocate(Arena, Capacity);
+		Hits.Allocate(Arena, Capacity);
+		NextRays.Allocate(Arena, Capacity);
+		Shadows.Allocate(Arena, Capacity);
+		SortedRays.Allocate(Arena, Capacity);
+
+		ShadingInputs = Arena.PushArray<FShadingInput>(Capacity, CACHE_LINE_SIZE);
+		ShadingOutputs = Arena.PushArray<FShadingOutput>(Capacity, CACHE_LINE_SIZE);
+		HitPositions = Arena.PushArray<FVector3>(Capacity, CACHE_LINE_SIZE);
+		HitPathIndices = Arena.PushArray<uint32>(Capacity, CACHE_LINE_SIZE);
+	}
+};
+
+/**
+ * Reorders the rays of a queue, so that rays that are likely to visit the same parts of the world are
+ *   next to each other. The rays are sorted by the octant of their direction, and then by the Morton
+ *   code of their origin. The sort is stable, so the order only depends on the rays.
+ *
+ * @param Rays The rays to sort.
+ * @param SortedRays The sorted rays. Must have the capacity of 'Rays'.
+ */
+void SortRays(const FRayQueue& Rays, FRayQueue& SortedRays);
@@ -0,0 +1,510 @@
+/**
+ *--------------------------------------------
+ * BVH.cpp <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 7 2022.
+ */
+
+#include "BVH.h"
+
+#include "Core/Jobs/JobSystem.h"
+#include "Core/Platform/Platform.h"
+
+#include <atomic>
+#include <cstring>
+#include <mutex>
+
+/** How many primitives a single job bins, when a node is binned in parallel. */
+#define BVH_BINNING_BATCH_SIZE 16384
+
+/**
+ * A primitive, as seen by the builder. The references are partitioned in place instead of the
+ *   primitive indices, so every pass over a node reads memory sequentially.
+ */
+struct FBVHPrimitiveReference
+{
+	FVector3 BoundsMin;
+	uint32   PrimitiveIndex;
+	FVector3 BoundsMax;
+	uint32   Padding;
+
+	SM_INLINE FBox GetBounds() const { return FBox(BoundsMin, BoundsMax); }
+	SM_INLINE FVector3 GetCentroid() const { return (BoundsMin + BoundsMax) * 0.5F; }
+};
+
+struct FBVHBuildContext
+{
+	FBVHPrimitiveReference* References;
+	FBVH*                   BVH;
+	FBVHBuildSettings       Settings;
+
+	/** Nodes are allocated by multiple threads at the same time. */
+	std::atomic<uint32>     NodeCount;
+
+	/** Counts the subtree jobs that are still running. */
+	FJobCounter             SubtreeCounter;
+};
+
+/**
+ * A bin of the SAH evaluation. Plain floats instead of a box, so that declaring a full set of
+ *   bins on the stack doesn't initialize anything; only the bins in use are reset.
+ */
+struct FBVHBin
+{
+	float  BoundsMin[3];
+	float  BoundsMax[3];
+	uint32 Count;
+
+	SM_INLINE void Reset()
+	{
+		BoundsMin[0] = BoundsMin[1] = BoundsMin[2] = BIG_NUMBER;
+		BoundsMax[0] = BoundsMax[1] = BoundsMax[2] = -BIG_NUMBER;
+		Count = 0;
+	}
+
+	SM_INLINE void Add(const FVector3& Min, const FVector3& Max)
+	{
+		BoundsMin[0] = FMath::Min(BoundsMin[0], Min.X);
+		BoundsMin[1] = FMath::Min(BoundsMin[1], Min.Y);
+		BoundsMin[2] = FMath::Min(BoundsMin[2], Min.Z);
+		BoundsMax[0] = FMath::Max(BoundsMax[0], Max.X);
+		BoundsMax[1] = FMath::Max(BoundsMax[1], Max.Y);
+		BoundsMax[2] = FMath::Max(BoundsMax[2], Max.Z);
+		Count++;
+	}
+
+	SM_INLINE void Add(const FBVHBin& Other)
+	{
+		for (uint32 Axis = 0; Axis < 3; ++Axis)
+		{
+			BoundsMin[Axis] = FMath::Min(BoundsMin[Axis], Other.BoundsMin[Axis]);
+			BoundsMax[Axis] = FMath::Max(BoundsMax[Axis], Other.BoundsMax[Axis]);
+		}
+		Count += Other.Count;
+	}
+
+	SM_INLINE FBox GetBounds() const
+	{
+		return FBox(FVector3(BoundsMin[0], BoundsMin[1], BoundsMin[2]), FVector3(BoundsMax[0], BoundsMax[1], BoundsMax[2]));
+	}
+};
+
+/** The bins of all three axes. */
+struct FBVHBinning
+{
+	FBVHBin Bins[3][BVH_MAX_BIN_COUNT];
+
+	SM_INLINE void Reset(uint32 BinCount)
+	{
+		for (uint32 Axis = 0; Axis < 3; ++Axis)
+		{
+			for (uint32 BinIndex = 0; BinIndex < BinCount; ++BinIndex)
+			{
+				Bins[Axis][BinIndex].Reset();
+			}
+		}
+	}
+};
+
+/** @return The SAH intersection cost of a number of primitives, counted in batches. */
+internal SM_INLINE float GetIntersectionCost(uint32 PrimitiveCount, uint32 BatchSize)
+{
+	return (float)((PrimitiveCount + BatchSize - 1) / BatchSize);
+}
+
+internal SM_INLINE float GetAxis(const FVector3& Vector, uint32 Axis)
+{
+	return (&Vector.X)[Axis];
+}
+
+internal SM_INLINE uint32 GetBinIndex(const FVector3& Centroid, uint32 Axis, const FVector3& BinMin, const FVector3& BinScale, uint32 BinCount)
+{
+	uint32 BinIndex = (uint32)((GetAxis(Centroid, Axis) - GetAxis(BinMin, Axis)) * GetAxis(BinScale, Axis));
+	return FMath::Min(BinIndex, BinCount - 1);
+}
+
+internal void BinPrimitives(const FBVHBuildContext& Context, uint32 Begin, uint32 End, const FVector3& BinMin, const FVector3& BinScale, uint32 BinCount, FBVHBinning& Binning)
+{
+	for (uint32 Index = Begin; Index < End; ++Index)
+	{
+		const FBVHPrimitiveReference& Reference = Context.References[Index];
+		FVector3 Centroid = Reference.GetCentroid();
+
+		for (uint32 Axis = 0; Axis < 3; ++Axis)
+		{
+			Binning.Bins[Axis][GetBinIndex(Centroid, Axis, BinMin, BinScale, BinCount)].Add(Reference.BoundsMin, Reference.BoundsMax);
+		}
+	}
+}
+
+internal void ComputeBounds(const FBVHBuildContext& Context, uint32 Begin, uint32 End, FBox& OutBounds, FBox& OutCentroidBounds)
+{
+	OutBounds = FBox::Empty();
+	OutCentroidBounds = FBox::Empty();
+	for (uint32 Index = Begin; Index < End; ++Index)
+	{
+		const FBVHPrimitiveReference& Reference = Context.References[Index];
+		OutBounds.Grow(Reference.GetBounds());
+		OutCentroidBounds.Grow(Reference.GetCentroid());
+	}
+}
+
+internal void SubdivideNode(FBVHBuildContext& Context, uint32 NodeIndex, FBox CentroidBounds, uint32 Depth);
+
+/** The payload of a job that builds a subtree. Plain data, as it is copied into the job. */
+struct FBVHSubtreeJobData
+{
+	FBVHBuildContext* Context;
+	uint32            NodeIndex;
+	uint32            Depth;
+	float             CentroidMin[3];
+	float             CentroidMax[3];
+};
+
+internal void SubtreeJob(void* Data)
+{
+	const FBVHSubtreeJobData* Job = (const FBVHSubtreeJobData*)Data;
+	FBox CentroidBounds = FBox(
+		FVector3(Job->CentroidMin[0], Job->CentroidMin[1], Job->CentroidMin[2]),
+		FVector3(Job->CentroidMax[0], Job->CentroidMax[1], Job->CentroidMax[2]));
+	SubdivideNode(*Job->Context, Job->NodeIndex, CentroidBounds, Job->Depth);
+}
+
+internal void SubdivideNode(FBVHBuildContext& Context, uint32 NodeIndex, FBox CentroidBounds, uint32 Depth)
+{
+	const FBVHBuildSettings& Settings = Context.Settings;
+	FBVH& BVH = *Context.BVH;
+	FBVHNode& Node = BVH.Nodes[NodeIndex];
+	uint32 First = Node.LeftFirst;
+	uint32 Count = Node.PrimitiveCount;
+
+	if (Depth >= BVH_MAX_DEPTH - 1 || Count <= 1)
+	{
+		return;
+	}
+
+	// Small nodes don't need many bins to find a good split, and evaluating them dominates the
+	//   build time near the leaves.
+	uint32 BinCount = FMath::Clamp(Count, 4U, Settings.BinCount);
+
+	FVector3 BinMin = CentroidBounds.Min;
+	FVector3 CentroidExtent = CentroidBounds.GetExtent();
+	FVector3 BinScale;
+	for (uint32 Axis = 0; Axis < 3; ++Axis)
+	{
+		float Extent = GetAxis(CentroidExtent, Axis);
+		(&BinScale.X)[Axis] = (Extent > 0.0F) ? (float)BinCount / Extent : 0.0F;
+	}
+
+	FBVHBinning Binning;
+	Binning.Reset(BinCount);
+	if (Count >= Settings.ParallelBinningThreshold)
+	{
+		std::mutex MergeMutex;
+		FJobSystem::ParallelFor(Count, BVH_BINNING_BATCH_SIZE, [&](uint32 Begin, uint32 End)
+		{
+			FBVHBinning LocalBinning;
+			LocalBinning.Reset(BinCount);
+			BinPrimitives(Context, First + Begin, First + End, BinMin, BinScale, BinCount, LocalBinning);
+
+			std::lock_guard<std::mutex> Lock(MergeMutex);
+			for (uint32 Axis = 0; Axis < 3; ++Axis)
+			{
+				for (uint32 BinIndex = 0; BinIndex < BinCount; ++BinIndex)
+				{
+					Binning.Bins[Axis][BinIndex].Add(LocalBinning.Bins[Axis][BinIndex]);
+				}
+			}
+		});
+	}
+	else
+	{
+		BinPrimitives(Context, First, First + Count, BinMin, BinScale, BinCount, Binning);
+	}
+
+	// Evaluate the SAH for every bin boundary along every axis. Sweeping from both sides
+	//   gives the area and the primitive count on each side of every split.
+	float BestCost = BIG_NUMBER;
+	uint32 BestAxis = 0;
+	uint32 BestSplit = 0;
+
+	for (uint32 Axis = 0; Axis < 3; ++Axis)
+	{
+		if (GetAxis(BinScale, Axis) == 0.0F)
+		{
+			continue;
+		}
+
+		const FBVHBin* Bins = Binning.Bins[Axis];
+		float LeftArea[BVH_MAX_BIN_COUNT];
+		uint32 LeftCount[BVH_MAX_BIN_COUNT];
+
+		FBox LeftBox = FBox::Empty();
+		uint32 LeftSum = 0;
+		for (uint32 Split = 1; Split < BinCount; ++Split)
+		{
+			LeftBox.Grow(Bins[Split - 1].GetBounds());
+			LeftSum += Bins[Split - 1].Count;
+			LeftArea[Split] = LeftBox.GetSurfaceArea();
+			LeftCount[Split] = LeftSum;
+		}
+
+		FBox RightBox = FBox::Empty();
+		uint32 RightSum = 0;
+		for (uint32 Split = BinCount - 1; Split > 0; --Split)
+		{
+			RightBox.Grow(Bins[Split].GetBounds());
+			RightSum += Bins[Split].Count;
+
+			float Cost = LeftArea[Split] * GetIntersectionCost(LeftCount[Split], Settings.PrimitiveBatchSize) +
+				RightBox.GetSurfaceArea() * GetIntersectionCost(RightSum, Settings.PrimitiveBatchSize);
+			if (LeftCount[Split] > 0 && RightSum > 0 && Cost < BestCost)
+			{
+				BestCost = Cost;
+				BestAxis = Axis;
+				BestSplit = Split;
+			}
+		}
+	}
+
+	bool bFoundSplit = (BestCost < BIG_NUMBER);
+	float NodeArea = FBox(Node.BoundsMin, Node.BoundsMax).GetSurfaceArea();
+	float SplitCost = (bFoundSplit && NodeArea > 0.0F) ? Settings.TraversalCost + BestCost / NodeArea : BIG_NUMBER;
+	float LeafCost = GetIntersectionCost(Count, Settings.PrimitiveBatchSize);
+
+	if (Count <= Settings.MaxLeafSize && SplitCost >= LeafCost)
+	{
+		return;
+	}
+
+	uint32 Middle;
+	FBox ChildBounds[2];
+	FBox ChildCentroidBounds[2];
+	uint32 ChildCount[2];
+
+	if (bFoundSplit)
+	{
+		FBVHBin Children[2];
+		Children[0].Reset();
+		Children[1].Reset();
+		for (uint32 BinIndex = 0; BinIndex < BinCount; ++BinIndex)
+		{
+			Children[BinIndex < BestSplit ? 0 : 1].Add(Binning.Bins[BestAxis][BinIndex]);
+		}
+
+		// Partition the references in place, computing the children's centroid bounds on the way.
+		ChildCentroidBounds[0] = FBox::Empty();
+		ChildCentroidBounds[1] = FBox::Empty();
+
+		FBVHPrimitiveReference* References = Context.References;
+		uint32 Left = First;
+		uint32 Right = First + Count;
+		while (Left < Right)
+		{
+			FVector3 Centroid = References[Left].GetCentroid();
+			if (GetBinIndex(Centroid, BestAxis, BinMin, BinScale, BinCount) < BestSplit)
+			{
+				ChildCentroidBounds[0].Grow(Centroid);
+				++Left;
+			}
+			else
+			{
+				ChildCentroidBounds[1].Grow(Centroid);
+				--Right;
+				FBVHPrimitiveReference Temporary = References[Left];
+				References[Left] = References[Right];
+				References[Right] = Temporary;
+			}
+		}
+		Middle = Left;
+
+		ChildBounds[0] = Children[0].GetBounds();
+		ChildBounds[1] = Children[1].GetBounds();
+	}
+	else
+	{
+		// All centroids are in the same spot, but there are too many primitives for a leaf.
+		Middle = First + Count / 2;
+		ComputeBounds(Context, First, Middle, ChildBounds[0], ChildCentroidBounds[0]);
+		ComputeBounds(Context, Middle, First + Count, ChildBounds[1], ChildCentroidBounds[1]);
+	}
+
+	ChildCount[0] = Middle - First;
+	ChildCount[1] = First + Count - Middle;
+
+	uint32 LeftChildIndex = Context.NodeCount.fetch_add(2, std::memory_order_relaxed);
+	FBVHNode& LeftNode = BVH.Nodes[LeftChildIndex];
+	LeftNode.BoundsMin = ChildBounds[0].Min;
+	LeftNode.BoundsMax = ChildBounds[0].Max;
+	LeftNode.LeftFirst = First;
+	LeftNode.PrimitiveCount = ChildCount[0];
+
+	FBVHNode& RightNode = BVH.Nodes[LeftChildIndex + 1];
+	RightNode.BoundsMin = ChildBounds[1].Min;
+	RightNode.BoundsMax = ChildBounds[1].Max;
+	RightNode.LeftFirst = Middle;
+	RightNode.PrimitiveCount = ChildCount[1];
+
+	Node.LeftFirst = LeftChildIndex;
+	Node.PrimitiveCount = 0;
+
+	// Large subtrees are handed to the job system; the rest is built depth-first on this thread.
+	if (ChildCount[0] >= Settings.ParallelSubtreeThreshold)
+	{
+		const FBox& LeftCentroidBounds = ChildCentroidBounds[0];
+
+		FBVHSubtreeJobData Job;
+		Job.Context = &Context;
+		Job.NodeIndex = LeftChildIndex;
+		Job.Depth = Depth + 1;
+		Job.CentroidMin[0] = LeftCentroidBounds.Min.X;
+		Job.CentroidMin[1] = LeftCentroidBounds.Min.Y;
+		Job.CentroidMin[2] = LeftCentroidBounds.Min.Z;
+		Job.CentroidMax[0] = LeftCentroidBounds.Max.X;
+		Job.CentroidMax[1] = LeftCentroidBounds.Max.Y;
+		Job.CentroidMax[2] = LeftCentroidBounds.Max.Z;
+		FJobSystem::Run(SubtreeJob, &Job, sizeof(Job), &Context.SubtreeCounter);
+	}
+	else
+	{
+		SubdivideNode(Context, LeftChildIndex, ChildCentroidBounds[0], Depth + 1);
+	}
+
+	SubdivideNode(Context, LeftChildIndex + 1, ChildCentroidBounds[1], Depth + 1);
+}
+
+internal void ComputeStats(const FBVH& BVH, FBVHBuildStats& Stats, const FBVHBuildSettings& Settings)
+{
+	Stats.NodeCount = BVH.NodeCount;
+	Stats.LeafCount = 0;
+	Stats.MaxDepth = 0;
+	Stats.SAHCost = 0.0F;
+
+	float RootArea = FBox(BVH.Nodes[0].BoundsMin, BVH.Nodes[0].BoundsMax).GetSurfaceArea();
+	float InvRootArea = (RootArea > 0.0F) ? 1.0F / RootArea : 0.0F;
+
+	uint32 Stack[BVH_MAX_DEPTH][2];
+	uint32 StackSize = 0;
+	Stack[StackSize][0] = 0;
+	Stack[StackSize][1] = 1;
+	++StackSize;
+
+	while (StackSize > 0)
+	{
+		--StackSize;
+		const FBVHNode& Node = BVH.Nodes[Stack[StackSize][0]];
+		uint32 Depth = Stack[StackSize][1];
+		Stats.MaxDepth = FMath::Max(Stats.MaxDepth, Depth);
+
+		float Area = FBox(Node.BoundsMin, Node.BoundsMax).GetSurfaceArea() * InvRootArea;
+		if (Node.IsLeaf())
+		{
+			Stats.LeafCount++;
+			Stats.SAHCost += Area * GetIntersectionCost(Node.PrimitiveCount, Settings.PrimitiveBatchSize);
+		}
+		else
+		{
+			Stats.SAHCost += Area * Settings.TraversalCost;
+			Stack[StackSize][0] = Node.LeftFirst;
+			Stack[StackSize][1] = Depth + 1;
+			++StackSize;
+			Stack[StackSize][0] = Node.LeftFirst + 1;
+			Stack[StackSize][1] = Depth + 1;
+			++StackSize;
+		}
+	}
+}
+
+FBVHBuildStats FBVH::Build(const FBox* PrimitiveBounds, uint32 InPrimitiveCount, FMemoryArena& Arena, const FBVHBuildSettings& Settings)
+{
+	FBVHBuildStats Stats = {};
+	float64 StartTime = FPlatform::GetTimeSeconds();
+
+	Reset();
+	if (InPrimitiveCount == 0)
+	{
+		return Stats;
+	}
+
+	// The build memory is as large as the tree's worst case, so it comes from its own arena, which is released
+	//   after the build. On a scratch arena, it would stay reserved for as long as the thread lives.
+	FMemoryArena BuildArena;
+	BuildArena.Initialize("BVHBuild");
+
+	PrimitiveCount = InPrimitiveCount;
+	PrimitiveIndices = Arena.PushArray<uint32>(PrimitiveCount, CACHE_LINE_SIZE);
+
+	// A binary tree with N leaves has at most 2N - 1 nodes. The nodes are built in the build arena
+	//   and copied into the arena once their number is known.
+	Nodes = BuildArena.PushArray<FBVHNode>(2 * (uint64)PrimitiveCount - 1, CACHE_LINE_SIZE);
+
+	FBVHBuildContext Context;
+	Context.References = BuildArena.PushArray<FBVHPrimitiveReference>(PrimitiveCount, CACHE_LINE_SIZE);
+	Context.BVH = this;
+	Context.Settings = Settings;
+	Context.Settings.BinCount = FMath::Clamp(Settings.BinCount, 2U, (uint32)BVH_MAX_BIN_COUNT);
+	Context.Settings.MaxLeafSize = FMath::Max(Settings.MaxLeafSize, 1U);
+	Context.Settings.PrimitiveBatchSize = FMath::Max(Settings.PrimitiveBatchSize, 1U);
+	Context.NodeCount = 1;
+
+	FBox RootBounds = FBox::Empty();
+	FBox RootCentroidBounds = FBox::Empty();
+	std::mutex MergeMutex;
+	FJobSystem::ParallelFor(PrimitiveCount, BVH_BINNING_BATCH_SIZE, [&](uint32 Begin, uint32 End)
+	{
+		FBox LocalBounds = FBox::Empty();
+		FBox LocalCentroidBounds = FBox::Empty();
+		for (uint32 Index = Begin; Index < End; ++Index)
+		{
+			FBVHPrimitiveReference& Reference = Context.References[Index];
+			Reference.BoundsMin = PrimitiveBounds[Index].Min;
+			Reference.BoundsMax = PrimitiveBounds[Index].Max;
+			Reference.PrimitiveIndex = Index;
+			Reference.Padding = 0;
+
+			LocalBounds.Grow(PrimitiveBounds[Index]);
+			LocalCentroidBounds.Grow(Reference.GetCentroid());
+		}
+
+		std::lock_guard<std::mutex> Lock(MergeMutex);
+		RootBounds.Grow(LocalBounds);
+		RootCentroidBounds.Grow(LocalCentroidBounds);
+	});
+
+	FBVHNode& Root = Nodes[0];
+	Root.BoundsMin = RootBounds.Min;
+	Root.BoundsMax = RootBounds.Max;
+	Root.LeftFirst = 0;
+	Root.PrimitiveCount = PrimitiveCount;
+
+	SubdivideNode(Context, 0, RootCentroidBounds, 0);
+	FJobSystem::Wait(&Context.SubtreeCounter);
+
+	NodeCount = Context.NodeCount.load();
+
+	FJobSystem::ParallelFor(PrimitiveCount, BVH_BINNING_BATCH_SIZE, [&](uint32 Begin, uint32 End)
+	{
+		for (uint32 Index = Begin; Index < End; ++Index)
+		{
+			PrimitiveIndices[Index] = Context.References[Index].PrimitiveIndex;
+		}
+	});
+
+	FBVHNode* BuiltNodes = Nodes;
+	Nodes = Arena.PushArray<FBVHNode>(NodeCount, CACHE_LINE_SIZE);
+	memcpy((void*)Nodes, BuiltNodes, sizeof(FBVHNode) * (uint64)NodeCount);
+	BuildArena.Release();
+
+	Stats.BuildTimeSeconds = FPlatform::GetTimeSeconds() - StartTime;
+	ComputeStats(*this, Stats, Context.Settings);
+	return Stats;
+}
+
+void FBVH::Reset()
+{
+	Nodes = nullptr;
+	NodeCount = 0;
+	PrimitiveIndices = nullptr;
+	PrimitiveCount = 0;
+}
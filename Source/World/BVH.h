@@ -0,0 +1,122 @@
+/**
+ *--------------------------------------------
+ * BVH.h <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 7 2022.
+ */
+
+#pragma once
+
+#include "Core/Math/Math.h"
+#include "Core/Memory/MemoryArena.h"
+
+/**
+ * A node of the bounding volume hierarchy. Exactly 32 bytes, so two nodes share a cache line.
+ * The children of an interior node are always stored next to each other, so only the index
+ *   of the left one is stored.
+ */
+struct FBVHNode
+{
+	FVector3    BoundsMin;
+
+	/** For interior nodes, the index of the left child. For leaves, the index of the first primitive. */
+	uint32      LeftFirst;
+
+	FVector3    BoundsMax;
+
+	/** The number of primitives in the leaf; 0 for interior nodes. */
+	uint32      PrimitiveCount;
+
+	SM_INLINE bool IsLeaf() const { return PrimitiveCount > 0; }
+};
+
+static_assert(sizeof(FBVHNode) == 32, "FBVHNode must be 32 bytes!");
+
+/** The maximum number of bins that can be used when building a BVH. */
+#define BVH_MAX_BIN_COUNT 64
+
+struct FBVHBuildSettings
+{
+	/** The number of bins the centroid range of a node is split into, along every axis. At most 'BVH_MAX_BIN_COUNT'. */
+	uint32 BinCount = 16;
+
+	/** The maximum number of primitives in a leaf. */
+	uint32 MaxLeafSize = 8;
+
+	/** The cost of traversing an interior node, relative to intersecting one batch of primitives. */
+	float  TraversalCost = 1.0F;
+
+	/**
+	 * How many primitives the traversal intersects at once (the SIMD width of the intersection kernel).
+	 *   The SAH counts batches instead of primitives, so leaves are filled up to a multiple of it.
+	 */
+	uint32 PrimitiveBatchSize = 1;
+
+	/** Subtrees with more primitives than this are built as separate jobs. */
+	uint32 ParallelSubtreeThreshold = 4096;
+
+	/** Nodes with more primitives than this have their primitives binned by multiple jobs. */
+	uint32 ParallelBinningThreshold = 65536;
+};
+
+struct FBVHBuildStats
+{
+	/** The wall-clock time spent building. */
+	float64 BuildTimeSeconds;
+
+	uint32  NodeCount;
+	uint32  LeafCount;
+	uint32  MaxDepth;
+
+	/**
+	 * The SAH cost of the whole tree: the expected cost of tracing a random ray that hits the root,
+	 *   in units of primitive intersections.
+	 */
+	float   SAHCost;
+};
+
+/**
+ *----------------------------------------------------------------------------
+ * Bounding volume hierarchy built over an array of primitives, using binned
+ *   SAH (surface area heuristic) construction.
+ * The primitives themselves are not stored or reordered; the leaves reference
+ *   them through 'PrimitiveIndices'. The root is node 0.
+ * The hierarchy doesn't own its arrays; they live in the arena it was built in
+ *   (or in a memory mapped scene file).
+ *----------------------------------------------------------------------------
+ */
+struct FBVH
+{
+public:
+	FBVHNode*   Nodes = nullptr;
+	uint32      NodeCount = 0;
+
+	uint32*     PrimitiveIndices = nullptr;
+	uint32      PrimitiveCount = 0;
+
+public:
+	/**
+	 * Builds the hierarchy, replacing the previous one (if any).
+	 * Large subtrees are built in parallel, using the job system. The intermediate data is
+	 *   allocated from the scratch arena of the calling thread.
+	 *
+	 * @param PrimitiveBounds The bounding box of every primitive.
+	 * @param InPrimitiveCount The number of primitives.
+	 * @param Arena The arena the nodes and the primitive indices are allocated from. Can't be a scratch arena.
+	 * @param Settings The build settings.
+	 *
+	 * @return Statistics about the build and the resulting tree.
+	 */
+	FBVHBuildStats Build(const FBox* PrimitiveBounds, uint32 InPrimitiveCount, FMemoryArena& Arena,
+		const FBVHBuildSettings& Settings = FBVHBuildSettings());
+
+	/** Empties the hierarchy. The arrays are not freed; they belong to their arena. */
+	void Reset();
+
+	/** @return True if there is nothing to traverse. */
+	SM_INLINE bool IsEmpty() const { return NodeCount == 0; }
+};
+
+/** The maximum depth of a hierarchy, and so the size of a traversal stack. */
+#define BVH_MAX_DEPTH 64
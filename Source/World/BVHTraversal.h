@@ -0,0 +1,303 @@
+/**
+ *--------------------------------------------
+ * BVHTraversal.h <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 11 2022.
+ */
+
+#pragma once
+
+#include "Core/Math/Intersections.h"
+#include "Core/Math/IntersectionsSIMD.h"
+#include "Core/Profiling/Profiler.h"
+#include "World/BVH.h"
+
+/**
+ * Finds the closest hit of a ray, by traversing a BVH. The nearest child is visited first, so
+ *   the far one is often culled by a hit found in the near one.
+ * The primitives are not known by the traversal; the leaves are handed to a function.
+ *
+ * @param BVH The hierarchy.
+ * @param Ray The ray.
+ * @param ClosestHitDistance The distance to the closest hit found so far. Nodes further than it are skipped.
+ * @param IntersectLeaf Called as 'IntersectLeaf(First, Count, ClosestHitDistance)' for every leaf the ray
+ *   reaches, where [First, First + Count) is the leaf's range in 'BVH.PrimitiveIndices'. It must
+ *   update 'ClosestHitDistance' when it finds a closer hit.
+ */
+template<typename FIntersectLeaf>
+SM_INLINE void TraverseBVH(const FBVH& BVH, const FRay& Ray, float& ClosestHitDistance, FIntersectLeaf IntersectLeaf)
+{
+	if (BVH.IsEmpty())
+	{
+		return;
+	}
+
+	FVector3 InvDirection = FVector3(1.0F / Ray.Direction.X, 1.0F / Ray.Direction.Y, 1.0F / Ray.Direction.Z);
+
+	float RootDistance;
+	const FBVHNode* Root = BVH.Nodes;
+	if (!IntersectBox(Ray, InvDirection, Root->BoundsMin, Root->BoundsMax, ClosestHitDistance, RootDistance))
+	{
+		return;
+	}
+
+	uint32 Stack[BVH_MAX_DEPTH];
+	uint32 StackSize = 0;
+	const FBVHNode* Node = Root;
+
+	for (;;)
+	{
+		SM_PROFILE_COUNT(VisitedNodes, 1);
+
+		if (Node->IsLeaf())
+		{
+			SM_PROFILE_COUNT(TestedPrimitives, Node->PrimitiveCount);
+			IntersectLeaf(Node->LeftFirst, Node->PrimitiveCount, ClosestHitDistance);
+
+			if (StackSize == 0)
+			{
+				break;
+			}
+			Node = BVH.Nodes + Stack[--StackSize];
+			continue;
+		}
+
+		// Visit the nearest child first and keep the other one for later.
+		uint32 NearIndex = Node->LeftFirst;
+		uint32 FarIndex = Node->LeftFirst + 1;
+		const FBVHNode* Near = BVH.Nodes + NearIndex;
+		const FBVHNode* Far = BVH.Nodes + FarIndex;
+
+		float NearDistance;
+		float FarDistance;
+		bool bHitNear = IntersectBox(Ray, InvDirection, Near->BoundsMin, Near->BoundsMax, ClosestHitDistance, NearDistance);
+		bool bHitFar = IntersectBox(Ray, InvDirection, Far->BoundsMin, Far->BoundsMax, ClosestHitDistance, FarDistance);
+
+		if (bHitNear && bHitFar)
+		{
+			if (FarDistance < NearDistance)
+			{
+				Stack[StackSize++] = NearIndex;
+				Node = Far;
+			}
+			else
+			{
+				Stack[StackSize++] = FarIndex;
+				Node = Near;
+			}
+		}
+		else if (bHitNear || bHitFar)
+		{
+			Node = bHitNear ? Near : Far;
+		}
+		else
+		{
+			if (StackSize == 0)
+			{
+				break;
+			}
+			Node = BVH.Nodes + Stack[--StackSize];
+		}
+	}
+}
+
+/**
+ * Finds whether a ray hits anything closer than a distance, by traversing a BVH. Returns as soon as
+ *   any hit is found, instead of looking for the closest one. The nearest child is still visited
+ *   first, since the occluders closest to the ray's origin are found with the fewest nodes.
+ *
+ * @param BVH The hierarchy.
+ * @param Ray The ray.
+ * @param MaxDistance Nodes further than it are skipped.
+ * @param IntersectLeaf Called as 'IntersectLeaf(First, Count)' for every leaf the ray reaches, where
+ *   [First, First + Count) is the leaf's range in 'BVH.PrimitiveIndices'. Returns true if any of the
+ *   leaf's primitives is hit closer than 'MaxDistance'.
+ *
+ * @return True if 'IntersectLeaf' found a hit.
+ */
+template<typename FIntersectLeaf>
+SM_INLINE bool TraverseBVHAnyHit(const FBVH& BVH, const FRay& Ray, float MaxDistance, FIntersectLeaf IntersectLeaf)
+{
+	if (BVH.IsEmpty())
+	{
+		return false;
+	}
+
+	FVector3 InvDirection = FVector3(1.0F / Ray.Direction.X, 1.0F / Ray.Direction.Y, 1.0F / Ray.Direction.Z);
+
+	float RootDistance;
+	const FBVHNode* Root = BVH.Nodes;
+	if (!IntersectBox(Ray, InvDirection, Root->BoundsMin, Root->BoundsMax, MaxDistance, RootDistance))
+	{
+		return false;
+	}
+
+	uint32 Stack[BVH_MAX_DEPTH];
+	uint32 StackSize = 0;
+	const FBVHNode* Node = Root;
+
+	for (;;)
+	{
+		SM_PROFILE_COUNT(VisitedNodes, 1);
+
+		if (Node->IsLeaf())
+		{
+			SM_PROFILE_COUNT(TestedPrimitives, Node->PrimitiveCount);
+			if (IntersectLeaf(Node->LeftFirst, Node->PrimitiveCount))
+			{
+				return true;
+			}
+
+			if (StackSize == 0)
+			{
+				return false;
+			}
+			Node = BVH.Nodes + Stack[--StackSize];
+			continue;
+		}
+
+		uint32 NearIndex = Node->LeftFirst;
+		uint32 FarIndex = Node->LeftFirst + 1;
+		const FBVHNode* Near = BVH.Nodes + NearIndex;
+		const FBVHNode* Far = BVH.Nodes + FarIndex;
+
+		float NearDistance;
+		float FarDistance;
+		bool bHitNear = IntersectBox(Ray, InvDirection, Near->BoundsMin, Near->BoundsMax, MaxDistance, NearDistance);
+		bool bHitFar = IntersectBox(Ray, InvDirection, Far->BoundsMin, Far->BoundsMax, MaxDistance, FarDistance);
+
+		if (bHitNear && bHitFar)
+		{
+			if (FarDistance < NearDistance)
+			{
+				Stack[StackSize++] = NearIndex;
+				Node = Far;
+			}
+			else
+			{
+				Stack[StackSize++] = FarIndex;
+				Node = Near;
+			}
+		}
+		else if (bHitNear || bHitFar)
+		{
+			Node = bHitNear ? Near : Far;
+		}
+		else
+		{
+			if (StackSize == 0)
+			{
+				return false;
+			}
+			Node = BVH.Nodes + Stack[--StackSize];
+		}
+	}
+}
+
+/** @return The number of set bits in an 8-lane mask. */
+SM_INLINE uint32 CountMaskLanes(uint32 Bits)
+{
+	Bits = Bits - ((Bits >> 1) & 0x55);
+	Bits = (Bits & 0x33) + ((Bits >> 2) & 0x33);
+	return (Bits + (Bits >> 4)) & 0x0F;
+}
+
+/**
+ * Packet version of 'TraverseBVH'. The rays traverse the hierarchy together, visiting a node if any
+ *   of the active rays reaches it.
+ *
+ * @param BVH The hierarchy.
+ * @param Packet The rays.
+ * @param ClosestHitDistance The distance to the closest hit found so far, for every lane.
+ * @param IntersectLeaf Called as 'IntersectLeaf(First, Count, ClosestHitDistance)' for every leaf that
+ *   any of the rays reaches. It must update 'ClosestHitDistance' for the lanes that find a closer hit.
+ */
+template<typename FIntersectLeaf>
+SM_INLINE void TraverseBVHPacket(const FBVH& BVH, const FRayPacket8& Packet, FFloat8& ClosestHitDistance, FIntersectLeaf IntersectLeaf)
+{
+	if (BVH.IsEmpty())
+	{
+		return;
+	}
+
+	FFloat8 One = FFloat8::Set(1.0F);
+	FFloat8 InvDirectionX = One / Packet.DirectionX;
+	FFloat8 InvDirectionY = One / Packet.DirectionY;
+	FFloat8 InvDirectionZ = One / Packet.DirectionZ;
+
+	FFloat8 RootDistance;
+	const FBVHNode* Root = BVH.Nodes;
+	if ((IntersectBox8(Packet, InvDirectionX, InvDirectionY, InvDirectionZ, Root->BoundsMin, Root->BoundsMax, ClosestHitDistance, RootDistance) & Packet.ActiveMask).None())
+	{
+		return;
+	}
+
+	uint32 Stack[BVH_MAX_DEPTH];
+	uint32 StackSize = 0;
+	const FBVHNode* Node = Root;
+
+	for (;;)
+	{
+		SM_PROFILE_COUNT(VisitedNodes, 1);
+
+		if (Node->IsLeaf())
+		{
+			SM_PROFILE_COUNT(TestedPrimitives, Node->PrimitiveCount);
+			IntersectLeaf(Node->LeftFirst, Node->PrimitiveCount, ClosestHitDistance);
+
+			if (StackSize == 0)
+			{
+				break;
+			}
+			Node = BVH.Nodes + Stack[--StackSize];
+			continue;
+		}
+
+		uint32 NearIndex = Node->LeftFirst;
+		uint32 FarIndex = Node->LeftFirst + 1;
+		const FBVHNode* Near = BVH.Nodes + NearIndex;
+		const FBVHNode* Far = BVH.Nodes + FarIndex;
+
+		FFloat8 NearDistance;
+		FFloat8 FarDistance;
+		FMask8 NearMask = IntersectBox8(Packet, InvDirectionX, InvDirectionY, InvDirectionZ, Near->BoundsMin, Near->BoundsMax, ClosestHitDistance, NearDistance) & Packet.ActiveMask;
+		FMask8 FarMask = IntersectBox8(Packet, InvDirectionX, InvDirectionY, InvDirectionZ, Far->BoundsMin, Far->BoundsMax, ClosestHitDistance, FarDistance) & Packet.ActiveMask;
+
+		bool bHitNear = NearMask.Any();
+		bool bHitFar = FarMask.Any();
+
+		if (bHitNear && bHitFar)
+		{
+			// Visit first the child that most of the rays hitting both children enter first.
+			FMask8 BothMask = NearMask & FarMask;
+			FMask8 FarFirstMask = BothMask & (FarDistance < NearDistance);
+
+			uint32 FarFirstCount = CountMaskLanes(FarFirstMask.GetBits());
+			uint32 NearFirstCount = CountMaskLanes(BothMask.GetBits()) - FarFirstCount;
+
+			if (FarFirstCount > NearFirstCount)
+			{
+				Stack[StackSize++] = NearIndex;
+				Node = Far;
+			}
+			else
+			{
+				Stack[StackSize++] = FarIndex;
+				Node = Near;
+			}
+		}
+		else if (bHitNear || bHitFar)
+		{
+			Node = bHitNear ? Near : Far;
+		}
+		else
+		{
+			if (StackSize == 0)
+			{
+				break;
+			}
+			Node = BVH.Nodes + Stack[--StackSize];
+		}
+	}
+}
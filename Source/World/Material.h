@@ -0,0 +1,88 @@
+/**
+ *--------------------------------------------
+ * Material.h <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 21 2022.
+ */
+
+#pragma once
+
+#include "Core/Math/Math.h"
+
+/** The number of material types that can be registered, built-in types included. */
+#define MATERIAL_TYPE_MAX_COUNT 16
+
+/**
+ * The material types known by the renderer. Other types can be registered, with IDs starting
+ *   at 'BuiltInCount'.
+ */
+enum class EMaterialType : uint32
+{
+	Diffuse = 0,
+	Metal,
+	Dielectric,
+	Emissive,
+
+	BuiltInCount,
+};
+
+/**
+ * A material, of any type. The parameters are stored in the abstract data, in the layout of the
+ *   type's structure (for example, 'FMaterialDiffuse' for 'EMaterialType::Diffuse').
+ */
+struct FMaterial
+{
+	uint8       AbstractMaterialData[28];
+	uint32      MaterialTypeID;
+
+	template<typename T>
+	SM_INLINE T& GetData()
+	{
+		static_assert(sizeof(T) <= sizeof(AbstractMaterialData), "The material data doesn't fit in a material!");
+		return *(T*)AbstractMaterialData;
+	}
+
+	template<typename T>
+	SM_INLINE const T& GetData() const
+	{
+		static_assert(sizeof(T) <= sizeof(AbstractMaterialData), "The material data doesn't fit in a material!");
+		return *(const T*)AbstractMaterialData;
+	}
+};
+
+/*
+ * The parameters of the built-in types. Every one of them starts with the base color of the
+ *   material, which is what previews (such as the direct lighting integrator) shade with.
+ */
+
+/** A Lambertian surface, scattering the light equally in all directions. */
+struct FMaterialDiffuse
+{
+	FVector3    Albedo;
+};
+
+/** A metal, reflecting the light around the mirror direction. */
+struct FMaterialMetal
+{
+	FVector3    Reflectance;
+
+	/** How far the reflections spread from the mirror direction; 0 is a perfect mirror. */
+	float       Roughness;
+};
+
+/** A transparent surface (such as glass or water), which reflects and refracts the light. */
+struct FMaterialDielectric
+{
+	/** The color of the refracted light. */
+	FVector3    Tint;
+
+	/** The index of refraction of the inside, relative to the outside (where the normal points). */
+	float       IndexOfRefraction;
+};
+
+/** A light source. Emits light and doesn't scatter any. */
+struct FMaterialEmissive
+{
+	FVector3    Radiance;
+};
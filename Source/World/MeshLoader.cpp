@@ -0,0 +1,1054 @@
+/**
+ *--------------------------------------------
+ * MeshLoader.cpp <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 12 2022.
+ */
+
+#include "MeshLoader.h"
+
+#include "Core/Jobs/JobSystem.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Platform/Platform.h"
+
+#include <atomic>
+#include <cstring>
+
+/** The approximate size of the chunks an OBJ file is split into. Every chunk is parsed by one job. */
+#define OBJ_CHUNK_SIZE (4 * 1024 * 1024)
+
+/** The number of PLY vertices or faces a job converts. */
+#define PLY_BATCH_SIZE (64 * 1024)
+
+#define PLY_MAX_ELEMENTS   16
+#define PLY_MAX_PROPERTIES 32
+
+/*
+ *---------------------------------------------------------------------------------
+ * Text parsing.
+ *---------------------------------------------------------------------------------
+ */
+
+internal SM_INLINE bool IsSpace(char C)
+{
+	return (C == ' ') || (C == '\t') || (C == '\r');
+}
+
+internal SM_INLINE bool IsDigit(char C)
+{
+	return (C >= '0') && (C <= '9');
+}
+
+internal SM_INLINE const char* SkipSpaces(const char* At, const char* End)
+{
+	while ((At < End) && IsSpace(*At))
+	{
+		++At;
+	}
+	return At;
+}
+
+internal SM_INLINE const char* SkipToken(const char* At, const char* End)
+{
+	while ((At < End) && !IsSpace(*At))
+	{
+		++At;
+	}
+	return At;
+}
+
+/** @return The end of the line starting at 'At' (the position of the '\n', or 'End'). */
+internal SM_INLINE const char* FindLineEnd(const char* At, const char* End)
+{
+	const char* LineEnd = (const char*)memchr(At, '\n', (size_t)(End - At));
+	return LineEnd ? LineEnd : End;
+}
+
+/** @return True if the line is of the given OBJ statement (such as 'v' or 'f'). */
+internal SM_INLINE bool IsStatement(const char* At, const char* LineEnd, char Statement)
+{
+	return (LineEnd - At >= 2) && (At[0] == Statement) && IsSpace(At[1]);
+}
+
+internal SM_INLINE float64 GetPowerOf10(int32 Exponent)
+{
+	// Powers of 10 up to 1e22 are exactly representable.
+	static const float64 Powers[] =
+	{
+		1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	float64 Result = 1.0;
+	while (Exponent > 22)
+	{
+		Result *= 1e22;
+		Exponent -= 22;
+	}
+	return Result * Powers[Exponent];
+}
+
+/**
+ * Parses a decimal floating point number, with an optional sign, fraction and exponent.
+ * At most 18 significant digits are used; the result is exact for the values commonly found in
+ *   mesh files, and otherwise within one float ULP.
+ *
+ * @return The position after the number, or nullptr if there is no number at 'At'.
+ */
+internal const char* ParseFloat(const char* At, const char* End, out float& Value)
+{
+	bool bNegative = false;
+	if ((At < End) && ((*At == '-') || (*At == '+')))
+	{
+		bNegative = (*At == '-');
+		++At;
+	}
+
+	const uint64 MaxMantissa = 100000000000000000ULL;
+	uint64 Mantissa = 0;
+	int32 Exponent = 0;
+	uint32 DigitCount = 0;
+
+	for (; (At < End) && IsDigit(*At); ++At, ++DigitCount)
+	{
+		if (Mantissa < MaxMantissa)
+		{
+			Mantissa = Mantissa * 10 + (uint64)(*At - '0');
+		}
+		else
+		{
+			++Exponent;
+		}
+	}
+
+	if ((At < End) && (*At == '.'))
+	{
+		for (++At; (At < End) && IsDigit(*At); ++At, ++DigitCount)
+		{
+			if (Mantissa < MaxMantissa)
+			{
+				Mantissa = Mantissa * 10 + (uint64)(*At - '0');
+				--Exponent;
+			}
+		}
+	}
+
+	if (DigitCount == 0)
+	{
+		return nullptr;
+	}
+
+	if ((At < End) && ((*At == 'e') || (*At == 'E')))
+	{
+		const char* ExponentAt = At + 1;
+		bool bNegativeExponent = false;
+		if ((ExponentAt < End) && ((*ExponentAt == '-') || (*ExponentAt == '+')))
+		{
+			bNegativeExponent = (*ExponentAt == '-');
+			++ExponentAt;
+		}
+
+		if ((ExponentAt < End) && IsDigit(*ExponentAt))
+		{
+			int32 ExponentValue = 0;
+			for (; (ExponentAt < End) && IsDigit(*ExponentAt); ++ExponentAt)
+			{
+				ExponentValue = FMath::Min(ExponentValue * 10 + (*ExponentAt - '0'), 1000);
+			}
+			Exponent += bNegativeExponent ? -ExponentValue : ExponentValue;
+			At = ExponentAt;
+		}
+	}
+
+	float64 Result = (float64)Mantissa;
+	if (Mantissa != 0)
+	{
+		Exponent = FMath::Clamp(Exponent, -400, 400);
+		Result = (Exponent < 0) ? (Result / GetPowerOf10(-Exponent)) : (Result * GetPowerOf10(Exponent));
+	}
+
+	Value = (float)(bNegative ? -Result : Result);
+	return At;
+}
+
+/**
+ * Parses a decimal integer, with an optional sign.
+ *
+ * @return The position after the number, or nullptr if there is no number at 'At'.
+ */
+internal SM_INLINE const char* ParseInteger(const char* At, const char* End, out int64& Value)
+{
+	bool bNegative = false;
+	if ((At < End) && ((*At == '-') || (*At == '+')))
+	{
+		bNegative = (*At == '-');
+		++At;
+	}
+
+	if ((At >= End) || !IsDigit(*At))
+	{
+		return nullptr;
+	}
+
+	int64 Result = 0;
+	for (; (At < End) && IsDigit(*At); ++At)
+	{
+		// Anything this large is out of range anyway; saturating keeps it from overflowing.
+		Result = FMath::Min(Result * 10 + (*At - '0'), (int64)1 << 40);
+	}
+
+	Value = bNegative ? -Result : Result;
+	return At;
+}
+
+/*
+ *---------------------------------------------------------------------------------
+ * OBJ.
+ *---------------------------------------------------------------------------------
+ */
+
+struct FOBJChunk
+{
+	const char* Begin;
+	const char* End;
+
+	uint64      VertexCount;
+	uint64      TriangleCount;
+
+	/** The index of the chunk's first vertex and triangle in the mesh. */
+	uint64      VertexOffset;
+	uint64      TriangleOffset;
+};
+
+struct FOBJParseContext
+{
+	FOBJChunk*        Chunks;
+	FTriangleMesh*    Mesh;
+	std::atomic<bool> bInvalid;
+};
+
+/** Counts the vertices and triangles of a chunk. */
+internal void CountOBJChunk(FOBJChunk& Chunk)
+{
+	uint64 VertexCount = 0;
+	uint64 TriangleCount = 0;
+
+	for (const char* Line = Chunk.Begin; Line < Chunk.End;)
+	{
+		const char* LineEnd = FindLineEnd(Line, Chunk.End);
+		const char* At = SkipSpaces(Line, LineEnd);
+
+		if (IsStatement(At, LineEnd, 'v'))
+		{
+			++VertexCount;
+		}
+		else if (IsStatement(At, LineEnd, 'f'))
+		{
+			uint32 FaceVertexCount = 0;
+			for (At = SkipSpaces(At + 1, LineEnd); At < LineEnd; At = SkipSpaces(SkipToken(At, LineEnd), LineEnd))
+			{
+				++FaceVertexCount;
+			}
+
+			if (FaceVertexCount >= 3)
+			{
+				TriangleCount += FaceVertexCount - 2;
+			}
+		}
+
+		Line = LineEnd + 1;
+	}
+
+	Chunk.VertexCount = VertexCount;
+	Chunk.TriangleCount = TriangleCount;
+}
+
+/**
+ * Parses the vertices and triangles of a chunk, writing them in the mesh starting at the chunk's offsets.
+ *
+ * @return False if the chunk is malformed.
+ */
+internal bool ParseOBJChunk(const FOBJChunk& Chunk, FTriangleMesh& Mesh)
+{
+	bool bValid = true;
+	FVector3* Vertex = Mesh.Vertices + Chunk.VertexOffset;
+	uint32* Index = Mesh.Indices + 3 * Chunk.TriangleOffset;
+
+	for (const char* Line = Chunk.Begin; Line < Chunk.End;)
+	{
+		const char* LineEnd = FindLineEnd(Line, Chunk.End);
+		const char* At = SkipSpaces(Line, LineEnd);
+
+		if (IsStatement(At, LineEnd, 'v'))
+		{
+			float Components[3] = {};
+			At = At + 1;
+			for (uint32 Axis = 0; (Axis < 3) && At; ++Axis)
+			{
+				At = ParseFloat(SkipSpaces(At, LineEnd), LineEnd, Components[Axis]);
+			}
+			bValid &= (At != nullptr);
+
+			*Vertex++ = FVector3(Components[0], Components[1], Components[2]);
+		}
+		else if (IsStatement(At, LineEnd, 'f'))
+		{
+			// Relative (negative) indices count back from the last vertex defined before the face.
+			int64 DefinedVertexCount = (int64)(Vertex - Mesh.Vertices);
+
+			uint32 FirstIndex = 0;
+			uint32 PreviousIndex = 0;
+			uint32 FaceVertexCount = 0;
+
+			for (At = SkipSpaces(At + 1, LineEnd); At < LineEnd; At = SkipSpaces(SkipToken(At, LineEnd), LineEnd))
+			{
+				// Only the position index is used; 'v/vt/vn' and 'v//vn' are cut at the first slash.
+				int64 Value = 0;
+				if (!ParseInteger(At, LineEnd, Value))
+				{
+					bValid = false;
+				}
+
+				int64 VertexIndex = (Value < 0) ? (DefinedVertexCount + Value) : (Value - 1);
+				if ((Value == 0) || (VertexIndex < 0) || (VertexIndex >= (int64)Mesh.VertexCount))
+				{
+					bValid = false;
+					VertexIndex = 0;
+				}
+
+				uint32 CurrentIndex = (uint32)VertexIndex;
+				if (FaceVertexCount == 0)
+				{
+					FirstIndex = CurrentIndex;
+				}
+				else if (FaceVertexCount >= 2)
+				{
+					*Index++ = FirstIndex;
+					*Index++ = PreviousIndex;
+					*Index++ = CurrentIndex;
+				}
+
+				PreviousIndex = CurrentIndex;
+				++FaceVertexCount;
+			}
+		}
+
+		Line = LineEnd + 1;
+	}
+
+	return bValid;
+}
+
+internal EMeshLoadResult LoadOBJ(const FMappedFile& File, out FTriangleMesh& Mesh, FMemoryArena& Arena)
+{
+	const char* Begin = (const char*)File.Data;
+	const char* End = Begin + File.Size;
+
+	// Split the file in chunks of whole lines.
+	uint32 ChunkCount = (uint32)FMath::Max<uint64>((File.Size + OBJ_CHUNK_SIZE - 1) / OBJ_CHUNK_SIZE, 1);
+	FMemoryArena& ScratchArena = FMemory::GetScratchArena();
+	FScopedTemporaryMemory ScratchMemory(ScratchArena);
+	FOBJChunk* Chunks = ScratchArena.PushArray<FOBJChunk>(ChunkCount);
+
+	const char* ChunkBegin = Begin;
+	for (uint32 ChunkIndex = 0; ChunkIndex < ChunkCount; ++ChunkIndex)
+	{
+		const char* ChunkEnd = End;
+		if (ChunkIndex + 1 < ChunkCount)
+		{
+			ChunkEnd = FMath::Max(Begin + (File.Size * (ChunkIndex + 1)) / ChunkCount, ChunkBegin);
+			ChunkEnd = (ChunkEnd < End) ? FindLineEnd(ChunkEnd, End) : End;
+			ChunkEnd = (ChunkEnd < End) ? (ChunkEnd + 1) : End;
+		}
+
+		Chunks[ChunkIndex] = {};
+		Chunks[ChunkIndex].Begin = ChunkBegin;
+		Chunks[ChunkIndex].End = ChunkEnd;
+		ChunkBegin = ChunkEnd;
+	}
+
+	FOBJParseContext Context;
+	Context.Chunks = Chunks;
+	Context.Mesh = &Mesh;
+	Context.bInvalid = false;
+
+	FOBJParseContext* ContextPointer = &Context;
+	FJobSystem::ParallelFor(ChunkCount, 1, [ContextPointer](uint32 ChunkBegin, uint32 ChunkEnd)
+	{
+		for (uint32 ChunkIndex = ChunkBegin; ChunkIndex < ChunkEnd; ++ChunkIndex)
+		{
+			CountOBJChunk(ContextPointer->Chunks[ChunkIndex]);
+		}
+	});
+
+	uint64 VertexCount = 0;
+	uint64 TriangleCount = 0;
+	for (uint32 ChunkIndex = 0; ChunkIndex < ChunkCount; ++ChunkIndex)
+	{
+		Chunks[ChunkIndex].VertexOffset = VertexCount;
+		Chunks[ChunkIndex].TriangleOffset = TriangleCount;
+		VertexCount += Chunks[ChunkIndex].VertexCount;
+		TriangleCount += Chunks[ChunkIndex].TriangleCount;
+	}
+
+	if ((VertexCount > UINT32_MAX) || (TriangleCount > UINT32_MAX))
+	{
+		return EMeshLoadResult::InvalidData;
+	}
+
+	Mesh.VertexCount = (uint32)VertexCount;
+	Mesh.TriangleCount = (uint32)TriangleCount;
+	Mesh.Vertices = Arena.PushArray<FVector3>(VertexCount, CACHE_LINE_SIZE);
+	Mesh.Indices = Arena.PushArray<uint32>(3 * TriangleCount, CACHE_LINE_SIZE);
+
+	FJobSystem::ParallelFor(ChunkCount, 1, [ContextPointer](uint32 ChunkBegin, uint32 ChunkEnd)
+	{
+		for (uint32 ChunkIndex = ChunkBegin; ChunkIndex < ChunkEnd; ++ChunkIndex)
+		{
+			if (!ParseOBJChunk(ContextPointer->Chunks[ChunkIndex], *ContextPointer->Mesh))
+			{
+				ContextPointer->bInvalid = true;
+			}
+		}
+	});
+
+	return Context.bInvalid ? EMeshLoadResult::InvalidData : EMeshLoadResult::Success;
+}
+
+/*
+ *---------------------------------------------------------------------------------
+ * Binary PLY.
+ *---------------------------------------------------------------------------------
+ */
+
+enum class EPLYType : uint8
+{
+	Invalid,
+	Int8,
+	UInt8,
+	Int16,
+	UInt16,
+	Int32,
+	UInt32,
+	Float32,
+	Float64,
+};
+
+enum class EPLYSemantic : uint8
+{
+	None,
+	X,
+	Y,
+	Z,
+	VertexIndices,
+};
+
+struct FPLYProperty
+{
+	EPLYType     Type;
+
+	/** For list properties, the type of the item count. Invalid for scalar properties. */
+	EPLYType     CountType;
+
+	EPLYSemantic Semantic;
+};
+
+struct FPLYElement
+{
+	uint64       Count;
+	bool         bIsVertex;
+	bool         bIsFace;
+
+	FPLYProperty Properties[PLY_MAX_PROPERTIES];
+	uint32       PropertyCount;
+
+	/** The size of an element, if it has no list properties; 0 otherwise. */
+	uint32       FixedSize;
+};
+
+struct FPLYParseContext
+{
+	FTriangleMesh*     Mesh;
+	bool               bSwapBytes;
+
+	const uint8*       VertexData;
+	uint32             VertexSize;
+	uint32             Offsets[3];
+	EPLYType           Types[3];
+
+	const FPLYElement* FaceElement;
+	const uint8*       FaceData;
+	uint32             FaceSize;
+	std::atomic<bool>  bValid;
+};
+
+struct FPLYHeader
+{
+	FPLYElement  Elements[PLY_MAX_ELEMENTS];
+	uint32       ElementCount;
+
+	/** Whether the data is big-endian, and so its bytes must be swapped. */
+	bool         bSwapBytes;
+
+	const uint8* Data;
+};
+
+internal EPLYType ParsePLYType(const char* Token, uint64 Length)
+{
+	struct FTypeName { const char* Name; EPLYType Type; };
+	static const FTypeName TypeNames[] =
+	{
+		{ "char", EPLYType::Int8 },     { "int8", EPLYType::Int8 },
+		{ "uchar", EPLYType::UInt8 },   { "uint8", EPLYType::UInt8 },
+		{ "short", EPLYType::Int16 },   { "int16", EPLYType::Int16 },
+		{ "ushort", EPLYType::UInt16 }, { "uint16", EPLYType::UInt16 },
+		{ "int", EPLYType::Int32 },     { "int32", EPLYType::Int32 },
+		{ "uint", EPLYType::UInt32 },   { "uint32", EPLYType::UInt32 },
+		{ "float", EPLYType::Float32 }, { "float32", EPLYType::Float32 },
+		{ "double", EPLYType::Float64 }, { "float64", EPLYType::Float64 },
+	};
+
+	for (uint32 Index = 0; Index < ArrayCount(TypeNames); ++Index)
+	{
+		if ((strlen(TypeNames[Index].Name) == Length) && (memcmp(TypeNames[Index].Name, Token, Length) == 0))
+		{
+			return TypeNames[Index].Type;
+		}
+	}
+
+	return EPLYType::Invalid;
+}
+
+internal SM_INLINE uint32 GetPLYTypeSize(EPLYType Type)
+{
+	switch (Type)
+	{
+		case EPLYType::Int8:
+		case EPLYType::UInt8:   return 1;
+		case EPLYType::Int16:
+		case EPLYType::UInt16:  return 2;
+		case EPLYType::Int32:
+		case EPLYType::UInt32:
+		case EPLYType::Float32: return 4;
+		case EPLYType::Float64: return 8;
+		default:                return 0;
+	}
+}
+
+/** Reads a value of any PLY type and converts it to double. */
+internal SM_INLINE float64 ReadPLYValue(const uint8* At, EPLYType Type, bool bSwapBytes)
+{
+	uint8 Bytes[8];
+	uint32 Size = GetPLYTypeSize(Type);
+	for (uint32 Index = 0; Index < Size; ++Index)
+	{
+		Bytes[Index] = bSwapBytes ? At[Size - 1 - Index] : At[Index];
+	}
+
+	switch (Type)
+	{
+		case EPLYType::Int8:    { int8 Value;    memcpy(&Value, Bytes, 1); return (float64)Value; }
+		case EPLYType::UInt8:   { uint8 Value;   memcpy(&Value, Bytes, 1); return (float64)Value; }
+		case EPLYType::Int16:   { int16 Value;   memcpy(&Value, Bytes, 2); return (float64)Value; }
+		case EPLYType::UInt16:  { uint16 Value;  memcpy(&Value, Bytes, 2); return (float64)Value; }
+		case EPLYType::Int32:   { int32 Value;   memcpy(&Value, Bytes, 4); return (float64)Value; }
+		case EPLYType::UInt32:  { uint32 Value;  memcpy(&Value, Bytes, 4); return (float64)Value; }
+		case EPLYType::Float32: { float Value;   memcpy(&Value, Bytes, 4); return (float64)Value; }
+		case EPLYType::Float64: { float64 Value; memcpy(&Value, Bytes, 8); return Value; }
+		default:                return 0.0;
+	}
+}
+
+/** Reads an index or list count. Negative and fractional values are returned as UINT32_MAX, so they fail the range checks. */
+internal SM_INLINE uint32 ReadPLYIndex(const uint8* At, EPLYType Type, bool bSwapBytes)
+{
+	float64 Value = ReadPLYValue(At, Type, bSwapBytes);
+	return ((Value >= 0.0) && (Value < 4294967295.0) && (Value == (float64)(uint32)Value)) ? (uint32)Value : UINT32_MAX;
+}
+
+internal EMeshLoadResult ParsePLYHeader(const FMappedFile& File, out FPLYHeader& Header)
+{
+	const char* Begin = (const char*)File.Data;
+	const char* End = Begin + File.Size;
+	Header = {};
+
+	#define TOKEN_IS(INDEX, STRING) ((TokenLengths[INDEX] == sizeof(STRING) - 1) && (memcmp(Tokens[INDEX], STRING, sizeof(STRING) - 1) == 0))
+
+	bool bHasFormat = false;
+	const char* Line = Begin;
+	for (;;)
+	{
+		if (Line >= End)
+		{
+			return EMeshLoadResult::InvalidData;
+		}
+
+		const char* LineEnd = FindLineEnd(Line, End);
+
+		const char* Tokens[6];
+		uint64 TokenLengths[6];
+		uint32 TokenCount = 0;
+		for (const char* At = SkipSpaces(Line, LineEnd); (At < LineEnd) && (TokenCount < ArrayCount(Tokens)); At = SkipSpaces(At, LineEnd))
+		{
+			const char* TokenEnd = SkipToken(At, LineEnd);
+			Tokens[TokenCount] = At;
+			TokenLengths[TokenCount] = (uint64)(TokenEnd - At);
+			++TokenCount;
+			At = TokenEnd;
+		}
+
+		Line = LineEnd + 1;
+		if (TokenCount == 0)
+		{
+			continue;
+		}
+
+		if (TOKEN_IS(0, "end_header"))
+		{
+			break;
+		}
+		else if (TOKEN_IS(0, "format") && (TokenCount >= 2))
+		{
+			if (TOKEN_IS(1, "binary_little_endian"))
+			{
+				Header.bSwapBytes = false;
+			}
+			else if (TOKEN_IS(1, "binary_big_endian"))
+			{
+				Header.bSwapBytes = true;
+			}
+			else
+			{
+				// ASCII PLY is not supported.
+				return EMeshLoadResult::UnsupportedFormat;
+			}
+			bHasFormat = true;
+		}
+		else if (TOKEN_IS(0, "element") && (TokenCount >= 3))
+		{
+			if (Header.ElementCount == PLY_MAX_ELEMENTS)
+			{
+				return EMeshLoadResult::UnsupportedFormat;
+			}
+
+			int64 Count = 0;
+			if (!ParseInteger(Tokens[2], Tokens[2] + TokenLengths[2], Count) || (Count < 0))
+			{
+				return EMeshLoadResult::InvalidData;
+			}
+
+			FPLYElement& Element = Header.Elements[Header.ElementCount++];
+			Element.Count = (uint64)Count;
+			Element.bIsVertex = TOKEN_IS(1, "vertex");
+			Element.bIsFace = TOKEN_IS(1, "face");
+		}
+		else if (TOKEN_IS(0, "property") && (TokenCount >= 3))
+		{
+			if ((Header.ElementCount == 0) || (Header.Elements[Header.ElementCount - 1].PropertyCount == PLY_MAX_PROPERTIES))
+			{
+				return EMeshLoadResult::InvalidData;
+			}
+
+			FPLYElement& Element = Header.Elements[Header.ElementCount - 1];
+			FPLYProperty& Property = Element.Properties[Element.PropertyCount++];
+			Property = {};
+
+			uint32 NameToken = 2;
+			if (TOKEN_IS(1, "list"))
+			{
+				if (TokenCount < 5)
+				{
+					return EMeshLoadResult::InvalidData;
+				}
+				Property.CountType = ParsePLYType(Tokens[2], TokenLengths[2]);
+				Property.Type = ParsePLYType(Tokens[3], TokenLengths[3]);
+				NameToken = 4;
+
+				if (Property.CountType == EPLYType::Invalid)
+				{
+					return EMeshLoadResult::InvalidData;
+				}
+			}
+			else
+			{
+				Property.Type = ParsePLYType(Tokens[1], TokenLengths[1]);
+			}
+
+			if (Property.Type == EPLYType::Invalid)
+			{
+				return EMeshLoadResult::InvalidData;
+			}
+
+			bool bIsList = (Property.CountType != EPLYType::Invalid);
+			if (Element.bIsVertex && !bIsList)
+			{
+				Property.Semantic = TOKEN_IS(NameToken, "x") ? EPLYSemantic::X : (TOKEN_IS(NameToken, "y") ? EPLYSemantic::Y : (TOKEN_IS(NameToken, "z") ? EPLYSemantic::Z : EPLYSemantic::None));
+			}
+			else if (Element.bIsFace && bIsList && (TOKEN_IS(NameToken, "vertex_indices") || TOKEN_IS(NameToken, "vertex_index")))
+			{
+				Property.Semantic = EPLYSemantic::VertexIndices;
+			}
+		}
+	}
+
+	#undef TOKEN_IS
+
+	if (!bHasFormat)
+	{
+		return EMeshLoadResult::InvalidData;
+	}
+
+	for (uint32 ElementIndex = 0; ElementIndex < Header.ElementCount; ++ElementIndex)
+	{
+		FPLYElement& Element = Header.Elements[ElementIndex];
+		Element.FixedSize = 0;
+		for (uint32 PropertyIndex = 0; PropertyIndex < Element.PropertyCount; ++PropertyIndex)
+		{
+			const FPLYProperty& Property = Element.Properties[PropertyIndex];
+			if (Property.CountType != EPLYType::Invalid)
+			{
+				Element.FixedSize = 0;
+				break;
+			}
+			Element.FixedSize += GetPLYTypeSize(Property.Type);
+		}
+	}
+
+	Header.Data = (const uint8*)Line;
+	return EMeshLoadResult::Success;
+}
+
+/**
+ * Walks the records of an element with list properties, until its end.
+ *
+ * @param TriangleCount The number of triangles of the vertex index lists, once triangulated.
+ * @param bAllTriangles Whether all the vertex index lists have exactly 3 indices.
+ *
+ * @return The end of the element's data, or nullptr if the file is truncated.
+ */
+internal const uint8* WalkPLYElement(const FPLYElement& Element, const uint8* At, const uint8* End, bool bSwapBytes, out uint64& TriangleCount, out bool& bAllTriangles)
+{
+	TriangleCount = 0;
+	bAllTriangles = true;
+
+	for (uint64 Record = 0; Record < Element.Count; ++Record)
+	{
+		for (uint32 PropertyIndex = 0; PropertyIndex < Element.PropertyCount; ++PropertyIndex)
+		{
+			const FPLYProperty& Property = Element.Properties[PropertyIndex];
+			if (Property.CountType == EPLYType::Invalid)
+			{
+				At += GetPLYTypeSize(Property.Type);
+				continue;
+			}
+
+			uint32 CountSize = GetPLYTypeSize(Property.CountType);
+			if (At + CountSize > End)
+			{
+				return nullptr;
+			}
+
+			uint32 Count = ReadPLYIndex(At, Property.CountType, bSwapBytes);
+			if (Count == UINT32_MAX)
+			{
+				return nullptr;
+			}
+			At += CountSize + (uint64)Count * GetPLYTypeSize(Property.Type);
+
+			if (Property.Semantic == EPLYSemantic::VertexIndices)
+			{
+				TriangleCount += (Count >= 3) ? (Count - 2) : 0;
+				bAllTriangles &= (Count == 3);
+			}
+		}
+
+		if (At > End)
+		{
+			return nullptr;
+		}
+	}
+
+	return At;
+}
+
+/**
+ * Reads the triangles of a face record, triangulating polygons as fans.
+ *
+ * @return The end of the record.
+ */
+internal const uint8* ReadPLYFace(const FPLYElement& Element, const uint8* At, bool bSwapBytes, uint32 VertexCount, out uint32*& Index, out bool& bValid)
+{
+	for (uint32 PropertyIndex = 0; PropertyIndex < Element.PropertyCount; ++PropertyIndex)
+	{
+		const FPLYProperty& Property = Element.Properties[PropertyIndex];
+		uint32 TypeSize = GetPLYTypeSize(Property.Type);
+		if (Property.CountType == EPLYType::Invalid)
+		{
+			At += TypeSize;
+			continue;
+		}
+
+		uint32 Count = ReadPLYIndex(At, Property.CountType, bSwapBytes);
+		At += GetPLYTypeSize(Property.CountType);
+
+		if (Property.Semantic == EPLYSemantic::VertexIndices)
+		{
+			uint32 FirstIndex = 0;
+			uint32 PreviousIndex = 0;
+			for (uint32 Corner = 0; Corner < Count; ++Corner)
+			{
+				uint32 CurrentIndex = ReadPLYIndex(At + (uint64)Corner * TypeSize, Property.Type, bSwapBytes);
+				if (CurrentIndex >= VertexCount)
+				{
+					bValid = false;
+					CurrentIndex = 0;
+				}
+
+				if (Corner == 0)
+				{
+					FirstIndex = CurrentIndex;
+				}
+				else if (Corner >= 2)
+				{
+					*Index++ = FirstIndex;
+					*Index++ = PreviousIndex;
+					*Index++ = CurrentIndex;
+				}
+				PreviousIndex = CurrentIndex;
+			}
+		}
+
+		At += (uint64)Count * TypeSize;
+	}
+
+	return At;
+}
+
+internal EMeshLoadResult LoadPLY(const FMappedFile& File, out FTriangleMesh& Mesh, FMemoryArena& Arena)
+{
+	FPLYHeader Header;
+	EMeshLoadResult Result = ParsePLYHeader(File, Header);
+	if (Result != EMeshLoadResult::Success)
+	{
+		return Result;
+	}
+
+	const uint8* End = File.Data + File.Size;
+	const uint8* At = Header.Data;
+
+	const FPLYElement* VertexElement = nullptr;
+	const uint8* VertexData = nullptr;
+	const FPLYElement* FaceElement = nullptr;
+	const uint8* FaceData = nullptr;
+	uint64 TriangleCount = 0;
+	bool bAllTriangles = true;
+
+	// Find where the data of every element starts. Elements with list properties must be walked record by record.
+	for (uint32 ElementIndex = 0; ElementIndex < Header.ElementCount; ++ElementIndex)
+	{
+		const FPLYElement& Element = Header.Elements[ElementIndex];
+		const uint8* ElementData = At;
+
+		if (Element.FixedSize > 0)
+		{
+			uint64 Size = Element.Count * Element.FixedSize;
+			if (Size > (uint64)(End - At))
+			{
+				return EMeshLoadResult::InvalidData;
+			}
+			At += Size;
+		}
+		else if (Element.PropertyCount > 0)
+		{
+			uint64 ElementTriangleCount;
+			bool bElementAllTriangles;
+			At = WalkPLYElement(Element, At, End, Header.bSwapBytes, ElementTriangleCount, bElementAllTriangles);
+			if (!At)
+			{
+				return EMeshLoadResult::InvalidData;
+			}
+
+			if (Element.bIsFace && !FaceElement)
+			{
+				TriangleCount = ElementTriangleCount;
+				bAllTriangles = bElementAllTriangles;
+			}
+		}
+
+		if (Element.bIsVertex && !VertexElement)
+		{
+			VertexElement = &Element;
+			VertexData = ElementData;
+		}
+		else if (Element.bIsFace && !FaceElement)
+		{
+			FaceElement = &Element;
+			FaceData = ElementData;
+		}
+	}
+
+	// The vertices must have a fixed size, so they can be addressed directly.
+	if (!VertexElement || (VertexElement->FixedSize == 0) || (VertexElement->Count > UINT32_MAX) || (TriangleCount > UINT32_MAX))
+	{
+		return EMeshLoadResult::InvalidData;
+	}
+
+	FPLYParseContext Context;
+	Context.Mesh = &Mesh;
+	Context.bSwapBytes = Header.bSwapBytes;
+	Context.VertexData = VertexData;
+	Context.VertexSize = VertexElement->FixedSize;
+	Context.Types[0] = Context.Types[1] = Context.Types[2] = EPLYType::Invalid;
+	Context.FaceElement = FaceElement;
+	Context.FaceData = FaceData;
+	Context.FaceSize = 0;
+	Context.bValid = true;
+
+	for (uint32 PropertyIndex = 0, Offset = 0; PropertyIndex < VertexElement->PropertyCount; ++PropertyIndex)
+	{
+		const FPLYProperty& Property = VertexElement->Properties[PropertyIndex];
+		if (Property.Semantic != EPLYSemantic::None)
+		{
+			uint32 Axis = (uint32)Property.Semantic - (uint32)EPLYSemantic::X;
+			Context.Offsets[Axis] = Offset;
+			Context.Types[Axis] = Property.Type;
+		}
+		Offset += GetPLYTypeSize(Property.Type);
+	}
+
+	if ((Context.Types[0] == EPLYType::Invalid) || (Context.Types[1] == EPLYType::Invalid) || (Context.Types[2] == EPLYType::Invalid))
+	{
+		return EMeshLoadResult::InvalidData;
+	}
+
+	Mesh.VertexCount = (uint32)VertexElement->Count;
+	Mesh.TriangleCount = (uint32)TriangleCount;
+	Mesh.Vertices = Arena.PushArray<FVector3>(Mesh.VertexCount, CACHE_LINE_SIZE);
+	Mesh.Indices = Arena.PushArray<uint32>(3 * (uint64)Mesh.TriangleCount, CACHE_LINE_SIZE);
+
+	FPLYParseContext* ContextPointer = &Context;
+	FJobSystem::ParallelFor(Mesh.VertexCount, PLY_BATCH_SIZE, [ContextPointer](uint32 Begin, uint32 End)
+	{
+		const FPLYParseContext& Context = *ContextPointer;
+		for (uint32 VertexIndex = Begin; VertexIndex < End; ++VertexIndex)
+		{
+			const uint8* Vertex = Context.VertexData + (uint64)VertexIndex * Context.VertexSize;
+			Context.Mesh->Vertices[VertexIndex] = FVector3(
+				(float)ReadPLYValue(Vertex + Context.Offsets[0], Context.Types[0], Context.bSwapBytes),
+				(float)ReadPLYValue(Vertex + Context.Offsets[1], Context.Types[1], Context.bSwapBytes),
+				(float)ReadPLYValue(Vertex + Context.Offsets[2], Context.Types[2], Context.bSwapBytes));
+		}
+	});
+
+	if (!FaceElement || (TriangleCount == 0))
+	{
+		return EMeshLoadResult::Success;
+	}
+
+	// If every face is a triangle and there are no other list properties, all face records have the same size,
+	//   so they can be read in parallel. Otherwise, the records are read in order.
+	bool bFixedFaceSize = bAllTriangles;
+	for (uint32 PropertyIndex = 0; PropertyIndex < FaceElement->PropertyCount; ++PropertyIndex)
+	{
+		const FPLYProperty& Property = FaceElement->Properties[PropertyIndex];
+		if (Property.CountType == EPLYType::Invalid)
+		{
+			Context.FaceSize += GetPLYTypeSize(Property.Type);
+		}
+		else if (Property.Semantic == EPLYSemantic::VertexIndices)
+		{
+			Context.FaceSize += GetPLYTypeSize(Property.CountType) + 3 * GetPLYTypeSize(Property.Type);
+		}
+		else
+		{
+			bFixedFaceSize = false;
+		}
+	}
+
+	if (bFixedFaceSize)
+	{
+		FJobSystem::ParallelFor(Mesh.TriangleCount, PLY_BATCH_SIZE, [ContextPointer](uint32 Begin, uint32 End)
+		{
+			FPLYParseContext& Context = *ContextPointer;
+			bool bBatchValid = true;
+
+			uint32* Index = Context.Mesh->Indices + 3 * (uint64)Begin;
+			for (uint32 FaceIndex = Begin; FaceIndex < End; ++FaceIndex)
+			{
+				const uint8* Face = Context.FaceData + (uint64)FaceIndex * Context.FaceSize;
+				ReadPLYFace(*Context.FaceElement, Face, Context.bSwapBytes, Context.Mesh->VertexCount, Index, bBatchValid);
+			}
+
+			if (!bBatchValid)
+			{
+				Context.bValid = false;
+			}
+		});
+	}
+	else
+	{
+		bool bRecordsValid = true;
+		uint32* Index = Mesh.Indices;
+		const uint8* Face = FaceData;
+		for (uint64 FaceIndex = 0; FaceIndex < FaceElement->Count; ++FaceIndex)
+		{
+			Face = ReadPLYFace(*FaceElement, Face, Context.bSwapBytes, Mesh.VertexCount, Index, bRecordsValid);
+		}
+		Context.bValid = bRecordsValid;
+	}
+
+	return Context.bValid ? EMeshLoadResult::Success : EMeshLoadResult::InvalidData;
+}
+
+/*
+ *---------------------------------------------------------------------------------
+ * FMeshLoader.
+ *---------------------------------------------------------------------------------
+ */
+
+EMeshLoadResult FMeshLoader::Load(const char* FileName, out FTriangleMesh& Mesh, FMemoryArena& Arena)
+{
+	Mesh = {};
+
+	FMappedFile File;
+	if (!FPlatform::MapFile(FileName, File))
+	{
+		return EMeshLoadResult::CannotOpenFile;
+	}
+
+	FTemporaryMemory MeshMemory = Arena.BeginTemporaryMemory();
+
+	EMeshLoadResult Result;
+	if ((File.Size >= 4) && (memcmp(File.Data, "ply", 3) == 0) && ((File.Data[3] == '\n') || (File.Data[3] == '\r')))
+	{
+		Result = LoadPLY(File, Mesh, Arena);
+	}
+	else
+	{
+		Result = LoadOBJ(File, Mesh, Arena);
+	}
+
+	FPlatform::UnmapFile(File);
+
+	if (Result != EMeshLoadResult::Success)
+	{
+		// Give back whatever was allocated for the mesh.
+		Arena.EndTemporaryMemory(MeshMemory);
+		Mesh = {};
+	}
+	return Result;
+}
+
+const char* FMeshLoader::GetResultString(EMeshLoadResult Result)
+{
+	switch (Result)
+	{
+		case EMeshLoadResult::Success:           return "Success";
+		case EMeshLoadResult::CannotOpenFile:    return "The file can't be opened";
+		case EMeshLoadResult::UnsupportedFormat: return "The file format is not supported";
+		case EMeshLoadResult::InvalidData:       return "The file is malformed";
+	}
+
+	return "Unknown";
+}
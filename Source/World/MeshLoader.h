@@ -0,0 +1,59 @@
+/**
+ *--------------------------------------------
+ * MeshLoader.h <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 12 2022.
+ */
+
+#pragma once
+
+#include "World.h"
+
+#include "Core/Memory/MemoryArena.h"
+
+enum class EMeshLoadResult : uint8
+{
+	Success,
+
+	/** The file doesn't exist or couldn't be mapped. */
+	CannotOpenFile,
+
+	/** The file is neither an OBJ nor a binary PLY file. */
+	UnsupportedFormat,
+
+	/** The file is truncated, malformed or references vertices that don't exist. */
+	InvalidData,
+};
+
+/**
+ *---------------------------------------------------------------------------------
+ * Loads triangle meshes from OBJ and binary PLY files.
+ * The files are memory mapped and parsed in parallel, using the job system: OBJ
+ *   files are split in chunks of whole lines, which are first counted and then
+ *   parsed directly in their place in the output buffers. The only allocations
+ *   are the vertex and index buffers themselves, made from the given arena (plus
+ *   the chunk table, made from the scratch arena).
+ *---------------------------------------------------------------------------------
+ */
+class FMeshLoader
+{
+public:
+	/**
+	 * Loads a mesh. The format is detected from the file's content (PLY files start with 'ply');
+	 *   everything else is parsed as OBJ.
+	 * Polygons with more than 3 vertices are triangulated as fans. Only the positions are loaded;
+	 *   normals, texture coordinates and materials are ignored, and the mesh uses material 0.
+	 *
+	 * @param FileName The path to the file.
+	 * @param Mesh The loaded mesh. Left empty if the load fails.
+	 * @param Arena The arena the buffers of the mesh are allocated from. Can't be a scratch arena. If the
+	 *   load fails, the arena is rolled back to its previous state.
+	 *
+	 * @return The result of the load.
+	 */
+	static EMeshLoadResult Load(const char* FileName, out FTriangleMesh& Mesh, FMemoryArena& Arena);
+
+	/** @return A description of a load result, for printing. */
+	static const char* GetResultString(EMeshLoadResult Result);
+};
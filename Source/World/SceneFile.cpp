@@ -0,0 +1,444 @@
+/**
+ *--------------------------------------------
+ * SceneFile.cpp <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 13 2022.
+ */
+
+#include "SceneFile.h"
+
+#include "Core/Memory/Memory.h"
+
+#include <cstdio>
+
+// The blocks store these types exactly as they are in memory.
+static_assert(sizeof(FVector3) == 12, "The scene file layout of FVector3 has changed!");
+static_assert(sizeof(FCamera) == 32, "The scene file layout of FCamera has changed!");
+static_assert(sizeof(FEnvironment) == 36, "The scene file layout of FEnvironment has changed!");
+static_assert(sizeof(FSphere) == 20, "The scene file layout of FSphere has changed!");
+static_assert(sizeof(FPlane) == 20, "The scene file layout of FPlane has changed!");
+static_assert(sizeof(FMaterial) == 32, "The scene file layout of FMaterial has changed!");
+static_assert(sizeof(FBVHBuildStats) == 24, "The scene file layout of FBVHBuildStats has changed!");
+static_assert(sizeof(FSceneFileMesh) == 96, "The scene file layout of FSceneFileMesh has changed!");
+static_assert(sizeof(FSceneFileHeader) == 248, "The scene file layout of FSceneFileHeader has changed!");
+
+/*
+ *---------------------------------------------------------------------------------
+ * Saving.
+ *---------------------------------------------------------------------------------
+ */
+
+struct FSceneFileWriter
+{
+	FILE*  File;
+	uint64 Offset;
+	bool   bFailed;
+};
+
+/** Writes a block at the next aligned offset. */
+internal FSceneFileBlock WriteBlock(FSceneFileWriter& Writer, const void* Data, uint64 Size)
+{
+	FSceneFileBlock Block = {};
+	if (Size == 0)
+	{
+		return Block;
+	}
+
+	static const uint8 Padding[SCENE_FILE_BLOCK_ALIGNMENT] = {};
+	uint64 PaddingSize = (SCENE_FILE_BLOCK_ALIGNMENT - (Writer.Offset % SCENE_FILE_BLOCK_ALIGNMENT)) % SCENE_FILE_BLOCK_ALIGNMENT;
+	if ((PaddingSize > 0) && (fwrite(Padding, PaddingSize, 1, Writer.File) != 1))
+	{
+		Writer.bFailed = true;
+	}
+	Writer.Offset += PaddingSize;
+
+	if (fwrite(Data, Size, 1, Writer.File) != 1)
+	{
+		Writer.bFailed = true;
+	}
+
+	Block.Offset = Writer.Offset;
+	Block.Size = Size;
+	Writer.Offset += Size;
+	return Block;
+}
+
+bool FSceneFile::Save(const char* FileName, const FWorld& World, const FWorldAcceleration& Acceleration)
+{
+	FILE* OutputFile = FPlatform::OpenFile(FileName, "wb");
+	if (!OutputFile)
+	{
+		return false;
+	}
+
+	FSceneFileHeader Header = {};
+	Header.Magic = SCENE_FILE_MAGIC;
+	Header.Version = SCENE_FILE_VERSION;
+	Header.Camera = World.Camera;
+	Header.Environment = World.Environment;
+	Header.SphereCount = World.SphereCount;
+	Header.PlaneCount = World.PlaneCount;
+	Header.MeshCount = World.MeshCount;
+	Header.MaterialCount = World.MaterialCount;
+
+	// The header is written again at the end, once the block offsets are known.
+	FSceneFileWriter Writer = {};
+	Writer.File = OutputFile;
+	Writer.bFailed = (fwrite(&Header, sizeof(FSceneFileHeader), 1, OutputFile) != 1);
+	Writer.Offset = sizeof(FSceneFileHeader);
+
+	Header.Spheres = WriteBlock(Writer, World.Spheres, sizeof(FSphere) * (uint64)World.SphereCount);
+	Header.Planes = WriteBlock(Writer, World.Planes, sizeof(FPlane) * (uint64)World.PlaneCount);
+	Header.Materials = WriteBlock(Writer, World.Materials, sizeof(FMaterial) * (uint64)World.MaterialCount);
+
+	const FBVH& SphereBVH = Acceleration.SphereBVH;
+	Header.SphereBVHNodeCount = SphereBVH.NodeCount;
+	Header.SphereBVHStats = Acceleration.SphereBVHStats;
+	Header.SphereBVHNodes = WriteBlock(Writer, SphereBVH.Nodes, sizeof(FBVHNode) * (uint64)SphereBVH.NodeCount);
+	Header.SphereBVHPrimitiveIndices = WriteBlock(Writer, SphereBVH.PrimitiveIndices, sizeof(uint32) * (uint64)SphereBVH.PrimitiveCount);
+	Header.SphereData = WriteBlock(Writer, Acceleration.SphereData.GetMemory(), FSphereSoA::GetMemorySize(Acceleration.SphereData.Count));
+
+	FMemoryArena& ScratchArena = FMemory::GetScratchArena();
+	FScopedTemporaryMemory ScratchMemory(ScratchArena);
+
+	FSceneFileMesh* FileMeshes = ScratchArena.PushArrayZero<FSceneFileMesh>(World.MeshCount);
+	for (uint32 MeshIndex = 0; MeshIndex < World.MeshCount; ++MeshIndex)
+	{
+		const FTriangleMesh& Mesh = World.Meshes[MeshIndex];
+		const FBVH& MeshBVH = Acceleration.MeshBVHs[MeshIndex];
+		FSceneFileMesh& FileMesh = FileMeshes[MeshIndex];
+
+		FileMesh.VertexCount = Mesh.VertexCount;
+		FileMesh.TriangleCount = Mesh.TriangleCount;
+		FileMesh.MaterialIndex = Mesh.MaterialIndex;
+		FileMesh.BVHNodeCount = MeshBVH.NodeCount;
+
+		FileMesh.Vertices = WriteBlock(Writer, Mesh.Vertices, sizeof(FVector3) * (uint64)Mesh.VertexCount);
+		FileMesh.Indices = WriteBlock(Writer, Mesh.Indices, 3 * sizeof(uint32) * (uint64)Mesh.TriangleCount);
+		if (Mesh.TriangleMaterialIndices)
+		{
+			FileMesh.TriangleMaterialIndices = WriteBlock(Writer, Mesh.TriangleMaterialIndices, sizeof(uint16) * (uint64)Mesh.TriangleCount);
+		}
+		FileMesh.BVHNodes = WriteBlock(Writer, MeshBVH.Nodes, sizeof(FBVHNode) * (uint64)MeshBVH.NodeCount);
+		FileMesh.BVHPrimitiveIndices = WriteBlock(Writer, MeshBVH.PrimitiveIndices, sizeof(uint32) * (uint64)MeshBVH.PrimitiveCount);
+	}
+	Header.Meshes = WriteBlock(Writer, FileMeshes, sizeof(FSceneFileMesh) * (uint64)World.MeshCount);
+
+	Header.FileSize = Writer.Offset;
+	if ((fseek(OutputFile, 0, SEEK_SET) != 0) || (fwrite(&Header, sizeof(FSceneFileHeader), 1, OutputFile) != 1))
+	{
+		Writer.bFailed = true;
+	}
+
+	fclose(OutputFile);
+	return !Writer.bFailed;
+}
+
+/*
+ *---------------------------------------------------------------------------------
+ * Loading.
+ *---------------------------------------------------------------------------------
+ */
+
+/** @return True if the block is inside the file, aligned and exactly of the expected size. */
+internal bool IsBlockValid(const FMappedFile& File, const FSceneFileBlock& Block, uint64 ExpectedSize)
+{
+	if (Block.Size != ExpectedSize)
+	{
+		return false;
+	}
+	if (Block.Size == 0)
+	{
+		return true;
+	}
+
+	return (Block.Offset % SCENE_FILE_BLOCK_ALIGNMENT == 0) && (Block.Offset <= File.Size) && (Block.Size <= File.Size - Block.Offset);
+}
+
+/** @return A pointer to the start of a block, or nullptr if the block is empty. */
+template<typename T>
+internal SM_INLINE T* GetBlockData(const FMappedFile& File, const FSceneFileBlock& Block)
+{
+	// The arrays are never written by the renderer, so the world can point at the read-only mapping.
+	return (Block.Size > 0) ? (T*)(File.Data + Block.Offset) : nullptr;
+}
+
+/** Points a hierarchy at the arrays in the file. */
+internal void SetBVHFromFile(const FMappedFile& File, FBVH& BVH, const FSceneFileBlock& Nodes, uint32 NodeCount,
+	const FSceneFileBlock& PrimitiveIndices, uint32 PrimitiveCount)
+{
+	BVH.Nodes = GetBlockData<FBVHNode>(File, Nodes);
+	BVH.NodeCount = NodeCount;
+	BVH.PrimitiveIndices = GetBlockData<uint32>(File, PrimitiveIndices);
+	BVH.PrimitiveCount = PrimitiveCount;
+}
+
+/** @return True if every one of the indices is less than 'Count'. */
+template<typename T>
+internal bool AreIndicesValid(const T* Indices, uint64 IndexCount, uint32 Count)
+{
+	for (uint64 Index = 0; Index < IndexCount; ++Index)
+	{
+		if (Indices[Index] >= Count)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * @return True if the hierarchy can be traversed without leaving its arrays: every child is stored after its parent,
+ *   every node is reached only once and no deeper than the builder would place it (so the traversal stacks of
+ *   'BVH_MAX_DEPTH' entries can't overflow), and every leaf's range is inside the primitive indices.
+ */
+internal bool IsBVHValid(const FBVH& BVH)
+{
+	if (BVH.NodeCount == 0)
+	{
+		return true;
+	}
+	if (!AreIndicesValid(BVH.PrimitiveIndices, BVH.PrimitiveCount, BVH.PrimitiveCount))
+	{
+		return false;
+	}
+
+	uint32 Stack[BVH_MAX_DEPTH][2];
+	uint32 StackSize = 0;
+	Stack[StackSize][0] = 0;
+	Stack[StackSize][1] = 0;
+	++StackSize;
+
+	uint32 VisitedCount = 0;
+	while (StackSize > 0)
+	{
+		--StackSize;
+		uint32 NodeIndex = Stack[StackSize][0];
+		uint32 Depth = Stack[StackSize][1];
+		const FBVHNode& Node = BVH.Nodes[NodeIndex];
+
+		// The children always come after their parent, so a node can only be reached twice if it's shared.
+		if (++VisitedCount > BVH.NodeCount)
+		{
+			return false;
+		}
+
+		if (Node.IsLeaf())
+		{
+			if ((uint64)Node.LeftFirst + Node.PrimitiveCount > BVH.PrimitiveCount)
+			{
+				return false;
+			}
+			continue;
+		}
+
+		if ((Node.LeftFirst <= NodeIndex) || ((uint64)Node.LeftFirst + 1 >= BVH.NodeCount) || (Depth + 1 >= BVH_MAX_DEPTH))
+		{
+			return false;
+		}
+
+		Stack[StackSize][0] = Node.LeftFirst;
+		Stack[StackSize][1] = Depth + 1;
+		++StackSize;
+		Stack[StackSize][0] = Node.LeftFirst + 1;
+		Stack[StackSize][1] = Depth + 1;
+		++StackSize;
+	}
+
+	return true;
+}
+
+/**
+ * @return True if every index stored in the scene points inside the array it indexes. The renderer uses them unchecked,
+ *   so a malformed file must be rejected here rather than read out of bounds while rendering.
+ */
+internal bool AreSceneIndicesValid(const FWorld& World, const FWorldAcceleration& Acceleration)
+{
+	for (uint32 PlaneIndex = 0; PlaneIndex < World.PlaneCount; ++PlaneIndex)
+	{
+		if (World.Planes[PlaneIndex].MaterialIndex >= World.MaterialCount)
+		{
+			return false;
+		}
+	}
+	for (uint32 SphereIndex = 0; SphereIndex < World.SphereCount; ++SphereIndex)
+	{
+		if (World.Spheres[SphereIndex].MaterialIndex >= World.MaterialCount)
+		{
+			return false;
+		}
+	}
+
+	const FSphereSoA& SphereData = Acceleration.SphereData;
+	if (!AreIndicesValid(SphereData.MaterialIndex, SphereData.Count, World.MaterialCount) ||
+		!AreIndicesValid(SphereData.SphereIndex, SphereData.Count, World.SphereCount) ||
+		!IsBVHValid(Acceleration.SphereBVH))
+	{
+		return false;
+	}
+
+	for (uint32 MeshIndex = 0; MeshIndex < World.MeshCount; ++MeshIndex)
+	{
+		const FTriangleMesh& Mesh = World.Meshes[MeshIndex];
+		bool bMaterialsValid = Mesh.TriangleMaterialIndices ?
+			AreIndicesValid(Mesh.TriangleMaterialIndices, Mesh.TriangleCount, World.MaterialCount) :
+			(Mesh.MaterialIndex < World.MaterialCount);
+
+		if (!bMaterialsValid ||
+			!AreIndicesValid(Mesh.Indices, 3 * (uint64)Mesh.TriangleCount, Mesh.VertexCount) ||
+			!IsBVHValid(Acceleration.MeshBVHs[MeshIndex]))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+internal ESceneLoadResult LoadScene(const FMappedFile& File, out FLoadedScene& Scene, FMemoryArena& Arena)
+{
+	if (File.Size < sizeof(FSceneFileHeader))
+	{
+		return (File.Size >= sizeof(uint32)) && (*(const uint32*)File.Data == SCENE_FILE_MAGIC) ?
+			ESceneLoadResult::InvalidData : ESceneLoadResult::UnsupportedFormat;
+	}
+
+	const FSceneFileHeader* Header = (const FSceneFileHeader*)File.Data;
+	if (Header->Magic != SCENE_FILE_MAGIC)
+	{
+		return ESceneLoadResult::UnsupportedFormat;
+	}
+	if (Header->Version != SCENE_FILE_VERSION)
+	{
+		return ESceneLoadResult::UnsupportedVersion;
+	}
+	if (Header->FileSize != File.Size)
+	{
+		return ESceneLoadResult::InvalidData;
+	}
+
+	// A non-empty hierarchy has at least one node, and at most 2N - 1 for N primitives.
+	auto IsNodeCountValid = [](uint32 NodeCount, uint32 PrimitiveCount) -> bool
+	{
+		return (PrimitiveCount == 0) ? (NodeCount == 0) : ((NodeCount > 0) && (NodeCount <= 2 * (uint64)PrimitiveCount - 1));
+	};
+
+	bool bValid =
+		IsBlockValid(File, Header->Spheres, sizeof(FSphere) * (uint64)Header->SphereCount) &&
+		IsBlockValid(File, Header->Planes, sizeof(FPlane) * (uint64)Header->PlaneCount) &&
+		IsBlockValid(File, Header->Materials, sizeof(FMaterial) * (uint64)Header->MaterialCount) &&
+		IsBlockValid(File, Header->Meshes, sizeof(FSceneFileMesh) * (uint64)Header->MeshCount) &&
+		IsNodeCountValid(Header->SphereBVHNodeCount, Header->SphereCount) &&
+		IsBlockValid(File, Header->SphereBVHNodes, sizeof(FBVHNode) * (uint64)Header->SphereBVHNodeCount) &&
+		IsBlockValid(File, Header->SphereBVHPrimitiveIndices, sizeof(uint32) * (uint64)Header->SphereCount) &&
+		IsBlockValid(File, Header->SphereData, FSphereSoA::GetMemorySize(Header->SphereCount));
+	if (!bValid)
+	{
+		return ESceneLoadResult::InvalidData;
+	}
+
+	const FSceneFileMesh* FileMeshes = GetBlockData<const FSceneFileMesh>(File, Header->Meshes);
+	for (uint32 MeshIndex = 0; MeshIndex < Header->MeshCount; ++MeshIndex)
+	{
+		const FSceneFileMesh& FileMesh = FileMeshes[MeshIndex];
+		uint64 TriangleCount = FileMesh.TriangleCount;
+
+		bValid =
+			IsBlockValid(File, FileMesh.Vertices, sizeof(FVector3) * (uint64)FileMesh.VertexCount) &&
+			IsBlockValid(File, FileMesh.Indices, 3 * sizeof(uint32) * TriangleCount) &&
+			((FileMesh.TriangleMaterialIndices.Size == 0) || IsBlockValid(File, FileMesh.TriangleMaterialIndices, sizeof(uint16) * TriangleCount)) &&
+			IsNodeCountValid(FileMesh.BVHNodeCount, FileMesh.TriangleCount) &&
+			IsBlockValid(File, FileMesh.BVHNodes, sizeof(FBVHNode) * (uint64)FileMesh.BVHNodeCount) &&
+			IsBlockValid(File, FileMesh.BVHPrimitiveIndices, sizeof(uint32) * TriangleCount);
+		if (!bValid)
+		{
+			return ESceneLoadResult::InvalidData;
+		}
+	}
+
+	FWorld& World = Scene.World;
+	World.Camera = Header->Camera;
+	World.Environment = Header->Environment;
+	World.Spheres = GetBlockData<FSphere>(File, Header->Spheres);
+	World.SphereCount = Header->SphereCount;
+	World.Planes = GetBlockData<FPlane>(File, Header->Planes);
+	World.PlaneCount = Header->PlaneCount;
+	World.Materials = GetBlockData<FMaterial>(File, Header->Materials);
+	World.MaterialCount = Header->MaterialCount;
+
+	FWorldAcceleration& Acceleration = Scene.Acceleration;
+	Acceleration.Reset(Header->MeshCount);
+	SetBVHFromFile(File, Acceleration.SphereBVH, Header->SphereBVHNodes, Header->SphereBVHNodeCount,
+		Header->SphereBVHPrimitiveIndices, Header->SphereCount);
+	Acceleration.SphereBVHStats = Header->SphereBVHStats;
+	Acceleration.SphereData.SetFromMemory(GetBlockData<const void>(File, Header->SphereData), Header->SphereCount);
+
+	World.MeshCount = Header->MeshCount;
+	World.Meshes = Arena.PushArray<FTriangleMesh>(World.MeshCount);
+	for (uint32 MeshIndex = 0; MeshIndex < World.MeshCount; ++MeshIndex)
+	{
+		const FSceneFileMesh& FileMesh = FileMeshes[MeshIndex];
+
+		FTriangleMesh& Mesh = World.Meshes[MeshIndex];
+		Mesh.Vertices = GetBlockData<FVector3>(File, FileMesh.Vertices);
+		Mesh.VertexCount = FileMesh.VertexCount;
+		Mesh.Indices = GetBlockData<uint32>(File, FileMesh.Indices);
+		Mesh.TriangleCount = FileMesh.TriangleCount;
+		Mesh.TriangleMaterialIndices = GetBlockData<uint16>(File, FileMesh.TriangleMaterialIndices);
+		Mesh.MaterialIndex = FileMesh.MaterialIndex;
+
+		SetBVHFromFile(File, Acceleration.MeshBVHs[MeshIndex], FileMesh.BVHNodes, FileMesh.BVHNodeCount,
+			FileMesh.BVHPrimitiveIndices, FileMesh.TriangleCount);
+	}
+
+	// A single pass over the index arrays; cheap next to mapping the file, and it keeps the renderer's hot loops unchecked.
+	if (!AreSceneIndicesValid(World, Acceleration))
+	{
+		return ESceneLoadResult::InvalidData;
+	}
+
+	return ESceneLoadResult::Success;
+}
+
+ESceneLoadResult FSceneFile::Load(const char* FileName, out FLoadedScene& Scene, FMemoryArena& Arena)
+{
+	Release(Scene);
+
+	if (!FPlatform::MapFile(FileName, Scene.File))
+	{
+		return ESceneLoadResult::CannotOpenFile;
+	}
+
+	FTemporaryMemory SceneMemory = Arena.BeginTemporaryMemory();
+	ESceneLoadResult Result = LoadScene(Scene.File, Scene, Arena);
+	if (Result != ESceneLoadResult::Success)
+	{
+		Arena.EndTemporaryMemory(SceneMemory);
+		Release(Scene);
+	}
+	return Result;
+}
+
+void FSceneFile::Release(FLoadedScene& Scene)
+{
+	// Only the descriptor arrays were allocated; everything else points inside the file.
+	Scene.World = {};
+	Scene.Acceleration.Release();
+
+	FPlatform::UnmapFile(Scene.File);
+}
+
+const char* FSceneFile::GetResultString(ESceneLoadResult Result)
+{
+	switch (Result)
+	{
+		case ESceneLoadResult::Success:            return "Success";
+		case ESceneLoadResult::CannotOpenFile:     return "The file can't be opened";
+		case ESceneLoadResult::UnsupportedFormat:  return "The file is not a scene file";
+		case ESceneLoadResult::UnsupportedVersion: return "The scene file version is not supported";
+		case ESceneLoadResult::InvalidData:        return "The file is malformed";
+	}
+
+	return "Unknown";
+}
@@ -0,0 +1,155 @@
+/**
+ *--------------------------------------------
+ * SceneFile.h <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 13 2022.
+ */
+
+#pragma once
+
+#include "Core/Platform/Platform.h"
+#include "World/World.h"
+#include "World/WorldAcceleration.h"
+
+/** The characters 'SMSC', read as a little-endian integer. */
+#define SCENE_FILE_MAGIC   0x43534D53
+
+/** Incremented every time the layout of the file changes. Files of other versions are rejected. */
+#define SCENE_FILE_VERSION 3
+
+/** The alignment of every block of the file, relative to its start. Enough for the SIMD arrays and for cache lines. */
+#define SCENE_FILE_BLOCK_ALIGNMENT 64
+
+/** A range of the file, relative to its start. Empty blocks have a size (and offset) of 0. */
+struct FSceneFileBlock
+{
+	uint64 Offset;
+	uint64 Size;
+};
+
+struct FSceneFileMesh
+{
+	uint32          VertexCount;
+	uint32          TriangleCount;
+	uint32          MaterialIndex;
+	uint32          BVHNodeCount;
+
+	FSceneFileBlock Vertices;
+	FSceneFileBlock Indices;
+
+	/** Empty if all triangles use 'MaterialIndex'. */
+	FSceneFileBlock TriangleMaterialIndices;
+
+	FSceneFileBlock BVHNodes;
+	FSceneFileBlock BVHPrimitiveIndices;
+};
+
+/**
+ * The start of a scene file. Every array of the scene is stored in its own block, in the exact
+ *   in-memory layout, so loading only has to point the world at the mapped file.
+ */
+struct FSceneFileHeader
+{
+	uint32          Magic;
+	uint32          Version;
+
+	/** The size of the whole file, in bytes. */
+	uint64          FileSize;
+
+	FCamera         Camera;
+	FEnvironment    Environment;
+
+	uint32          SphereCount;
+	uint32          PlaneCount;
+	uint32          MeshCount;
+	uint32          MaterialCount;
+
+	FSceneFileBlock Spheres;
+	FSceneFileBlock Planes;
+
+	/** A 'FSceneFileMesh' for every mesh. */
+	FSceneFileBlock Meshes;
+
+	FSceneFileBlock Materials;
+
+	FSceneFileBlock SphereBVHNodes;
+	FSceneFileBlock SphereBVHPrimitiveIndices;
+	uint32          SphereBVHNodeCount;
+	uint32          Reserved;
+	FBVHBuildStats  SphereBVHStats;
+
+	/** The arrays of 'FSphereSoA', in the layout of 'FSphereSoA::Build'. */
+	FSceneFileBlock SphereData;
+};
+
+enum class ESceneLoadResult : uint8
+{
+	Success,
+
+	/** The file doesn't exist or couldn't be mapped. */
+	CannotOpenFile,
+
+	/** The file is not a scene file. */
+	UnsupportedFormat,
+
+	/** The file is a scene file of another version. */
+	UnsupportedVersion,
+
+	/** The file is truncated, its blocks are out of bounds or don't match the counts, or it holds an index out of range. */
+	InvalidData,
+};
+
+/** A scene loaded from a file. The world and its acceleration structures point inside the mapped file. */
+struct FLoadedScene
+{
+	FWorld             World = {};
+	FWorldAcceleration Acceleration;
+	FMappedFile        File;
+};
+
+/**
+ *---------------------------------------------------------------------------------
+ * Saves and loads whole scenes: the world's arrays together with the prebuilt
+ *   acceleration structures, so a loaded scene is ready to render without
+ *   parsing or building anything.
+ * Loading memory maps the file and points the arrays directly inside it; the
+ *   only allocations are the small mesh and hierarchy descriptor arrays. The
+ *   data is stored in the native (little-endian) layout and is never converted.
+ *---------------------------------------------------------------------------------
+ */
+class FSceneFile
+{
+public:
+	/**
+	 * Saves a world and its acceleration structures.
+	 *
+	 * @param FileName The path to the file. Overwritten if it already exists.
+	 * @param World The world.
+	 * @param Acceleration The world's acceleration structures, as built by 'FWorldAcceleration::Build'.
+	 *
+	 * @return True if the file was written.
+	 */
+	static bool Save(const char* FileName, const FWorld& World, const FWorldAcceleration& Acceleration);
+
+	/**
+	 * Loads a scene saved by 'Save'.
+	 * The header and the block ranges are validated, but the content of the blocks (such as the
+	 *   vertex indices or the BVH nodes) is trusted. The arrays are read-only, as the file is
+	 *   mapped for reading.
+	 *
+	 * @param FileName The path to the file.
+	 * @param Scene The loaded scene. Must be released with 'Release'. Left empty if the load fails.
+	 * @param Arena The arena the mesh descriptors are allocated from. If the load fails, the arena is
+	 *   rolled back to its previous state.
+	 *
+	 * @return The result of the load.
+	 */
+	static ESceneLoadResult Load(const char* FileName, out FLoadedScene& Scene, FMemoryArena& Arena);
+
+	/** Unmaps the file of a scene loaded by 'Load'. The mesh descriptors belong to their arena. */
+	static void Release(FLoadedScene& Scene);
+
+	/** @return A description of a load result, for printing. */
+	static const char* GetResultString(ESceneLoadResult Result);
+};
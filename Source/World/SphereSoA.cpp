@@ -0,0 +1,64 @@
+/**
+ *--------------------------------------------
+ * SphereSoA.cpp <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 9 2022.
+ */
+
+#include "SphereSoA.h"
+
+/** @return The size (in bytes) of every array; a whole number of cache lines, with room for reading 8 elements past the end. */
+internal uint64 GetArraySize(uint32 Count)
+{
+	uint64 Stride = ((uint64)Count + 8 + 15) & ~(uint64)15;
+	return Stride * sizeof(float);
+}
+
+uint64 FSphereSoA::GetMemorySize(uint32 InCount)
+{
+	return 6 * GetArraySize(InCount);
+}
+
+void FSphereSoA::Build(const FSphere* Spheres, const uint32* Order, uint32 InCount, FMemoryArena& Arena)
+{
+	SetFromMemory(Arena.PushZero(GetMemorySize(InCount), CACHE_LINE_SIZE), InCount);
+
+	for (uint32 Index = 0; Index < Count; ++Index)
+	{
+		uint32 Source = Order ? Order[Index] : Index;
+		const FSphere& Sphere = Spheres[Source];
+
+		X[Index] = Sphere.Position.X;
+		Y[Index] = Sphere.Position.Y;
+		Z[Index] = Sphere.Position.Z;
+		RadiusSquared[Index] = Sphere.Radius * Sphere.Radius;
+		MaterialIndex[Index] = Sphere.MaterialIndex;
+		SphereIndex[Index] = Source;
+	}
+}
+
+void FSphereSoA::SetFromMemory(const void* InMemory, uint32 InCount)
+{
+	Count = InCount;
+	uint64 ArraySize = GetArraySize(Count);
+
+	uint8* Base = (uint8*)InMemory;
+	X = (float*)(Base + 0 * ArraySize);
+	Y = (float*)(Base + 1 * ArraySize);
+	Z = (float*)(Base + 2 * ArraySize);
+	RadiusSquared = (float*)(Base + 3 * ArraySize);
+	MaterialIndex = (uint32*)(Base + 4 * ArraySize);
+	SphereIndex = (uint32*)(Base + 5 * ArraySize);
+}
+
+void FSphereSoA::Reset()
+{
+	X = nullptr;
+	Y = nullptr;
+	Z = nullptr;
+	RadiusSquared = nullptr;
+	MaterialIndex = nullptr;
+	SphereIndex = nullptr;
+	Count = 0;
+}
@@ -0,0 +1,69 @@
+/**
+ *--------------------------------------------
+ * SphereSoA.h <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 9 2022.
+ */
+
+#pragma once
+
+#include "World.h"
+
+#include "Core/Memory/MemoryArena.h"
+
+/**
+ *---------------------------------------------------------------------------------
+ * The world's spheres, stored as structure-of-arrays, so that the SIMD kernels can
+ *   load the same component of 8 spheres with a single instruction.
+ * The spheres are stored in the order given when building (the BVH leaf order), so
+ *   a leaf is a contiguous range. Every array is 64-byte aligned and padded, so
+ *   reading 8 elements starting from any valid index is always safe.
+ * The arrays are not owned; they live in the arena they were built in (or in a
+ *   memory mapped scene file).
+ *---------------------------------------------------------------------------------
+ */
+struct FSphereSoA
+{
+public:
+	float*      X = nullptr;
+	float*      Y = nullptr;
+	float*      Z = nullptr;
+	float*      RadiusSquared = nullptr;
+	uint32*     MaterialIndex = nullptr;
+
+	/** The index of the sphere in 'FWorld::Spheres'. */
+	uint32*     SphereIndex = nullptr;
+
+	uint32      Count = 0;
+
+public:
+	/**
+	 * Fills the arrays, replacing the previous content (if any).
+	 *
+	 * @param Spheres The spheres.
+	 * @param Order The index of the sphere to store at every position. If nullptr, the spheres are
+	 *   stored in their original order.
+	 * @param InCount The number of spheres.
+	 * @param Arena The arena the arrays are allocated from.
+	 */
+	void Build(const FSphere* Spheres, const uint32* Order, uint32 InCount, FMemoryArena& Arena);
+
+	/**
+	 * Points the arrays into memory that already holds them, with the layout produced by 'Build'
+	 *   (see 'GetMemorySize'), such as a memory mapped scene file.
+	 *
+	 * @param Memory The start of the arrays. Must be 64-byte aligned.
+	 * @param InCount The number of spheres.
+	 */
+	void SetFromMemory(const void* Memory, uint32 InCount);
+
+	/** Empties the arrays. Their memory is not freed; it belongs to its arena. */
+	void Reset();
+
+	/** @return The start of the arrays, which are stored back to back. */
+	SM_INLINE const void* GetMemory() const { return X; }
+
+	/** @return The size (in bytes) of the arrays of a given number of spheres, including the padding. */
+	static uint64 GetMemorySize(uint32 InCount);
+};
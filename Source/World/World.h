@@ -9,6 +9,7 @@
 #pragma once
 
 #include "Core/Math/Math.h"
+#include "World/Material.h"
 
 struct FCamera
 {
@@ -32,27 +33,51 @@ struct FPlane
 	uint32      MaterialIndex;
 };
 
-struct FMaterial
+/**
+ * An indexed triangle mesh. The vertices are shared between triangles, so a triangle costs only its
+ *   three 32-bit indices (plus 2 bytes, if it has its own material).
+ */
+struct FTriangleMesh
 {
-	uint8       AbstractMaterialData[12];
-	uint32      MaterialTypeID;
+	FVector3*   Vertices;
+	uint32      VertexCount;
+
+	/** Three indices into 'Vertices' for every triangle. */
+	uint32*     Indices;
+	uint32      TriangleCount;
+
+	/** The material of every triangle. If nullptr, all triangles use 'MaterialIndex'. */
+	uint16*     TriangleMaterialIndices;
+	uint32      MaterialIndex;
 };
 
-struct FMaterialDefault
+/** The light that comes from outside the world: a uniform sky, and a sun infinitely far away. */
+struct FEnvironment
 {
-	FVector3    Color;
+	/** The radiance of the sky, the same in every direction. */
+	FVector3    SkyRadiance;
+
+	/** The direction towards the sun. Normalized. */
+	FVector3    SunDirection;
+
+	/** The irradiance of the sun on a surface facing it. */
+	FVector3    SunIrradiance;
 };
 
 struct FWorld
 {
-	FCamera     Camera;
+	FCamera        Camera;
+	FEnvironment   Environment;
+
+	FSphere*       Spheres;
+	uint32         SphereCount;
 
-	FSphere*    Spheres;
-	uint32      SphereCount;
+	FPlane*        Planes;
+	uint32         PlaneCount;
 
-	FPlane*     Planes;
-	uint32      PlaneCount;
+	FTriangleMesh* Meshes;
+	uint32         MeshCount;
 
-	FMaterial*  Materials;
-	uint32      MaterialCount;
+	FMaterial*     Materials;
+	uint32         MaterialCount;
 };
\ No newline at end of file
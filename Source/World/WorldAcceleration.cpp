@@ -0,0 +1,81 @@
+/**
+ *--------------------------------------------
+ * WorldAcceleration.cpp <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 13 2022.
+ */
+
+#include "WorldAcceleration.h"
+
+#include "Core/Jobs/JobSystem.h"
+
+void FWorldAcceleration::Build(const FWorld& World, const FBVHBuildSettings& Settings)
+{
+	Reset(World.MeshCount);
+
+	// The bounds of the primitives are as large as the world, so (like the BVH builds) they come from an arena
+	//   that is released after the build, rather than from the thread's scratch arena.
+	FMemoryArena BoundsArena;
+	BoundsArena.Initialize("PrimitiveBounds");
+
+	FTemporaryMemory SphereBoundsMemory = BoundsArena.BeginTemporaryMemory();
+	FBox* SphereBounds = BoundsArena.PushArray<FBox>(World.SphereCount);
+	for (uint32 SphereIndex = 0; SphereIndex < World.SphereCount; ++SphereIndex)
+	{
+		const FSphere& Sphere = World.Spheres[SphereIndex];
+		SphereBounds[SphereIndex] = FBox(Sphere.Position - FVector3(Sphere.Radius), Sphere.Position + FVector3(Sphere.Radius));
+	}
+
+	// The leaves are intersected 8 spheres at a time.
+	FBVHBuildSettings SphereBVHSettings = Settings;
+	SphereBVHSettings.PrimitiveBatchSize = 8;
+	SphereBVHSettings.MaxLeafSize = FMath::Max(SphereBVHSettings.MaxLeafSize, 8U);
+
+	SphereBVHStats = SphereBVH.Build(SphereBounds, World.SphereCount, Arena, SphereBVHSettings);
+	SphereData.Build(World.Spheres, SphereBVH.PrimitiveIndices, World.SphereCount, Arena);
+	BoundsArena.EndTemporaryMemory(SphereBoundsMemory);
+
+	for (uint32 MeshIndex = 0; MeshIndex < MeshCount; ++MeshIndex)
+	{
+		const FTriangleMesh* Mesh = World.Meshes + MeshIndex;
+		FScopedTemporaryMemory MeshBoundsMemory(BoundsArena);
+
+		FBox* TriangleBounds = BoundsArena.PushArray<FBox>(Mesh->TriangleCount);
+		FJobSystem::ParallelFor(Mesh->TriangleCount, 4096, [Mesh, TriangleBounds](uint32 Begin, uint32 End)
+		{
+			for (uint32 TriangleIndex = Begin; TriangleIndex < End; ++TriangleIndex)
+			{
+				const uint32* Indices = Mesh->Indices + 3 * (uint64)TriangleIndex;
+				FBox Bounds = FBox::Empty();
+				Bounds.Grow(Mesh->Vertices[Indices[0]]);
+				Bounds.Grow(Mesh->Vertices[Indices[1]]);
+				Bounds.Grow(Mesh->Vertices[Indices[2]]);
+				TriangleBounds[TriangleIndex] = Bounds;
+			}
+		});
+
+		MeshBVHs[MeshIndex].Build(TriangleBounds, Mesh->TriangleCount, Arena, Settings);
+	}
+
+	BoundsArena.Release();
+}
+
+void FWorldAcceleration::Release()
+{
+	Reset(0);
+	Arena.Release();
+}
+
+void FWorldAcceleration::Reset(uint32 InMeshCount)
+{
+	Arena.Reset();
+
+	SphereBVH.Reset();
+	SphereBVHStats = {};
+	SphereData.Reset();
+
+	// An empty hierarchy is all zeros.
+	MeshCount = InMeshCount;
+	MeshBVHs = (MeshCount > 0) ? Arena.PushArrayZero<FBVH>(MeshCount) : nullptr;
+}
@@ -0,0 +1,56 @@
+/**
+ *--------------------------------------------
+ * WorldAcceleration.h <-> Spearmint
+ *--------------------------------------------
+ * Copyright (c) to Avram Traian. 2022 - 2022.
+ * File created on November 13 2022.
+ */
+
+#pragma once
+
+#include "World/BVH.h"
+#include "World/SphereSoA.h"
+#include "World/World.h"
+
+/**
+ *---------------------------------------------------------------------------------
+ * The acceleration structures the renderer traces a world with. They are either
+ *   built from the world, or prebuilt and stored next to it (in a scene file).
+ * Everything built is allocated from the structure's own arena, whose blocks are
+ *   reused when the structures are rebuilt.
+ *---------------------------------------------------------------------------------
+ */
+struct FWorldAcceleration
+{
+public:
+	/** Hierarchy over the world's spheres. Planes are unbounded, so they are not part of any hierarchy. */
+	FBVH           SphereBVH;
+	FBVHBuildStats SphereBVHStats = {};
+
+	/** The world's spheres, in the BVH leaf order. */
+	FSphereSoA     SphereData;
+
+	/** One hierarchy for every mesh of the world, in the same order. */
+	FBVH*          MeshBVHs = nullptr;
+	uint32         MeshCount = 0;
+
+public:
+	/**
+	 * Builds the acceleration structures of a world, replacing the previous ones (if any).
+	 *
+	 * @param World The world.
+	 * @param Settings The BVH build settings. The sphere BVH overrides the batch size to match its SIMD kernel.
+	 */
+	void Build(const FWorld& World, const FBVHBuildSettings& Settings);
+
+	/** Frees the memory of the acceleration structures and empties them. */
+	void Release();
+
+	/** Empties the acceleration structures and allocates an empty hierarchy for every mesh, to be built or pointed at prebuilt data. */
+	void Reset(uint32 InMeshCount);
+
+	SM_INLINE const FMemoryArena& GetArena() const { return Arena; }
+
+private:
+	FMemoryArena   Arena;
+};